@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include "FormulaDependencyGraph.h"
+#include "FormulaVariable.h"
+#include "../Types/DataSet.h"
+
+void Common::FormulaDependencyGraph::addFormula(const std::string &name,
+                                                const std::shared_ptr<const Common::FormulaVariableAlgebraic> &formula)
+{
+    if (!formula)
+        throw std::runtime_error("E: FormulaDependencyGraph::addFormula : null formula given for " + name + ".");
+
+    _addFormula(name, {formula, nullptr, formula -> getInputVariables(), true});
+}
+
+void Common::FormulaDependencyGraph::addFormula(const std::string &name,
+                                                const std::shared_ptr<Common::FormulaVariablePostProc> &formula)
+{
+    if (!formula)
+        throw std::runtime_error("E: FormulaDependencyGraph::addFormula : null formula given for " + name + ".");
+
+    _addFormula(name, {nullptr, formula, formula -> getInputVariables(), true});
+}
+
+void Common::FormulaDependencyGraph::removeFormula(const std::string &name)
+{
+    const auto it = m_formulas.find(name);
+    if (it == m_formulas.end())
+        return;
+
+    // Dependents now read name as a raw column, they are recomputed against whatever the data set holds
+    markDirty(name);
+    _unlinkInputs(name, it -> second.inputs);
+    m_formulas.erase(it);
+    m_isOrdered = false;
+}
+
+bool Common::FormulaDependencyGraph::hasFormula(const std::string &name) const
+{
+    return m_formulas.find(name) != m_formulas.end();
+}
+
+std::size_t Common::FormulaDependencyGraph::getFormulaCount() const
+{
+    return m_formulas.size();
+}
+
+const std::vector<std::string>& Common::FormulaDependencyGraph::getInputs(const std::string &name) const
+{
+    return _getFormula(name).inputs;
+}
+
+std::vector<std::string> Common::FormulaDependencyGraph::getDependents(const std::string &variable) const
+{
+    std::unordered_set<std::string> downstream;
+    std::vector<std::string> pending(1, variable);
+    while (!pending.empty())
+    {
+        const std::string current = pending.back();
+        pending.pop_back();
+
+        const auto it = m_dependents.find(current);
+        if (it == m_dependents.end())
+            continue;
+        for (const auto& dependent: it -> second)
+            if (downstream.insert(dependent).second)
+                pending.push_back(dependent);
+    }
+
+    std::vector<std::string> rv;
+    for (const auto& it: getEvaluationOrder())
+        if (downstream.count(it))
+            rv.push_back(it);
+    return rv;
+}
+
+const std::vector<std::string>& Common::FormulaDependencyGraph::getEvaluationOrder() const
+{
+    if (!m_isOrdered)
+        _sort();
+
+    return m_order;
+}
+
+void Common::FormulaDependencyGraph::markDirty(const std::string &variable)
+{
+    // A dirty formula always has dirty dependents, so the walk stops at formulas already flagged
+    const auto root = m_formulas.find(variable);
+    if (root != m_formulas.end())
+        root -> second.isDirty = true;
+
+    std::vector<std::string> pending(1, variable);
+    while (!pending.empty())
+    {
+        const auto it = m_dependents.find(pending.back());
+        pending.pop_back();
+        if (it == m_dependents.end())
+            continue;
+
+        for (const auto& dependent: it -> second)
+        {
+            Formula& formula = m_formulas.at(dependent);
+            if (!formula.isDirty)
+            {
+                formula.isDirty = true;
+                pending.push_back(dependent);
+            }
+        }
+    }
+}
+
+void Common::FormulaDependencyGraph::markAllDirty()
+{
+    for (auto& it: m_formulas)
+        it.second.isDirty = true;
+}
+
+bool Common::FormulaDependencyGraph::isDirty(const std::string &name) const
+{
+    return _getFormula(name).isDirty;
+}
+
+std::vector<std::string> Common::FormulaDependencyGraph::evaluate(Common::DataSet &ds)
+{
+    std::vector<std::string> recomputed;
+    for (const auto& name: getEvaluationOrder())
+    {
+        Formula& formula = m_formulas.at(name);
+        if (!formula.isDirty)
+            continue;
+
+        const Common::TimeSeries result = _compute(name, formula, ds);
+        ds.removeData(name);
+        ds.addData(result);
+        formula.isDirty = false;
+        recomputed.push_back(name);
+    }
+
+    return recomputed;
+}
+
+void Common::FormulaDependencyGraph::_addFormula(const std::string &name, Common::FormulaDependencyGraph::Formula formula)
+{
+    std::vector<std::string> inputs;
+    for (const auto& it: formula.inputs)
+        if (std::find(inputs.begin(), inputs.end(), it) == inputs.end())
+            inputs.push_back(it);
+    formula.inputs = std::move(inputs);
+
+    const auto it = m_formulas.find(name);
+    if (it != m_formulas.end())
+    {
+        _unlinkInputs(name, it -> second.inputs);
+        it -> second = std::move(formula);
+    }
+    else
+        m_formulas.emplace(name, std::move(formula));
+
+    for (const auto& input: m_formulas.at(name).inputs)
+        m_dependents[input].push_back(name);
+
+    m_isOrdered = false;
+    markDirty(name);
+}
+
+void Common::FormulaDependencyGraph::_unlinkInputs(const std::string &name, const std::vector<std::string> &inputs)
+{
+    for (const auto& input: inputs)
+    {
+        std::vector<std::string>& dependents = m_dependents.at(input);
+        dependents.erase(std::remove(dependents.begin(), dependents.end(), name), dependents.end());
+        if (dependents.empty())
+            m_dependents.erase(input);
+    }
+}
+
+void Common::FormulaDependencyGraph::_sort() const
+{
+    // Kahn's algorithm, ready formulas are taken in name order so that the evaluation order is reproducible
+    std::unordered_map<std::string, std::size_t> pendingInputs;
+    std::vector<std::string> ready;
+    for (const auto& it: m_formulas)
+    {
+        const std::size_t count = static_cast<std::size_t>(std::count_if(it.second.inputs.begin(), it.second.inputs.end(),
+                                                                          [this](const std::string& input)
+                                                                          { return m_formulas.count(input) > 0; }));
+        pendingInputs.emplace(it.first, count);
+        if (count == 0)
+            ready.push_back(it.first);
+    }
+
+    const auto byNameDescending = [](const std::string& a, const std::string& b) { return a > b; };
+    std::sort(ready.begin(), ready.end(), byNameDescending);
+
+    std::vector<std::string> order;
+    order.reserve(m_formulas.size());
+    while (!ready.empty())
+    {
+        order.push_back(ready.back());
+        ready.pop_back();
+
+        const auto it = m_dependents.find(order.back());
+        if (it == m_dependents.end())
+            continue;
+
+        const std::size_t readyCount = ready.size();
+        for (const auto& dependent: it -> second)
+            if (--pendingInputs.at(dependent) == 0)
+                ready.push_back(dependent);
+        if (ready.size() != readyCount)
+            std::sort(ready.begin(), ready.end(), byNameDescending);
+    }
+
+    if (order.size() != m_formulas.size())
+    {
+        std::vector<std::string> cyclic;
+        for (const auto& it: pendingInputs)
+            if (it.second > 0)
+                cyclic.push_back(it.first);
+        std::sort(cyclic.begin(), cyclic.end());
+
+        std::string names;
+        for (const auto& it: cyclic)
+            names += (names.empty() ? "" : ", ") + it;
+        throw std::runtime_error("E: FormulaDependencyGraph::getEvaluationOrder : circular dependency involving formulas " +
+                                 names + ".");
+    }
+
+    m_order = std::move(order);
+    m_isOrdered = true;
+}
+
+Common::TimeSeries Common::FormulaDependencyGraph::_compute(const std::string &name, Common::FormulaDependencyGraph::Formula &formula,
+                                                            const Common::DataSet &ds) const
+{
+    if (formula.algebraic)
+        return formula.algebraic -> evaluateSeries(ds, name);
+
+    formula.postProc -> reset();
+    return Common::TimeSeries(name, formula.postProc -> compute(ds));
+}
+
+const Common::FormulaDependencyGraph::Formula& Common::FormulaDependencyGraph::_getFormula(const std::string &name) const
+{
+    const auto it = m_formulas.find(name);
+    if (it == m_formulas.end())
+        throw std::out_of_range("E: FormulaDependencyGraph : formula " + name + " not found.");
+
+    return it -> second;
+}
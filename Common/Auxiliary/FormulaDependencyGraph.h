@@ -0,0 +1,66 @@
+#ifndef WILDCATSTKCORE_FORMULADEPENDENCYGRAPH_H
+#define WILDCATSTKCORE_FORMULADEPENDENCYGRAPH_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace Common
+{
+    class DataSet;
+    class TimeSeries;
+    class FormulaVariableAlgebraic;
+    class FormulaVariablePostProc;
+
+    //
+    // Catalogue of named formulas linked by the variables they read. Inputs come from getInputVariables() of the
+    // algebraic and post-processing formulas; inputs that are not formulas themselves are raw data set columns.
+    // Formulas are evaluated in topological order, a cycle between formulas throws when the order is built.
+    //
+    // Every formula starts dirty. markDirty flags a changed column and everything downstream of it, and evaluate only
+    // recomputes dirty formulas, writing each result into the data set under the formula name before its dependents
+    // read it. Editing one driver path of a scenario therefore only recomputes the formulas that depend on it.
+    //
+    class FormulaDependencyGraph
+    {
+    public:
+        void addFormula(const std::string& name, const std::shared_ptr<const Common::FormulaVariableAlgebraic>& formula);
+        void addFormula(const std::string& name, const std::shared_ptr<Common::FormulaVariablePostProc>& formula);
+        void removeFormula(const std::string& name);
+
+        bool hasFormula(const std::string& name) const;
+        std::size_t getFormulaCount() const;
+        const std::vector<std::string>& getInputs(const std::string& name) const;
+        std::vector<std::string> getDependents(const std::string& variable) const;
+        const std::vector<std::string>& getEvaluationOrder() const;
+
+        void markDirty(const std::string& variable);
+        void markAllDirty();
+        bool isDirty(const std::string& name) const;
+
+        std::vector<std::string> evaluate(Common::DataSet& ds);
+
+    private:
+        struct Formula
+        {
+            std::shared_ptr<const Common::FormulaVariableAlgebraic> algebraic;
+            std::shared_ptr<Common::FormulaVariablePostProc> postProc;
+            std::vector<std::string> inputs;
+            bool isDirty;
+        };
+
+        std::unordered_map<std::string, Formula> m_formulas;
+        std::unordered_map<std::string, std::vector<std::string>> m_dependents;     // variable -> formulas reading it
+        mutable std::vector<std::string> m_order;
+        mutable bool m_isOrdered = false;
+
+        void _addFormula(const std::string& name, Formula formula);
+        void _unlinkInputs(const std::string& name, const std::vector<std::string>& inputs);
+        void _sort() const;
+        Common::TimeSeries _compute(const std::string& name, Formula& formula, const Common::DataSet& ds) const;
+        const Formula& _getFormula(const std::string& name) const;
+    };
+}
+
+#endif //WILDCATSTKCORE_FORMULADEPENDENCYGRAPH_H
@@ -2,36 +2,263 @@
 // Created by Alberto Campi on 2019-08-25.
 //
 
+#include <algorithm>
+#include <unordered_set>
 #include "FormulaVariable.h"
+#include "../Types/AlignedColumns.h"
+#include "../Types/Calendar.h"
 #include "../Types/DataSet.h"
 #include "../Seasonality/SeasonalDecompose.h"
 #include "../../Global/Mappings/FactoryMappings.h"
 
-Common::FormulaVariableAlgebraic::FormulaVariableAlgebraic(const std::string &expression, const Common::OperatorsGrammar &grammar) :
-    m_parser(expression, grammar)
+Common::FormulaVariableAlgebraic::FormulaVariableAlgebraic(const std::string &expression, const Common::OperatorsGrammar &grammar,
+                                                           Common::FormulaEvaluationMode mode) :
+    m_parser(expression, grammar), m_mode(mode)
 {
-
+    _bindVariables();
 }
 
 double Common::FormulaVariableAlgebraic::evaluate(const Common::DataSet &ds, const boost::gregorian::date &date) const
 {
-    const std::vector<std::string> variableNames = m_parser.getExpressionVariables();
-    std::unordered_map<std::string, double> kvp;
-    for (const auto& variable: variableNames)
-        kvp.emplace(variable, ds.getValue(variable, date));
+    _checkCompiled();
+
+    // lag, diff and ma read earlier rows. A single date is computed over a window of rows ending on it, doubled until
+    // no row the value depends on is left out of the window.
+    if (m_program.hasHistory)
+    {
+        const Program* program = &m_program;
+        auto slot = std::find(program -> slotTerms.begin(), program -> slotTerms.end(), nullptr);
+        while (slot == program -> slotTerms.end() and !program -> slotTerms.empty())
+        {
+            program = &program -> slotTerms.front() -> argument;
+            slot = std::find(program -> slotTerms.begin(), program -> slotTerms.end(), nullptr);
+        }
+        if (slot == program -> slotTerms.end())
+            throw std::runtime_error("E: FormulaVariableAlgebraic::evaluate : formula has no input variable to take dates from.");
+
+        const Common::DatesView dates = ds.getTimeSeriesRef(program -> slotIds[slot - program -> slotTerms.begin()]).getDatesView();
+        const std::size_t last = std::upper_bound(dates.begin(), dates.end(), date) - dates.begin();
+        for (std::size_t rows = m_program.lookback + 1; ; rows *= 2)
+        {
+            const boost::gregorian::date from = rows < last ? dates[last - rows] : boost::gregorian::date(boost::date_time::neg_infin);
+            boost::gregorian::date exactFrom;
+            bool isTruncated;
+            const Common::TimeSeries window = _evaluate(m_program, ds, from, date, exactFrom, isTruncated);
+            if (!isTruncated or exactFrom <= date)
+                return window.getValue(date);
+        }
+    }
+
+    if (m_mode == Common::FormulaEvaluationMode::Bytecode)
+    {
+        thread_local std::vector<double> slots;
+        slots.resize(m_program.slotIds.size());
+        for (std::size_t i = 0; i < m_program.slotIds.size(); ++i)
+            slots[i] = ds.getValue(m_program.slotIds[i], date);
+
+        return m_program.code.evaluate(slots.data());
+    }
+
+    thread_local std::vector<double> values;
+    values.resize(m_treeSlotIds.size());
+    for (std::size_t i = 0; i < m_treeSlotIds.size(); ++i)
+        values[i] = ds.getValue(m_treeSlotIds[i], date);
 
-    return m_parser.evaluate(Common::AlgebraicExpressionContext(kvp));
+    return m_tree -> evaluate(values.data());
+}
+
+Common::TimeSeries Common::FormulaVariableAlgebraic::evaluateSeries(const Common::DataSet &ds, const std::string &seriesName) const
+{
+    // Whole series always go through the bytecode, which runs over columns with the vector kernels
+    _checkCompiled();
+
+    boost::gregorian::date exactFrom;
+    bool isTruncated;
+    return Common::TimeSeries(seriesName, _evaluate(m_program, ds, boost::gregorian::date(boost::date_time::neg_infin),
+                                                    boost::gregorian::date(boost::date_time::pos_infin), exactFrom, isTruncated));
+}
+
+std::vector<std::string> Common::FormulaVariableAlgebraic::getInputVariables() const
+{
+    std::vector<std::string> rv;
+    for (const auto& it: m_variableIds)
+        rv.push_back(it.first);
+    return rv;
 }
 
 void Common::FormulaVariableAlgebraic::set(const std::string &expression, const Common::OperatorsGrammar &grammar)
 {
     m_parser.setOperatorGrammar(grammar), m_parser.setExpression(expression);
+    _bindVariables();
+}
+
+void Common::FormulaVariableAlgebraic::setEvaluationMode(Common::FormulaEvaluationMode mode)
+{
+    m_mode = mode;
+}
+
+Common::FormulaEvaluationMode Common::FormulaVariableAlgebraic::getEvaluationMode() const
+{
+    return m_mode;
+}
+
+void Common::FormulaVariableAlgebraic::_bindVariables()
+{
+    // Expression variables are interned once, evaluation then only reads values by id into slots
+    m_variableIds.clear();
+    std::unordered_set<std::string> seen;
+    for (const auto& variable: m_parser.getExpressionVariables())
+    {
+        if (seen.insert(variable).second)
+            m_variableIds.emplace_back(variable, Global::VariableSymbols::instance() -> intern(variable));
+    }
+
+    // An invalid formula still constructs and throws its parsing error when it is evaluated, as before
+    m_tree.reset(), m_treeSlotIds.clear(), m_program = Program(), m_compileError.clear();
+    try
+    {
+        m_tree = m_parser.getCompiled();
+        for (const auto& variable: m_tree -> getVariables())
+            m_treeSlotIds.push_back(Global::VariableSymbols::instance() -> intern(variable));
+        m_program = _compile(*m_tree, m_tree -> getRoot());
+    }
+    catch (const std::runtime_error& e)
+    {
+        m_tree.reset();
+        m_compileError = e.what();
+    }
+}
+
+void Common::FormulaVariableAlgebraic::_checkCompiled() const
+{
+    if (!m_tree)
+        throw std::runtime_error(m_compileError);
+}
+
+Common::FormulaVariableAlgebraic::Program Common::FormulaVariableAlgebraic::_compile(const Common::AlgebraicExpressionArena &tree,
+                                                                                     Common::AlgebraicExpressionArena::NodeIndex root)
+{
+    Program program;
+    std::vector<std::shared_ptr<const HistoryTerm>> terms;
+    _emit(tree, root, program, terms);
+
+    // Term slots are named '#' and the index of the term, which no variable name can start with
+    for (const auto& variable: program.code.getVariables())
+    {
+        if (variable[0] == '#')
+        {
+            const std::shared_ptr<const HistoryTerm>& term = terms[std::stoul(variable.substr(1))];
+            program.slotIds.push_back(Global::VariableSymbols::invalidId);
+            program.slotTerms.push_back(term);
+            program.lookback = std::max(program.lookback, term -> lookback + term -> argument.lookback);
+        }
+        else
+        {
+            program.slotIds.push_back(Global::VariableSymbols::instance() -> intern(variable));
+            program.slotTerms.emplace_back();
+        }
+    }
+    program.hasHistory = !terms.empty();
+
+    return program;
+}
+
+void Common::FormulaVariableAlgebraic::_emit(const Common::AlgebraicExpressionArena &tree, Common::AlgebraicExpressionArena::NodeIndex node,
+                                             Program &program, std::vector<std::shared_ptr<const HistoryTerm>> &terms)
+{
+    const Common::AlgebraicExpressionArena::Node& n = tree.getNode(node);
+    switch (n.opCode)
+    {
+        case Common::AlgebraicOpCode::PushConstant:
+            program.code.pushConstant(tree.getConstant(n));
+            break;
+        case Common::AlgebraicOpCode::PushVariable:
+            program.code.pushVariable(tree.getVariable(n));
+            break;
+        case Common::AlgebraicOpCode::Lag:
+        case Common::AlgebraicOpCode::Diff:
+        case Common::AlgebraicOpCode::MovingAverage:
+        {
+            const auto term = std::make_shared<HistoryTerm>();
+            term -> argument = _compile(tree, n.lhs);
+            term -> operation.pushVariable("#");
+            term -> operation.emit(n.opCode, n.rhs);
+            term -> lookback = n.opCode == Common::AlgebraicOpCode::Lag ? n.rhs : n.opCode == Common::AlgebraicOpCode::Diff ? 1 : n.rhs - 1;
+
+            program.code.pushVariable("#" + std::to_string(terms.size()));
+            terms.push_back(term);
+            break;
+        }
+        default:
+            _emit(tree, n.lhs, program, terms);
+            if (!Common::AlgebraicBytecode::isUnary(n.opCode))
+                _emit(tree, n.rhs, program, terms);
+            program.code.emit(n.opCode);
+    }
+}
+
+Common::TimeSeries Common::FormulaVariableAlgebraic::_evaluate(const Program &program, const Common::DataSet &ds,
+                                                               const boost::gregorian::date &from, const boost::gregorian::date &to,
+                                                               boost::gregorian::date &exactFrom, bool &isTruncated)
+{
+    // Inputs are read on the dates from..to. When rows before from are left out, values are exact from exactFrom on.
+    if (program.slotIds.empty())
+        throw std::runtime_error("E: FormulaVariableAlgebraic::evaluateSeries : formula has no input variable to take dates from.");
+
+    exactFrom = boost::gregorian::date(boost::date_time::neg_infin), isTruncated = false;
+    std::vector<Common::TimeSeries> owned;
+    owned.reserve(program.slotIds.size());
+    std::vector<const Common::TimeSeries*> inputs;
+    for (std::size_t i = 0; i < program.slotIds.size(); ++i)
+    {
+        if (const std::shared_ptr<const HistoryTerm>& term = program.slotTerms[i])
+        {
+            boost::gregorian::date argumentExactFrom;
+            bool isArgumentTruncated;
+            const Common::TimeSeries argument = _evaluate(term -> argument, ds, from, to, argumentExactFrom, isArgumentTruncated);
+            std::vector<double> values(argument.length());
+            const double* column = argument.getValuesView().begin();
+            term -> operation.evaluateColumns(&column, values.size(), values.data());
+
+            if (isArgumentTruncated)
+            {
+                const Common::DatesView dates = argument.getDatesView();
+                const std::size_t row = std::lower_bound(dates.begin(), dates.end(), argumentExactFrom) - dates.begin() + term -> lookback;
+                exactFrom = std::max(exactFrom, row < dates.size() ? dates[row] : boost::gregorian::date(boost::date_time::pos_infin));
+                isTruncated = true;
+            }
+            owned.emplace_back("", std::move(values), argument.getCalendar());
+            inputs.push_back(&owned.back());
+            continue;
+        }
+
+        const Common::TimeSeries& ts = ds.getTimeSeriesRef(program.slotIds[i]);
+        const Common::DatesView dates = ts.getDatesView();
+        const auto first = std::lower_bound(dates.begin(), dates.end(), from), last = std::upper_bound(first, dates.end(), to);
+        if (first == dates.begin() and last == dates.end())
+            inputs.push_back(&ts);
+        else
+        {
+            const Common::ValuesView values = ts.getValuesView();
+            owned.emplace_back(ts.getName(), std::vector<double>(values.begin() + (first - dates.begin()), values.begin() + (last - dates.begin())),
+                               std::vector<boost::gregorian::date>(first, last));
+            inputs.push_back(&owned.back());
+            isTruncated = isTruncated or first != dates.begin();
+        }
+    }
+
+    const Common::AlignedColumns aligned(inputs);
+    std::vector<double> values(aligned.getRowCount());
+    program.code.evaluateColumns(aligned.getColumns(), values.size(), values.data());
+
+    return Common::TimeSeries("", std::move(values), aligned.getCalendar());
 }
 
 Common::FormulaVariableFunctionalDeSeason::FormulaVariableFunctionalDeSeason(const std::string &variableName,
                                                                              const std::string &decompositionType,
                                                                              unsigned int period) :
     m_variable(variableName),
+    m_variableId(Global::VariableSymbols::instance() -> intern(variableName)),
     m_decompPtr(Global::SeasonalDecomposeFactoryMapping::instance() -> getFactory(decompositionType) -> create(period)),
     m_isDecomposed(false)
 {
@@ -42,7 +269,7 @@ void Common::FormulaVariableFunctionalDeSeason::_decompose(const Common::DataSet
 {
     if (!m_isDecomposed)
     {
-        m_decompPtr -> decompose(ds.getTimeSeries(m_variable));
+        m_decompPtr -> decompose(ds.getTimeSeriesRef(m_variableId));
         m_isDecomposed = true;
     }
 }
@@ -59,10 +286,21 @@ Common::TimeSeries Common::FormulaVariableFunctionalDeSeason::getSeason(const Co
     return m_decompPtr -> getSeason();
 }
 
+std::vector<std::string> Common::FormulaVariableFunctionalDeSeason::getInputVariables() const
+{
+    return {m_variable};
+}
+
+void Common::FormulaVariableFunctionalDeSeason::reset()
+{
+    m_isDecomposed = false;
+}
+
 void Common::FormulaVariableFunctionalDeSeason::set(const std::string &variableName, const std::string &decompositionType,
                                                     unsigned int period)
 {
     m_variable = variableName;
+    m_variableId = Global::VariableSymbols::instance() -> intern(variableName);
     m_decompPtr = Global::SeasonalDecomposeFactoryMapping::instance() -> getFactory(decompositionType) -> create(period);
     m_isDecomposed = false;
 }
@@ -74,8 +312,9 @@ Common::FormulaVariableFunctionalRestoreSeason::FormulaVariableFunctionalRestore
                                                                                        const Common::TimeSeries &seasonality) :
     m_seasonalVariable(seasonalVariableName),
     m_deSeasonedVariable(deSeasonedVariableName),
+    m_seasonalVariableId(Global::VariableSymbols::instance() -> intern(seasonalVariableName)),
     m_restorePtr(Global::RestoreSeasonFactoryMapping::instance() -> getFactory(decompositionType) -> create()),
-    m_restoreStartDate(seasonality.getDates().back()),
+    m_restoreStartDate(seasonality.getDatesView().back()),
     m_lastSeasonalCycle(_getLastSeasonalCycle(seasonality, period))
 {
 
@@ -88,41 +327,45 @@ void Common::FormulaVariableFunctionalRestoreSeason::set(const std::string &seas
                                                          const Common::TimeSeries &seasonality)
 {
     m_seasonalVariable = seasonalVariableName;
+    m_seasonalVariableId = Global::VariableSymbols::instance() -> intern(seasonalVariableName);
     m_deSeasonedVariable = deSeasonedVariableName;
     m_restorePtr = Global::RestoreSeasonFactoryMapping::instance() -> getFactory(decompositionType) -> create();
-    m_restoreStartDate = seasonality.getDates().back();
+    m_restoreStartDate = seasonality.getDatesView().back();
     m_lastSeasonalCycle = _getLastSeasonalCycle(seasonality, period);
 }
 
+std::vector<std::string> Common::FormulaVariableFunctionalRestoreSeason::getInputVariables() const
+{
+    return {m_seasonalVariable};
+}
+
 std::vector<double> Common::FormulaVariableFunctionalRestoreSeason::_getLastSeasonalCycle(const Common::TimeSeries &seasonality,
                                                                                           unsigned int period)
 {
     //m_restoreStartDate = seasonality.getDates().back();
-    std::vector<double>::const_iterator begin = seasonality.getValues().end() - period;
-    std::vector<double>::const_iterator end = seasonality.getValues().end();
-    return std::vector<double>(begin, end);
+    const Common::ValuesView values = seasonality.getValuesView();
+    return std::vector<double>(values.end() - period, values.end());
 }
 
 Common::TimeSeries Common::FormulaVariableFunctionalRestoreSeason::compute(const Common::DataSet &ds) const
 {
-    const unsigned long index = ds.getTimeSeries(m_seasonalVariable).getIndex(m_restoreStartDate);
+    const Common::TimeSeries& seasonalTs = ds.getTimeSeriesRef(m_seasonalVariableId);
+    const unsigned long index = seasonalTs.getIndex(m_restoreStartDate);
     std::vector<double> restoredValues;
-    std::vector<boost::gregorian::date> restoredDates;
 
-    for (unsigned long i = index; i < ds.getTimeSeries(m_seasonalVariable).length(); ++i)
+    // The last seasonal cycle ends on the restore start date, so that date takes the last entry of the cycle
+    const unsigned long period = m_lastSeasonalCycle.size();
+    const Common::ValuesView values = seasonalTs.getValuesView();
+    const Common::DatesView dates = seasonalTs.getDatesView();
+    restoredValues.reserve(values.size() - index);
+    for (unsigned long i = index; i < values.size(); ++i)
     {
-        const double trendValue = ds.getValue(m_seasonalVariable, i);
-        double seasonalValue;
-        if (index < m_lastSeasonalCycle.size())
-            seasonalValue = m_lastSeasonalCycle.at(index);
-        else
-            seasonalValue = m_lastSeasonalCycle.at(index % m_lastSeasonalCycle.size());
-
-        ds.getTimeSeries(m_seasonalVariable).pushBack(ds.getTimeSeries(m_seasonalVariable).getDates().at(i),
-                                                      m_restorePtr -> restore(trendValue, seasonalValue));
+        const double seasonalValue = m_lastSeasonalCycle[(i - index + period - 1) % period];
+        restoredValues.push_back(m_restorePtr -> restore(values[i], seasonalValue));
     }
 
-    return ds.getTimeSeries(m_seasonalVariable);
+    return Common::TimeSeries(m_seasonalVariable, restoredValues,
+                              std::vector<boost::gregorian::date>(dates.begin() + index, dates.end()));
 }
 /*
 double Common::FormulaVariableFunctionalRestoreSeason::evaluate(const Common::DataSet &ds, const boost::gregorian::date &date) const
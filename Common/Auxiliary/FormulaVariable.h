@@ -7,6 +7,8 @@
 
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include "../Utils/General/Tools.h"
+#include "../Utils/General/AlgebraicExpressionInterpreter.h"
+#include "../../Global/Symbols/VariableSymbols.h"
 
 namespace Common
 {
@@ -23,16 +25,66 @@ namespace Common
         virtual ~FormulaVariable() = default;
     };
 
+    // Algebraic formulas are either walked as an expression tree over a named context, or compiled to bytecode whose
+    // variable slots are bound to data set ids and evaluated over a flat array of values. Formulas default to bytecode,
+    // pass ExpressionTree to evaluate them by walking the tree as before.
+    enum class FormulaEvaluationMode
+    {
+        ExpressionTree,
+        Bytecode
+    };
+
     class FormulaVariableAlgebraic : public FormulaVariable
     {
     public:
-        FormulaVariableAlgebraic(const std::string& expression, const Common::OperatorsGrammar& grammar);
+        FormulaVariableAlgebraic(const std::string& expression, const Common::OperatorsGrammar& grammar,
+                                 Common::FormulaEvaluationMode mode = Common::FormulaEvaluationMode::Bytecode);
         double evaluate(const Common::DataSet& ds, const boost::gregorian::date& date) const final;
+        Common::TimeSeries evaluateSeries(const Common::DataSet& ds, const std::string& seriesName) const;
+        std::vector<std::string> getInputVariables() const;
 
         void set(const std::string& expression, const Common::OperatorsGrammar& grammar);
+        void setEvaluationMode(Common::FormulaEvaluationMode mode);
+        Common::FormulaEvaluationMode getEvaluationMode() const;
 
     private:
-        mutable Common::AlgebraicExpressionParser m_parser;
+        // Everything is compiled when the expression is set and only read afterwards, so that a formula shared between
+        // threads is evaluated without locking. Values for one evaluation are gathered in scratch owned by the call.
+        Common::AlgebraicExpressionParser m_parser;
+        Common::FormulaEvaluationMode m_mode;
+        std::vector<std::pair<std::string, Global::VariableId>> m_variableIds;
+
+        // lag, diff and ma count the rows of their own argument. Each is compiled to a term whose argument program is
+        // evaluated on the dates its inputs share, and whose result then enters the enclosing program as one more slot,
+        // aligned with the other inputs there.
+        struct HistoryTerm;
+        struct Program
+        {
+            Common::AlgebraicBytecode code;
+            std::vector<Global::VariableId> slotIds;                    // data set ids of the input variable slots
+            std::vector<std::shared_ptr<const HistoryTerm>> slotTerms;  // term read by each slot, null for input variables
+            std::size_t lookback = 0;                                   // earlier rows read, over all nested terms
+            bool hasHistory = false;
+        };
+        struct HistoryTerm
+        {
+            Program argument;
+            Common::AlgebraicBytecode operation;                        // the history operation alone over one slot
+            std::size_t lookback;
+        };
+
+        std::shared_ptr<const Common::AlgebraicExpressionArena> m_tree;
+        std::vector<Global::VariableId> m_treeSlotIds;                  // data set ids of the tree variables, in arena order
+        Program m_program;
+        std::string m_compileError;
+
+        void _bindVariables();
+        void _checkCompiled() const;
+        static Program _compile(const Common::AlgebraicExpressionArena& tree, Common::AlgebraicExpressionArena::NodeIndex root);
+        static void _emit(const Common::AlgebraicExpressionArena& tree, Common::AlgebraicExpressionArena::NodeIndex node,
+                          Program& program, std::vector<std::shared_ptr<const HistoryTerm>>& terms);
+        static Common::TimeSeries _evaluate(const Program& program, const Common::DataSet& ds, const boost::gregorian::date& from,
+                                            const boost::gregorian::date& to, boost::gregorian::date& exactFrom, bool& isTruncated);
     };
 
 
@@ -40,6 +92,8 @@ namespace Common
     {
     public:
         virtual Common::TimeSeries compute(const Common::DataSet& ds) const = 0;
+        virtual std::vector<std::string> getInputVariables() const = 0;
+        virtual void reset() {}     // drops anything cached from the inputs of a previous compute
 
         virtual ~FormulaVariablePostProc() = default;
     };
@@ -53,11 +107,14 @@ namespace Common
 
         Common::TimeSeries compute(const Common::DataSet& ds) const final;
         Common::TimeSeries getSeason(const Common::DataSet& ds) const;
+        std::vector<std::string> getInputVariables() const final;
+        void reset() final;
 
         void set(const std::string& variableName, const std::string& decompositionType, unsigned int period);
 
     private:
         std::string m_variable;
+        Global::VariableId m_variableId;
         std::unique_ptr<Common::SeasonalDecompose> m_decompPtr;
         mutable bool m_isDecomposed;
 
@@ -74,6 +131,7 @@ namespace Common
                                                const Common::TimeSeries& seasonality);
 
         Common::TimeSeries compute(const Common::DataSet& ds) const final;
+        std::vector<std::string> getInputVariables() const final;
 
         void set(const std::string& seasonalVariableName,
                  const std::string& deSeasonedVariableName,
@@ -83,6 +141,7 @@ namespace Common
 
     private:
         std::string m_seasonalVariable, m_deSeasonedVariable;
+        Global::VariableId m_seasonalVariableId;
         boost::gregorian::date m_restoreStartDate;
         std::unique_ptr<Common::RestoreSeason> m_restorePtr;
         std::vector<double> m_lastSeasonalCycle;
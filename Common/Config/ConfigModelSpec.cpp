@@ -124,9 +124,9 @@ void Common::ConfigModelSpecRelative::calibrate(const Common::DataSet &ds)
                      << m_dVariable.getBasename() <<  " has multiple drivers for relative model type. Using first driver only..." << std::endl;
 
     const std::vector<double> transformedDependentVariableValues =
-            m_dVariable.getTransformedTimeSeriesValues(ds.getTimeSeries(m_dVariable.getBasename()));
+            m_dVariable.getTransformedTimeSeriesValues(ds.getTimeSeriesRef(m_dVariable.getBasenameId()));
     const std::vector<double> transformedIndependentVariableValues =
-            m_idVariables.at(0).getTransformedTimeSeriesValues(ds.getTimeSeries(m_idVariables.at(0).getBasename()));
+            m_idVariables.at(0).getTransformedTimeSeriesValues(ds.getTimeSeriesRef(m_idVariables.at(0).getBasenameId()));
     
     // Delegate execution to m_modelPtr
     m_modelPtr -> calibrate(m_coeff, transformedDependentVariableValues, transformedIndependentVariableValues);
@@ -137,11 +137,11 @@ double Common::ConfigModelSpecRelative::predict(const Common::DataSet &ds, const
     if (m_coeff == 0)
         throw std::out_of_range("E: ConfigModelSpecRelative::predict : projections cannot be generated from un-calibrated models.");
 
-    const unsigned long index = ds.getTimeSeries(m_idVariables.at(0).getBasename()).getIndex(date);
+    const unsigned long index = ds.getTimeSeriesRef(m_idVariables.at(0).getBasenameId()).getIndex(date);
     const double scalar = m_multiplier * m_coeff;
     const double transformedProjection =
-            scalar * m_idVariables.at(0).getTransformedValue(ds.getTimeSeries(m_idVariables.at(0).getBasename()), index);
-    return m_dVariable.getLevel(ds.getTimeSeries(m_dVariable.getBasename()), transformedProjection, index);
+            scalar * m_idVariables.at(0).getTransformedValue(ds.getTimeSeriesRef(m_idVariables.at(0).getBasenameId()), index);
+    return m_dVariable.getLevel(ds.getTimeSeriesRef(m_dVariable.getBasenameId()), transformedProjection, index);
     //return predict(ds, index);
 }
 
@@ -170,14 +170,15 @@ Common::ConfigModelSpecRegression::ConfigModelSpecRegression(const Common::Confi
                                                              const std::vector<Common::ConfigVariable> &independentVariables,
                                                              const std::string &modelSubType,
                                                              const boost::gregorian::date &regressionStartDate,
-                                                             bool computeAnova):
+                                                             bool computeAnova,
+                                                             bool storeDesignMatrix):
         ConfigModelSpec(dependentVariable, independentVariables),
         m_startDate(regressionStartDate),
         m_modelSubType(modelSubType),
         m_params(), // [AC] number of id variables + intercept
         m_computeAnovaFlag(computeAnova),
         //Should be replaced by factory when more regression-type models are available
-        m_modelPtr(std::make_unique<Math::RegressionModelOLS>(Math::RegressionModelOLS()))
+        m_modelPtr(std::make_unique<Math::RegressionModelOLS>(storeDesignMatrix))
 {
 
 }
@@ -242,17 +243,16 @@ std::string Common::ConfigModelSpecRegression::getModelSubType() const
 boost::gregorian::date Common::ConfigModelSpecRegression::getFirstValidRegressionDate(const Common::DataSet &ds) const
 {
     // Get first valid date across drivers and dependent variable
-    boost::gregorian::date firstValidDate = ds.getTimeSeries(m_dVariable.getBasename()).getDates().at(getMaxLag() + 1);
+    boost::gregorian::date firstValidDate = ds.getTimeSeriesRef(m_dVariable.getBasenameId()).getDatesView().at(getMaxLag() + 1);
     for (const auto& it: m_idVariables)
     {
-        boost::gregorian::date thisDriverFirstAvailableDate = ds.getTimeSeries(it.getBasename()).getDates().at(getMaxLag() + 1);
+        boost::gregorian::date thisDriverFirstAvailableDate = ds.getTimeSeriesRef(it.getBasenameId()).getDatesView().at(getMaxLag() + 1);
         if (thisDriverFirstAvailableDate > firstValidDate)
             firstValidDate = thisDriverFirstAvailableDate;
     }
 
     // Check that the client-specified regression start date is more recent than the first available start date
-    const std::vector<boost::gregorian::date> dVariableDates = ds.getTimeSeries(m_dVariable.getBasename()).getDates();
-    if (m_startDate > firstValidDate && std::find(dVariableDates.begin(), dVariableDates.end(), m_startDate) != dVariableDates.end())
+    if (m_startDate > firstValidDate && ds.getTimeSeriesRef(m_dVariable.getBasenameId()).hasDate(m_startDate))
         firstValidDate = m_startDate;
     else
         std::cerr << "W: ConfigModelSpecRegression::getFirstValidRegressionDate : start regression date for variable " + m_dVariable.getBasename() +
@@ -261,6 +261,14 @@ boost::gregorian::date Common::ConfigModelSpecRegression::getFirstValidRegressio
     return firstValidDate;
 }
 
+std::vector<boost::gregorian::date> Common::ConfigModelSpecRegression::getRegressionDates(const Common::DataSet &ds) const
+{
+    const Common::TimeSeries& ts = ds.getTimeSeriesRef(m_dVariable.getBasenameId());
+    const std::vector<boost::gregorian::date> dates = ts.getDates();
+
+    return std::vector<boost::gregorian::date>(dates.begin() + ts.getIndex(getFirstValidRegressionDate(ds)), dates.end());
+}
+
 boost::numeric::ublas::vector<double> Common::ConfigModelSpecRegression::_getTransformedValues(const Common::TimeSeries &ts,
                                                                                                const boost::gregorian::date &firstDate,
                                                                                                const Common::ConfigVariable &variable) const
@@ -278,27 +286,54 @@ boost::numeric::ublas::vector<double> Common::ConfigModelSpecRegression::_getTra
     return rvs;
 }
 
-void Common::ConfigModelSpecRegression::calibrate(const Common::DataSet &ds)
+void Common::ConfigModelSpecRegression::_fillTransformedColumn(boost::numeric::ublas::matrix<double> &designMatrix,
+                                                               unsigned long column,
+                                                               const Common::TimeSeries &ts,
+                                                               const boost::gregorian::date &firstDate,
+                                                               const Common::ConfigVariable &variable) const
+{
+    const unsigned long firstIndex = ts.getIndex(firstDate);
+    const unsigned long nRows = designMatrix.size1();
+    if (ts.length() - firstIndex < nRows)
+        throw std::out_of_range("E: ConfigModelSpecRegression::calibrate : variable " + ts.getName() +
+                                " does not cover the regression sample of " + m_dVariable.getBasename() + ".");
+
+    // Transformed values are written straight into the (row-major) design matrix column, no intermediate vector
+    for (unsigned long j = 0; j < nRows; ++j)
+        designMatrix(j, column) = variable.getTransformedValue(ts, firstIndex + j);
+}
+
+void Common::ConfigModelSpecRegression::_buildRegressionSample(const Common::DataSet &ds,
+                                                               boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                                               boost::numeric::ublas::matrix<double> &independentVariableValues) const
 {
     // Get first available date across drivers and dependent variable
     const boost::gregorian::date firstValidDate = getFirstValidRegressionDate(ds);
 
     // Construct array of transformed dependent variable values to be used by MLRegression
-    const boost::numeric::ublas::vector<double> dVariableValuesForRegression =
-            _getTransformedValues(ds.getTimeSeries(m_dVariable.getBasename()), firstValidDate, m_dVariable);
+    dependentVariableValues = _getTransformedValues(ds.getTimeSeriesRef(m_dVariable.getBasenameId()), firstValidDate, m_dVariable);
+
+    _buildDesignMatrix(ds, firstValidDate, dependentVariableValues.size(), independentVariableValues);
+}
 
+void Common::ConfigModelSpecRegression::_buildDesignMatrix(const Common::DataSet &ds, const boost::gregorian::date &firstValidDate,
+                                                           unsigned long nRows,
+                                                           boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
     // Construct matrix of transformed independent variable values to be used by MLRegression
-    const unsigned long nRows = dVariableValuesForRegression.size();
     const unsigned long nCols = m_idVariables.size();
-    boost::numeric::ublas::matrix<double> idVariableValuesForRegression(nRows, nCols + 1, 1);
+    independentVariableValues = boost::numeric::ublas::matrix<double>(nRows, nCols + 1, 1);
 
     for (unsigned long i = 0; i < nCols; ++i)
-    {
-        const boost::numeric::ublas::vector<double> idVariableTransformedValues =
-                _getTransformedValues(ds.getTimeSeries(m_idVariables.at(i).getBasename()), firstValidDate, m_idVariables.at(i));
+        _fillTransformedColumn(independentVariableValues, i, ds.getTimeSeriesRef(m_idVariables.at(i).getBasenameId()),
+                               firstValidDate, m_idVariables.at(i));
+}
 
-        boost::numeric::ublas::column(idVariableValuesForRegression, i) = idVariableTransformedValues;
-    }
+void Common::ConfigModelSpecRegression::calibrate(const Common::DataSet &ds)
+{
+    boost::numeric::ublas::vector<double> dVariableValuesForRegression;
+    boost::numeric::ublas::matrix<double> idVariableValuesForRegression;
+    _buildRegressionSample(ds, dVariableValuesForRegression, idVariableValuesForRegression);
 
     // Delegate execution to RegressionModelObject
     boost::numeric::ublas::vector<double> params(idVariableValuesForRegression.size2());
@@ -316,20 +351,20 @@ double Common::ConfigModelSpecRegression::predict(const Common::DataSet &ds, con
 
     std::vector<unsigned long> idVariablesIndex;
     for (const auto& variable : m_idVariables)
-        idVariablesIndex.push_back(ds.getTimeSeries(variable.getBasename()).getIndex(date));
+        idVariablesIndex.push_back(ds.getTimeSeriesRef(variable.getBasenameId()).getIndex(date));
 
     const double intercept = m_params.back();
     double rhsSum = 0;
     for (unsigned int i = 0; i < m_idVariables.size(); ++i)
     {
-        const Common::TimeSeries ts = ds.getTimeSeries(m_idVariables.at(i).getBasename());
+        const Common::TimeSeries& ts = ds.getTimeSeriesRef(m_idVariables.at(i).getBasenameId());
         rhsSum += m_params.at(i) * m_idVariables.at(i).getTransformedValue(ts, idVariablesIndex.at(i));
     }
 
     rhsSum += intercept;
 
-    const Common::TimeSeries ts = ds.getTimeSeries(m_dVariable.getBasename());
-    const unsigned long dVariableIndex = ds.getTimeSeries(m_dVariable.getBasename()).length();
+    const Common::TimeSeries& ts = ds.getTimeSeriesRef(m_dVariable.getBasenameId());
+    const unsigned long dVariableIndex = ts.length();
     return m_dVariable.getLevel(ts, rhsSum, dVariableIndex);
 }
 
@@ -347,6 +382,85 @@ Math::ANOVASummary Common::ConfigModelSpecRegression::getANOVASummary() const
     return m_modelPtr -> getANOVA();
 }
 
+Math::ANOVASummary Common::ConfigModelSpecRegression::getANOVASummary(const Common::DataSet &ds) const
+{
+    if (m_params.empty())
+        throw std::out_of_range("E: ConfigModelSpecRegression::getANOVASummary : no diagnostics for un-calibrated models.");
+
+    // The sample is rebuilt from ds on request, the model itself may only hold sufficient statistics
+    boost::numeric::ublas::vector<double> dVariableValuesForRegression;
+    boost::numeric::ublas::matrix<double> idVariableValuesForRegression;
+    _buildRegressionSample(ds, dVariableValuesForRegression, idVariableValuesForRegression);
+
+    Math::ANOVASummary rv = getANOVASummary();
+    boost::numeric::ublas::vector<double> params(m_params.size());
+    std::copy(m_params.begin(), m_params.end(), params.begin());
+    Math::ANOVA().computeResiduals(rv, params, dVariableValuesForRegression, idVariableValuesForRegression);
+
+    return rv;
+}
+
+Math::RollingRegressionPath Common::ConfigModelSpecRegression::calibrateRolling(const Common::DataSet &ds, unsigned long window,
+                                                                              bool isExpanding) const
+{
+    boost::numeric::ublas::vector<double> dVariableValuesForRegression;
+    boost::numeric::ublas::matrix<double> idVariableValuesForRegression;
+    _buildRegressionSample(ds, dVariableValuesForRegression, idVariableValuesForRegression);
+
+    return Math::RollingRegression(window, isExpanding).calibrate(dVariableValuesForRegression, idVariableValuesForRegression);
+}
+
+void Common::ConfigModelSpecRegression::calibrateShared(const std::vector<Common::ConfigModelSpecRegression*> &specs,
+                                                        const Common::DataSet &ds)
+{
+    if (specs.empty())
+        return;
+
+    // Transformed dependent variable values, one column per specification, over the sample of the first one
+    const Common::ConfigModelSpecRegression& first = *specs.front();
+    boost::gregorian::date firstValidDate;
+    boost::numeric::ublas::matrix<double> dVariableValuesForRegression;
+    std::vector<Math::RegressionModel*> models;
+    for (unsigned long j = 0; j < specs.size(); ++j)
+    {
+        const Common::ConfigModelSpecRegression& spec = *specs[j];
+        const Common::TimeSeries& ts = ds.getTimeSeriesRef(spec.m_dVariable.getBasenameId());
+        const boost::gregorian::date specFirstValidDate = spec.getFirstValidRegressionDate(ds);
+        if (j == 0)
+            firstValidDate = specFirstValidDate;
+        else if (!spec.hasSameDesign(first) or specFirstValidDate != firstValidDate or
+                 ts.length() - ts.getIndex(firstValidDate) != dVariableValuesForRegression.size1())
+            throw std::runtime_error("E: ConfigModelSpecRegression::calibrateShared : " + spec.m_dVariable.getBasename() +
+                                     " does not share the regression sample of " + first.m_dVariable.getBasename() + ".");
+
+        const boost::numeric::ublas::vector<double> values = spec._getTransformedValues(ts, firstValidDate, spec.m_dVariable);
+        if (j == 0)
+            dVariableValuesForRegression.resize(values.size(), specs.size());
+        boost::numeric::ublas::column(dVariableValuesForRegression, j) = values;
+        models.push_back(spec.m_modelPtr.get());
+    }
+
+    boost::numeric::ublas::matrix<double> idVariableValuesForRegression;
+    first._buildDesignMatrix(ds, firstValidDate, dVariableValuesForRegression.size1(), idVariableValuesForRegression);
+
+    // Delegate execution to RegressionModelObject, the design matrix is factorised once for the whole group
+    boost::numeric::ublas::matrix<double> params(idVariableValuesForRegression.size2(), specs.size());
+    first.m_modelPtr -> calibrate(params, dVariableValuesForRegression, idVariableValuesForRegression, models);
+
+    for (unsigned long j = 0; j < specs.size(); ++j)
+    {
+        const boost::numeric::ublas::matrix_column<const boost::numeric::ublas::matrix<double>> column(params, j);
+        specs[j] -> m_params.assign(column.begin(), column.end());
+    }
+}
+
+bool Common::ConfigModelSpecRegression::hasSameDesign(const Common::ConfigModelSpecRegression &other) const
+{
+    // ConfigVariable equality covers basename, transformation and lag of every driver
+    return m_idVariables == other.m_idVariables and m_startDate == other.m_startDate and
+           m_modelSubType == other.m_modelSubType;
+}
+
 std::unique_ptr<Common::ConfigModelSpec> Common::ConfigModelSpecRegression::clone() const
 {
     return std::make_unique<Common::ConfigModelSpecRegression>(*this);
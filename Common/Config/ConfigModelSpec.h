@@ -11,6 +11,7 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include "ConfigVariable.h"
 #include "../Math/MLRegression/RegressionModel.h"
+#include "../Math/MLRegression/RollingRegression.h"
 
 
 namespace Math
@@ -87,7 +88,11 @@ namespace Common
 
 
     //
-    // Specialization for regression model sub-type specifications
+    // Specialization for regression model sub-type specifications. With storeDesignMatrix = false the calibrated model
+    // keeps sufficient statistics only, getANOVASummary(ds) rebuilds the sample to add fitted values and residuals.
+    // calibrateRolling leaves the calibrated model untouched, its lastObservations index getRegressionDates(ds).
+    // calibrateShared calibrates specifications with the same design (hasSameDesign, and the same regression dates in
+    // ds) on one factorisation of their common design matrix, each one keeps its own coefficients and ANOVA.
     //
     class ConfigModelSpecRegression : public ConfigModelSpec
     {
@@ -96,7 +101,8 @@ namespace Common
                                   const std::vector<Common::ConfigVariable> &independentVariables,
                                   const std::string &modelSubType,
                                   const boost::gregorian::date &regressionStartDate,
-                                  bool computeAnova = true);
+                                  bool computeAnova = true,
+                                  bool storeDesignMatrix = true);
         ConfigModelSpecRegression(const Common::ConfigModelSpecRegression& other);
         ConfigModelSpecRegression& operator=(const Common::ConfigModelSpecRegression& other);
         ConfigModelSpecRegression(Common::ConfigModelSpecRegression&& other);
@@ -107,8 +113,13 @@ namespace Common
         void calibrate(const Common::DataSet &ds) final;
         double predict(const Common::DataSet &ds, const boost::gregorian::date& date) const final;
         Math::ANOVASummary getANOVASummary() const;
+        Math::ANOVASummary getANOVASummary(const Common::DataSet &ds) const;
+        Math::RollingRegressionPath calibrateRolling(const Common::DataSet &ds, unsigned long window, bool isExpanding = false) const;
+        static void calibrateShared(const std::vector<Common::ConfigModelSpecRegression*> &specs, const Common::DataSet &ds);
+        bool hasSameDesign(const Common::ConfigModelSpecRegression &other) const;
 
         boost::gregorian::date getFirstValidRegressionDate(const Common::DataSet &ds) const;
+        std::vector<boost::gregorian::date> getRegressionDates(const Common::DataSet &ds) const;
         std::vector<double> getCalibratedCoefficients() const;
 
         std::unique_ptr<Common::ConfigModelSpec> clone() const final;
@@ -126,6 +137,13 @@ namespace Common
         boost::numeric::ublas::vector<double> _getTransformedValues(const Common::TimeSeries& ts,
                                                                     const boost::gregorian::date& firstDate,
                                                                     const Common::ConfigVariable& variable) const;
+        void _fillTransformedColumn(boost::numeric::ublas::matrix<double>& designMatrix, unsigned long column,
+                                    const Common::TimeSeries& ts, const boost::gregorian::date& firstDate,
+                                    const Common::ConfigVariable& variable) const;
+        void _buildRegressionSample(const Common::DataSet& ds, boost::numeric::ublas::vector<double>& dependentVariableValues,
+                                    boost::numeric::ublas::matrix<double>& independentVariableValues) const;
+        void _buildDesignMatrix(const Common::DataSet& ds, const boost::gregorian::date& firstValidDate, unsigned long nRows,
+                                boost::numeric::ublas::matrix<double>& independentVariableValues) const;
     };
 
 }
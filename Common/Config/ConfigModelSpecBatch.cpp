@@ -0,0 +1,125 @@
+#include <algorithm>
+#include "ConfigModelSpecBatch.h"
+#include "../Types/DataSet.h"
+
+namespace
+{
+    void calibrateOne(Common::ConfigModelSpecCalibration& calibration, const Common::DataSet& ds)
+    {
+        try
+        {
+            calibration.spec -> calibrate(ds);
+        }
+        catch (const std::exception& e)
+        {
+            calibration.spec.reset();
+            calibration.error = e.what();
+        }
+        catch (...)
+        {
+            calibration.spec.reset();
+            calibration.error = "E: ConfigModelSpecBatchCalibrator::calibrate : unknown error calibrating " + calibration.key + ".";
+        }
+    }
+}
+
+Common::ConfigModelSpecBatchCalibrator::ConfigModelSpecBatchCalibrator(unsigned int threadCount) : m_pool(threadCount)
+{
+
+}
+
+std::vector<Common::ConfigModelSpecCalibration> Common::ConfigModelSpecBatchCalibrator::calibrate(
+        const Common::ConfigMap<Common::ConfigModelSpec> &specs, const Common::DataSet &ds)
+{
+    std::vector<Common::ConfigModelSpecCalibration> rv;
+    for (auto& it: specs.getConfigMap())
+        rv.push_back({it.first, std::move(it.second), std::string()});
+
+    std::sort(rv.begin(), rv.end(), [](const Common::ConfigModelSpecCalibration& lhs, const Common::ConfigModelSpecCalibration& rhs)
+    { return lhs.key < rhs.key; });
+
+    const std::vector<std::vector<std::size_t>> groups = _groupByDesign(rv, ds);
+
+    // Each task only touches the slots of its own group, ds is shared read-only
+    m_pool.parallelFor(groups.size(), [&rv, &ds, &groups](std::size_t g)
+    {
+        const std::vector<std::size_t>& group = groups[g];
+        if (group.size() > 1)
+        {
+            std::vector<Common::ConfigModelSpecRegression*> regressions;
+            for (const auto i: group)
+                regressions.push_back(static_cast<Common::ConfigModelSpecRegression*>(rv[i].spec.get()));
+
+            try
+            {
+                Common::ConfigModelSpecRegression::calibrateShared(regressions, ds);
+                return;
+            }
+            catch (...)
+            {
+                // Calibrated one by one below, so that the error is recorded against the specification raising it
+            }
+        }
+
+        for (const auto i: group)
+            calibrateOne(rv[i], ds);
+    });
+
+    return rv;
+}
+
+std::vector<std::vector<std::size_t>> Common::ConfigModelSpecBatchCalibrator::_groupByDesign(
+        const std::vector<Common::ConfigModelSpecCalibration> &calibrations, const Common::DataSet &ds) const
+{
+    // Regression specifications with the same drivers, start date and regression dates share their design matrix
+    struct Design
+    {
+        const Common::ConfigModelSpecRegression* spec;
+        boost::gregorian::date firstDate;
+        std::size_t sampleSize;
+        std::size_t group;
+    };
+
+    std::vector<std::vector<std::size_t>> groups;
+    std::vector<Design> designs;
+    for (std::size_t i = 0; i < calibrations.size(); ++i)
+    {
+        const auto* regression = dynamic_cast<const Common::ConfigModelSpecRegression*>(calibrations[i].spec.get());
+        std::vector<boost::gregorian::date> dates;
+        if (regression)
+        {
+            try
+            {
+                dates = regression -> getRegressionDates(ds);
+            }
+            catch (...)
+            {
+                // Missing data, the specification is calibrated alone and reports its own error
+            }
+        }
+
+        if (dates.empty())
+        {
+            groups.push_back({i});
+            continue;
+        }
+
+        const auto design = std::find_if(designs.begin(), designs.end(), [&](const Design& d)
+        { return d.firstDate == dates.front() and d.sampleSize == dates.size() and d.spec -> hasSameDesign(*regression); });
+
+        if (design != designs.end())
+            groups[design -> group].push_back(i);
+        else
+        {
+            designs.push_back({regression, dates.front(), dates.size(), groups.size()});
+            groups.push_back({i});
+        }
+    }
+
+    return groups;
+}
+
+unsigned int Common::ConfigModelSpecBatchCalibrator::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
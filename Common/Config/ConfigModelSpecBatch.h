@@ -0,0 +1,52 @@
+#ifndef WILDCATSTKCORE_CONFIGMODELSPECBATCH_H
+#define WILDCATSTKCORE_CONFIGMODELSPECBATCH_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ConfigModelSpec.h"
+#include "../Types/ConfigMap.h"
+#include "../Utils/General/WorkStealingPool.h"
+
+
+namespace Common
+{
+    class DataSet;
+
+    //
+    // Outcome of one specification in a batch: the calibrated specification, or the error that stopped it
+    //
+    struct ConfigModelSpecCalibration
+    {
+        std::string key;
+        std::unique_ptr<Common::ConfigModelSpec> spec;      // null when calibration failed
+        std::string error;
+    };
+
+    //
+    // Calibrates every specification of a ConfigMap against one read-only DataSet on a work-stealing thread pool.
+    // Specifications are calibrated on clones, the map given is left untouched. A failing specification records its
+    // error and the rest of the batch carries on. Results come back sorted by key, whatever the thread count.
+    //
+    // Regression specifications sharing drivers, start date and regression dates are calibrated as one group on a
+    // single factorisation of their common design matrix (ConfigModelSpecRegression::calibrateShared). A group that
+    // fails is calibrated again one specification at a time, so errors are still reported per key.
+    //
+    class ConfigModelSpecBatchCalibrator
+    {
+    public:
+        explicit ConfigModelSpecBatchCalibrator(unsigned int threadCount = 0);
+
+        std::vector<Common::ConfigModelSpecCalibration> calibrate(const Common::ConfigMap<Common::ConfigModelSpec>& specs,
+                                                                  const Common::DataSet& ds);
+        unsigned int getThreadCount() const;
+
+    private:
+        Common::WorkStealingPool m_pool;
+
+        std::vector<std::vector<std::size_t>> _groupByDesign(const std::vector<Common::ConfigModelSpecCalibration>& calibrations,
+                                                             const Common::DataSet& ds) const;
+    };
+}
+
+#endif //WILDCATSTKCORE_CONFIGMODELSPECBATCH_H
@@ -89,17 +89,19 @@ ConfigVariable::ConfigVariable(const std::string &rawConfigVariable, std::string
     m_strsplit.split(rawConfigVariable, m_delimiter);
     m_transformationTypePtr = Global::TransformationTypeCodeFactoryMapping::instance() ->
             getFactory(m_strsplit.getTransformationTypeCode()) -> create();
+    m_basenameId = Global::VariableSymbols::instance() -> intern(m_strsplit.getBasename());
 }
 
 ConfigVariable::ConfigVariable(const std::string &rawConfigVariable) : ConfigVariable(rawConfigVariable, "|") {}
 
 ConfigVariable::ConfigVariable(const Common::ConfigVariable &other) :
         m_strsplit(other.m_strsplit), m_delimiter(other.m_delimiter),
-        m_transformationTypePtr(other.m_transformationTypePtr == nullptr ? nullptr : other.m_transformationTypePtr -> clone()) {}
+        m_transformationTypePtr(other.m_transformationTypePtr == nullptr ? nullptr : other.m_transformationTypePtr -> clone()),
+        m_basenameId(other.m_basenameId) {}
 
 ConfigVariable::ConfigVariable(Common::ConfigVariable &&other) :
         m_strsplit(other.m_strsplit), m_delimiter(other.m_delimiter),
-        m_transformationTypePtr(std::move(other.m_transformationTypePtr)) {}
+        m_transformationTypePtr(std::move(other.m_transformationTypePtr)), m_basenameId(other.m_basenameId) {}
 
 ConfigVariable& ConfigVariable::operator=(const Common::ConfigVariable &other)
 {
@@ -107,7 +109,8 @@ ConfigVariable& ConfigVariable::operator=(const Common::ConfigVariable &other)
     {
         m_strsplit = other.m_strsplit;
         m_delimiter = other.m_delimiter;
-        m_transformationTypePtr = other.m_transformationTypePtr -> clone();
+        m_transformationTypePtr = other.m_transformationTypePtr == nullptr ? nullptr : other.m_transformationTypePtr -> clone();
+        m_basenameId = other.m_basenameId;
     }
     return *this;
 }
@@ -119,6 +122,7 @@ ConfigVariable& ConfigVariable::operator=(Common::ConfigVariable &&other)
         m_strsplit = other.m_strsplit;
         m_delimiter = other.m_delimiter;
         m_transformationTypePtr = std::move(other.m_transformationTypePtr);
+        m_basenameId = other.m_basenameId;
     }
     return *this;
 }
@@ -128,6 +132,11 @@ std::string ConfigVariable::getBasename() const
     return m_strsplit.getBasename();
 }
 
+Global::VariableId ConfigVariable::getBasenameId() const
+{
+    return m_basenameId;
+}
+
 std::string ConfigVariable::getTransformationTypeCode() const
 {
     return m_strsplit.getTransformationTypeCode();
@@ -161,7 +170,7 @@ std::vector<double> ConfigVariable::getTransformedTimeSeriesValues(const Common:
     const unsigned int firstValidIndex = m_strsplit.getLagDependency() + 1;
     std::vector<double> transformedValues;
 
-    for (unsigned int i = firstValidIndex; i < ts.getValues().size(); ++i)
+    for (unsigned int i = firstValidIndex; i < ts.length(); ++i)
         transformedValues.push_back(getTransformedValue(ts, i));
 
     return transformedValues;
@@ -9,6 +9,7 @@
 #include <memory>
 #include "../../Concepts/Concepts.h"
 #include "../Utils/General/Tools.h"
+#include "../../Global/Symbols/VariableSymbols.h"
 
 namespace Common
 {
@@ -27,6 +28,7 @@ namespace Common
         ConfigVariable& operator=(ConfigVariable&& other);
 
         std::string getBasename() const;
+        Global::VariableId getBasenameId() const;
         std::string getTransformationTypeCode() const;
         unsigned int getLagDependency() const;
         double getTransformedValue(const TimeSeries &ts, unsigned int index) const;
@@ -40,6 +42,7 @@ namespace Common
         Common::StringSplitConfigVariableDecorator m_strsplit;
         std::string m_delimiter;
         std::unique_ptr<Common::TransformationType> m_transformationTypePtr;
+        Global::VariableId m_basenameId;
     };
 
 
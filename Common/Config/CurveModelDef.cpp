@@ -18,16 +18,22 @@ Common::CurveModelDef::CurveModelDef(std::string curveName,
 {
     for (const auto& it: tenorVariableNames)
         m_tenors.emplace(it, Common::getTenorInYearsFromVariableName(it));
+
+    // Tenor variables are resolved to their interned ids once, curve building then indexes the data set directly
+    for (const auto& it: m_tenors)
+        m_tenorIds.emplace_back(Global::VariableSymbols::instance() -> intern(it.first), it.second);
 }
 
 Common::CurveModelDef::CurveModelDef(const Common::CurveModelDef &other) :
     m_curveName(other.m_curveName),
     m_tenors(other.m_tenors),
+    m_tenorIds(other.m_tenorIds),
     m_interpPtr(other.m_interpPtr -> clone()) {}
 
 Common::CurveModelDef::CurveModelDef(Common::CurveModelDef &&other) :
         m_curveName(other.m_curveName),
         m_tenors(other.m_tenors),
+        m_tenorIds(other.m_tenorIds),
         m_interpPtr(std::move(other.m_interpPtr)) {}
 
 Common::CurveModelDef& Common::CurveModelDef::operator=(const Common::CurveModelDef &other)
@@ -36,6 +42,7 @@ Common::CurveModelDef& Common::CurveModelDef::operator=(const Common::CurveModel
     {
         m_curveName = other.m_curveName;
         m_tenors = other.m_tenors;
+        m_tenorIds = other.m_tenorIds;
         m_interpPtr = other.m_interpPtr -> clone();
     }
 
@@ -48,6 +55,7 @@ Common::CurveModelDef& Common::CurveModelDef::operator=(Common::CurveModelDef &&
     {
         m_curveName = other.m_curveName;
         m_tenors = other.m_tenors;
+        m_tenorIds = other.m_tenorIds;
         m_interpPtr = std::move(other.m_interpPtr);
     }
 
@@ -57,7 +65,7 @@ Common::CurveModelDef& Common::CurveModelDef::operator=(Common::CurveModelDef &&
 Common::YieldCurve Common::CurveModelDef::getYieldCurve(const Common::DataSet &ds, const boost::gregorian::date& date) const
 {
     YieldCurve r;
-    for (const auto& it: m_tenors)
+    for (const auto& it: m_tenorIds)
         r.emplace(it.second, ds.getValue(it.first, date));
 
     return std::move(r);
@@ -9,8 +9,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <unordered_map>
+#include "../../Global/Symbols/VariableSymbols.h"
 
 
 namespace Math
@@ -51,6 +53,7 @@ namespace Common
 
     private:
         std::unordered_map<std::string, double> m_tenors;
+        std::vector<std::pair<Global::VariableId, double>> m_tenorIds;
         std::unique_ptr<Math::Interpolator> m_interpPtr;
         std::string m_curveName;
     };
@@ -4,6 +4,7 @@
 
 #include "LinearInterpolator.h"
 #include <memory>
+#include <stdexcept>
 
 std::pair<double, double> Math::LinearInterpolator::interpolate(const std::map<double, double> &dataSet, double x)
 {
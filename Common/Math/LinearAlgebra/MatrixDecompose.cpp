@@ -4,57 +4,486 @@
 
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include "MatrixDecompose.h"
+#include "VectorKernels.h"
 
 //
 // MatrixDecompose concrete classes implementation
 //
-Math::CholeskyDecompose::CholeskyDecompose() : m_L(), m_isPositiveDef(true)
+namespace
+{
+    const unsigned long choleskyBlockSize = 64;
+}
+
+Math::CholeskyDecompose::CholeskyDecompose() : m_L(), m_dim(0), m_definiteness(Definiteness::PositiveDefinite)
 {
 
 }
 
 //
-// Naive Cholesky-Crout decomposition for positive-definite and semi-positive-definite matrix
+// Blocked right-looking Cholesky decomposition for positive-definite and semi-positive-definite matrix
 //
 void Math::CholeskyDecompose::decompose(const boost::numeric::ublas::matrix<double> &M)
 {
-    const long dim = M.size1();
-    boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::lower> L(dim, dim);
+    m_dim = M.size1(), m_definiteness = Definiteness::PositiveDefinite;
+    m_L.assign(m_dim * m_dim, 0);
+
+    double maxDiagonal = 0;
+    for (unsigned long j = 0; j < m_dim; ++j)
+    {
+        for (unsigned long i = j; i < m_dim; ++i)
+            m_L[i + j * m_dim] = M(i, j);
+        maxDiagonal = std::max(maxDiagonal, std::abs(M(j, j)));
+    }
 
-    for (unsigned long i = 0; i < dim ; ++i)
+    const double tolerance = m_dim * std::numeric_limits<double>::epsilon() * maxDiagonal;
+    for (unsigned long first = 0; first < m_dim; first += choleskyBlockSize)
     {
-        for (unsigned long k = i; k < dim; ++k)
+        const unsigned long width = std::min(choleskyBlockSize, m_dim - first);
+        _factorise(first, width, tolerance, std::sqrt(tolerance * maxDiagonal));
+
+        // Trailing lower triangle A22 <- A22 - L21 L21t, one contiguous column at a time
+        for (unsigned long c = first + width; c < m_dim; ++c)
         {
-            double sum = 0;
-            for (unsigned long j = 0; j < i; ++j)
+            double* const column = &m_L[c + c * m_dim];
+            for (unsigned long p = first; p < first + width; ++p)
             {
-                sum += L(i, j) * L(k, j);
+                const double scale = m_L[c + p * m_dim];
+                if (scale != 0)
+                    Math::VectorKernels::substractScaled(&m_L[c + p * m_dim], scale, column, m_dim - c);
             }
+        }
+    }
+}
 
-            // Make sure that no zero or complex element is on cholesky factor diagonal. If so, matrix is singular.
-            if (i == k and M(i, i) - sum <= 0)
+void Math::CholeskyDecompose::_factorise(unsigned long first, unsigned long width, double tolerance,
+                                         double offDiagonalTolerance)
+{
+    // Unblocked right-looking factorisation of the panel, rows first to dim - 1 of columns first to first + width - 1
+    for (unsigned long j = first; j < first + width; ++j)
+    {
+        double* const column = &m_L[j + j * m_dim];
+        const unsigned long length = m_dim - j;
+
+        // Make sure that no zero or complex element is on cholesky factor diagonal. If so, matrix is singular: the
+        // column is zeroed, which is exact for a semi-definite matrix, whose off-diagonal entries then vanish too.
+        if (!(column[0] > tolerance))
+        {
+            bool isSemiDefinite = column[0] >= -tolerance;
+            for (unsigned long i = 1; i < length and isSemiDefinite; ++i)
+                isSemiDefinite = std::abs(column[i]) <= offDiagonalTolerance;
+
+            if (!isSemiDefinite)
+                m_definiteness = Definiteness::Indefinite;
+            else if (m_definiteness == Definiteness::PositiveDefinite)
+                m_definiteness = Definiteness::PositiveSemiDefinite;
+
+            std::fill(column, column + length, 0.);
+            continue;
+        }
+
+        const double pivot = std::sqrt(column[0]);
+        column[0] = pivot;
+        for (unsigned long i = 1; i < length; ++i)
+            column[i] /= pivot;
+
+        for (unsigned long c = j + 1; c < first + width; ++c)
+            Math::VectorKernels::substractScaled(&m_L[c + j * m_dim], m_L[c + j * m_dim], &m_L[c + c * m_dim], m_dim - c);
+    }
+}
+
+void Math::CholeskyDecompose::update(std::vector<double> x)
+{
+    if (x.size() != m_dim or hasFailed())
+        throw std::runtime_error("Math::CholeskyDecompose::update : a positive definite factor of matching dimension is needed.");
+
+    updateFactor(m_L, m_dim, std::move(x));
+}
+
+bool Math::CholeskyDecompose::downdate(std::vector<double> x)
+{
+    if (x.size() != m_dim or hasFailed())
+        throw std::runtime_error("Math::CholeskyDecompose::downdate : a positive definite factor of matching dimension is needed.");
+
+    if (!downdateFactor(m_L, m_dim, std::move(x), false))
+    {
+        m_definiteness = Definiteness::Indefinite;
+        return false;
+    }
+    return true;
+}
+
+void Math::CholeskyDecompose::updateFactor(std::vector<double> &L, unsigned long dim, std::vector<double> x)
+{
+    for (unsigned long k = 0; k < dim; ++k)
+    {
+        double* const column = &L[k + k * dim];
+        const double r = std::hypot(column[0], x[k]);
+        if (k + 1 < dim)
+        {
+            const double c = r / column[0], s = x[k] / column[0];
+            for (unsigned long i = 1; i < dim - k; ++i)
             {
-                subrange(L, i, dim, k, k + 1) = boost::numeric::ublas::zero_matrix<double>(dim - i, 1);
-                std::cerr << "Math::CholeskyDecompose::decompose : "
-                             " matrix non-positive-definiteness detected. Cholesky decomposition may not be unique." << std::endl;
-                m_isPositiveDef = false;
-                k = dim - 1;
+                column[i] = (column[i] + s * x[k + i]) / c;
+                x[k + i] = c * x[k + i] - s * column[i];
             }
-            else
-                L(k, i) = (i == k) ? sqrt(M(i, i) - sum) :
-                          ((1. / L(i, i)) * (M(k, i) - sum));
         }
+        column[0] = r;
     }
-    m_L = L;
+}
+
+bool Math::CholeskyDecompose::downdateFactor(std::vector<double> &L, unsigned long dim, std::vector<double> x, bool isLastPivotFree)
+{
+    for (unsigned long k = 0; k < dim; ++k)
+    {
+        double* const column = &L[k + k * dim];
+        const double rSquared = (column[0] - x[k]) * (column[0] + x[k]);
+        if (isLastPivotFree and k + 1 == dim)
+        {
+            // Only rounding can take a free last pivot below zero
+            column[0] = std::sqrt(std::max(rSquared, 0.));
+            break;
+        }
+        if (!(rSquared > 0))
+            return false;
+
+        const double r = std::sqrt(rSquared);
+        const double c = r / column[0], s = x[k] / column[0];
+        column[0] = r;
+        for (unsigned long i = 1; i < dim - k; ++i)
+        {
+            column[i] = (column[i] - s * x[k + i]) / c;
+            x[k + i] = c * x[k + i] - s * column[i];
+        }
+    }
+    return true;
 }
 
 boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::lower> Math::CholeskyDecompose::getCholeskyFactor() const
+{
+    boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::lower> L(m_dim, m_dim);
+    for (unsigned long j = 0; j < m_dim; ++j)
+        for (unsigned long i = j; i < m_dim; ++i)
+            L(i, j) = m_L[i + j * m_dim];
+
+    return L;
+}
+
+const std::vector<double>& Math::CholeskyDecompose::getFactor() const
 {
     return m_L;
 }
 
+unsigned long Math::CholeskyDecompose::getDimension() const
+{
+    return m_dim;
+}
+
+Math::CholeskyDecompose::Definiteness Math::CholeskyDecompose::getDefiniteness() const
+{
+    return m_definiteness;
+}
+
 bool Math::CholeskyDecompose::hasFailed() const
 {
-    return !m_isPositiveDef;
-}
\ No newline at end of file
+    return m_definiteness != Definiteness::PositiveDefinite;
+}
+
+
+//
+// Blocked Householder QR decomposition
+//
+namespace
+{
+    const unsigned long qrBlockSize = 32;
+}
+
+Math::QRDecompose::QRDecompose() : m_QR(), m_tau(), m_rows(0), m_cols(0), m_rank(0), m_hasReflectors(false)
+{
+
+}
+
+void Math::QRDecompose::decompose(const boost::numeric::ublas::matrix<double> &M)
+{
+    m_rows = M.size1(), m_cols = M.size2(), m_rank = 0, m_hasReflectors = true;
+    m_tau.assign(m_cols, 0);
+    m_QR.resize(m_rows * m_cols);
+    for (unsigned long j = 0; j < m_cols; ++j)
+        for (unsigned long i = 0; i < m_rows; ++i)
+            m_QR[i + j * m_rows] = M(i, j);
+
+    if (m_rows < m_cols)
+        return;
+
+    for (unsigned long first = 0; first < m_cols; first += qrBlockSize)
+    {
+        const unsigned long width = std::min(qrBlockSize, m_cols - first);
+        for (unsigned long j = first; j < first + width; ++j)
+        {
+            _reflect(j);
+            for (unsigned long c = j + 1; c < first + width; ++c)
+                _applyReflector(j, &m_QR[c * m_rows]);
+        }
+        if (first + width < m_cols)
+            _applyBlock(first, width);
+    }
+
+    double maxDiagonal = 0;
+    for (unsigned long j = 0; j < m_cols; ++j)
+        maxDiagonal = std::max(maxDiagonal, std::abs(m_QR[j + j * m_rows]));
+
+    const double tolerance = std::max(m_rows, m_cols) * std::numeric_limits<double>::epsilon() * maxDiagonal;
+    for (unsigned long j = 0; j < m_cols; ++j)
+        if (std::abs(m_QR[j + j * m_rows]) > tolerance)     // also rejects NaN diagonal entries
+            ++m_rank;
+}
+
+void Math::QRDecompose::_reflect(unsigned long j)
+{
+    double* const v = &m_QR[j * m_rows];
+    double norm = 0;
+    for (unsigned long i = j + 1; i < m_rows; ++i)
+        norm += v[i] * v[i];
+
+    const double alpha = v[j];
+    if (norm == 0)
+    {
+        m_tau[j] = 0;
+        return;
+    }
+
+    const double beta = -std::copysign(std::sqrt(alpha * alpha + norm), alpha);
+    const double scale = 1. / (alpha - beta);
+    for (unsigned long i = j + 1; i < m_rows; ++i)
+        v[i] *= scale;
+
+    m_tau[j] = (beta - alpha) / beta;
+    v[j] = beta;
+}
+
+void Math::QRDecompose::_applyReflector(unsigned long j, double *column) const
+{
+    const double* const v = &m_QR[j * m_rows];
+    double w = column[j];
+    for (unsigned long i = j + 1; i < m_rows; ++i)
+        w += v[i] * column[i];
+
+    w *= m_tau[j];
+    column[j] -= w;
+    for (unsigned long i = j + 1; i < m_rows; ++i)
+        column[i] -= w * v[i];
+}
+
+void Math::QRDecompose::_applyBlock(unsigned long first, unsigned long width)
+{
+    // Upper triangular T such that H_first ... H_last = I - V T Vt, column by column as in LAPACK dlarft
+    std::vector<double> T(width * width, 0), w(width);
+    for (unsigned long i = 0; i < width; ++i)
+    {
+        const double* const vi = &m_QR[(first + i) * m_rows];
+        for (unsigned long p = 0; p < i; ++p)
+        {
+            const double* const vp = &m_QR[(first + p) * m_rows];
+            double dot = vp[first + i];
+            for (unsigned long r = first + i + 1; r < m_rows; ++r)
+                dot += vp[r] * vi[r];
+            w[p] = -m_tau[first + i] * dot;
+        }
+        for (unsigned long p = 0; p < i; ++p)
+        {
+            double sum = 0;
+            for (unsigned long q = p; q < i; ++q)
+                sum += T[p + q * width] * w[q];
+            T[p + i * width] = sum;
+        }
+        T[i + i * width] = m_tau[first + i];
+    }
+
+    // Trailing columns c <- c - V Tt Vt c
+    std::vector<double> y(width);
+    for (unsigned long c = first + width; c < m_cols; ++c)
+    {
+        double* const column = &m_QR[c * m_rows];
+        for (unsigned long p = 0; p < width; ++p)
+        {
+            const double* const vp = &m_QR[(first + p) * m_rows];
+            double dot = column[first + p];
+            for (unsigned long r = first + p + 1; r < m_rows; ++r)
+                dot += vp[r] * column[r];
+            y[p] = dot;
+        }
+        for (long p = width - 1; p >= 0; --p)
+        {
+            double sum = 0;
+            for (long q = 0; q <= p; ++q)
+                sum += T[q + p * width] * y[q];
+            y[p] = sum;
+        }
+        for (unsigned long p = 0; p < width; ++p)
+        {
+            const double* const vp = &m_QR[(first + p) * m_rows];
+            column[first + p] -= y[p];
+            for (unsigned long r = first + p + 1; r < m_rows; ++r)
+                column[r] -= vp[r] * y[p];
+        }
+    }
+}
+
+boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> Math::QRDecompose::getR() const
+{
+    boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> R(m_cols, m_cols);
+    for (unsigned long j = 0; j < m_cols; ++j)
+        for (unsigned long i = 0; i <= j and i < m_rows; ++i)
+            R(i, j) = m_QR[i + j * m_rows];
+
+    return R;
+}
+
+boost::numeric::ublas::matrix<double> Math::QRDecompose::computeInverseRtR() const
+{
+    // Rinv by back substitution, one column at a time, then (RtR)^-1 = Rinv Rinvt
+    std::vector<double> Rinv(m_cols * m_cols, 0);
+    for (unsigned long j = 0; j < m_cols; ++j)
+    {
+        Rinv[j + j * m_cols] = 1. / m_QR[j + j * m_rows];
+        for (long i = j - 1; i >= 0; --i)
+        {
+            double sum = 0;
+            for (unsigned long k = i + 1; k <= j; ++k)
+                sum += m_QR[i + k * m_rows] * Rinv[k + j * m_cols];
+            Rinv[i + j * m_cols] = -sum / m_QR[i + i * m_rows];
+        }
+    }
+
+    boost::numeric::ublas::matrix<double> rv(m_cols, m_cols);
+    for (unsigned long i = 0; i < m_cols; ++i)
+        for (unsigned long j = i; j < m_cols; ++j)
+        {
+            double sum = 0;
+            for (unsigned long k = j; k < m_cols; ++k)
+                sum += Rinv[i + k * m_cols] * Rinv[j + k * m_cols];
+            rv(i, j) = rv(j, i) = sum;
+        }
+
+    return rv;
+}
+
+boost::numeric::ublas::vector<double> Math::QRDecompose::solve(const boost::numeric::ublas::vector<double> &rhs) const
+{
+    if (!m_hasReflectors)
+        throw std::runtime_error("Math::QRDecompose::solve : reflectors were released, only R is left.");
+    if (rhs.size() != m_rows)
+        throw std::runtime_error("Math::QRDecompose::solve : right hand side size does not match decomposed matrix rows.");
+
+    std::vector<double> qty(rhs.begin(), rhs.end());
+    for (unsigned long j = 0; j < m_cols; ++j)
+        _applyReflector(j, qty.data());
+
+    boost::numeric::ublas::vector<double> x(m_cols);
+    for (long i = m_cols - 1; i >= 0; --i)
+    {
+        double sum = qty[i];
+        for (unsigned long k = i + 1; k < m_cols; ++k)
+            sum -= m_QR[i + k * m_rows] * x(k);
+        x(i) = sum / m_QR[i + i * m_rows];
+    }
+    return x;
+}
+
+boost::numeric::ublas::matrix<double> Math::QRDecompose::solve(const boost::numeric::ublas::matrix<double> &rhs) const
+{
+    if (!m_hasReflectors)
+        throw std::runtime_error("Math::QRDecompose::solve : reflectors were released, only R is left.");
+    if (rhs.size1() != m_rows)
+        throw std::runtime_error("Math::QRDecompose::solve : right hand side size does not match decomposed matrix rows.");
+
+    // QtB on a column-major copy, each reflector is applied to every right hand side while it is still in cache
+    const unsigned long nRhs = rhs.size2();
+    std::vector<double> qtb(m_rows * nRhs);
+    for (unsigned long c = 0; c < nRhs; ++c)
+        for (unsigned long i = 0; i < m_rows; ++i)
+            qtb[i + c * m_rows] = rhs(i, c);
+
+    for (unsigned long j = 0; j < m_cols; ++j)
+        for (unsigned long c = 0; c < nRhs; ++c)
+            _applyReflector(j, &qtb[c * m_rows]);
+
+    boost::numeric::ublas::matrix<double> x(m_cols, nRhs);
+    for (unsigned long c = 0; c < nRhs; ++c)
+        for (long i = m_cols - 1; i >= 0; --i)
+        {
+            double sum = qtb[i + c * m_rows];
+            for (unsigned long k = i + 1; k < m_cols; ++k)
+                sum -= m_QR[i + k * m_rows] * x(k, c);
+            x(i, c) = sum / m_QR[i + i * m_rows];
+        }
+    return x;
+}
+
+boost::numeric::ublas::matrix<double> Math::QRDecompose::solveRtR(const boost::numeric::ublas::matrix<double> &rhs) const
+{
+    if (rhs.size1() != m_cols)
+        throw std::runtime_error("Math::QRDecompose::solveRtR : right hand side size does not match decomposed matrix columns.");
+
+    // Rt w = b by forward substitution, then R x = w by back substitution, column by column
+    boost::numeric::ublas::matrix<double> x(m_cols, rhs.size2());
+    std::vector<double> w(m_cols);
+    for (unsigned long c = 0; c < rhs.size2(); ++c)
+    {
+        for (unsigned long i = 0; i < m_cols; ++i)
+        {
+            double sum = rhs(i, c);
+            for (unsigned long k = 0; k < i; ++k)
+                sum -= m_QR[k + i * m_rows] * w[k];
+            w[i] = sum / m_QR[i + i * m_rows];
+        }
+        for (long i = m_cols - 1; i >= 0; --i)
+        {
+            double sum = w[i];
+            for (unsigned long k = i + 1; k < m_cols; ++k)
+                sum -= m_QR[i + k * m_rows] * x(k, c);
+            x(i, c) = sum / m_QR[i + i * m_rows];
+        }
+    }
+    return x;
+}
+
+void Math::QRDecompose::releaseReflectors()
+{
+    if (!m_hasReflectors or m_rows < m_cols)
+        return;
+
+    std::vector<double> R(m_cols * m_cols, 0);
+    for (unsigned long j = 0; j < m_cols; ++j)
+        for (unsigned long i = 0; i <= j; ++i)
+            R[i + j * m_cols] = m_QR[i + j * m_rows];
+
+    m_QR.swap(R);
+    std::vector<double>().swap(m_tau);
+    m_rows = m_cols, m_hasReflectors = false;
+}
+
+bool Math::QRDecompose::hasReflectors() const
+{
+    return m_hasReflectors;
+}
+
+unsigned long Math::QRDecompose::getRank() const
+{
+    return m_rank;
+}
+
+bool Math::QRDecompose::isRankDeficient() const
+{
+    // Only meaningful for tall matrices, a wide one is not decomposed at all
+    return m_rows >= m_cols and m_rank < m_cols;
+}
+
+bool Math::QRDecompose::hasFailed() const
+{
+    return m_rank < m_cols;
+}
@@ -8,6 +8,7 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/triangular.hpp>
 #include <set>
+#include <vector>
 
 namespace Math
 {
@@ -24,20 +25,89 @@ namespace Math
         virtual ~MatrixDecompose() = default;
     };
 
-    class CholeskyDecompose : MatrixDecompose
+    //
+    // Blocked right-looking Cholesky factorisation over contiguous column-major storage. Each panel of columns is
+    // factorised and then subtracted from the trailing lower triangle in one pass, the column updates running on the
+    // SIMD axpy kernel. The factor stays in place: getFactor() reads it without a copy, getCholeskyFactor() builds the
+    // ublas triangular matrix on demand.
+    //
+    // A pivot below dim * eps * max|M_ii| zeroes its column, so a positive semi-definite matrix still gets a factor
+    // with L Lt = M. hasFailed() is true for any matrix that is not positive definite, getDefiniteness() tells the
+    // semi-definite case apart from an indefinite matrix.
+    //
+    // update and downdate turn the factor of M into the factor of M + x xt and M - x xt in O(dim^2) with Givens-like
+    // rotations, without refactorising. A downdate that would leave M - x xt not positive definite returns false and
+    // leaves the factor unusable, decompose must then be called again. updateFactor and downdateFactor run the same
+    // rotations on a raw column-major factor; there the last pivot may be or become zero, as it is for the factor of
+    // an augmented Gram matrix [X y]t[X y] whose last pivot is the residual norm of an exact fit.
+    //
+    class CholeskyDecompose : public MatrixDecompose
     {
     public:
+        enum class Definiteness { PositiveDefinite, PositiveSemiDefinite, Indefinite };
+
         CholeskyDecompose();
 
         void decompose(const boost::numeric::ublas::matrix<double> &M) override;
+        void update(std::vector<double> x);
+        bool downdate(std::vector<double> x);
+        static void updateFactor(std::vector<double>& L, unsigned long dim, std::vector<double> x);
+        static bool downdateFactor(std::vector<double>& L, unsigned long dim, std::vector<double> x, bool isLastPivotFree = true);
 
         boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::lower> getCholeskyFactor() const;
+        const std::vector<double>& getFactor() const;
+        unsigned long getDimension() const;
+        Math::CholeskyDecompose::Definiteness getDefiniteness() const;
 
         bool hasFailed() const final;
 
     protected:
-        boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::lower> m_L;
-        bool m_isPositiveDef;
+        std::vector<double> m_L;        // column-major, dim x dim, zero above the diagonal
+        unsigned long m_dim;
+        Math::CholeskyDecompose::Definiteness m_definiteness;
+
+        void _factorise(unsigned long first, unsigned long width, double tolerance, double offDiagonalTolerance);
+    };
+
+    //
+    // Blocked Householder QR of a tall matrix (rows >= columns), computed on a contiguous column-major copy. Each
+    // panel of columns is factorised one reflector at a time, then applied to the trailing columns at once in compact
+    // WY form (I - V T Vt), so the trailing matrix is streamed once per panel rather than once per reflector.
+    //
+    // The rank is the number of R diagonal entries above max(rows, columns) * eps * max|R_ii|. The decomposition has
+    // failed when the rank is below the column count, in which case every normal-equations method fails as well.
+    //
+    // releaseReflectors drops the Householder vectors and keeps R alone, in columns x columns storage: getR,
+    // computeInverseRtR and solveRtR still work, solve throws.
+    //
+    class QRDecompose : public MatrixDecompose
+    {
+    public:
+        QRDecompose();
+
+        void decompose(const boost::numeric::ublas::matrix<double> &M) override;
+
+        boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> getR() const;
+        boost::numeric::ublas::matrix<double> computeInverseRtR() const;
+        boost::numeric::ublas::vector<double> solve(const boost::numeric::ublas::vector<double> &rhs) const;
+        boost::numeric::ublas::matrix<double> solve(const boost::numeric::ublas::matrix<double> &rhs) const;
+        boost::numeric::ublas::matrix<double> solveRtR(const boost::numeric::ublas::matrix<double> &rhs) const;
+        void releaseReflectors();
+        bool hasReflectors() const;
+        unsigned long getRank() const;
+        bool isRankDeficient() const;
+
+        bool hasFailed() const final;
+
+    private:
+        std::vector<double> m_QR;       // R above the diagonal, Householder vectors below it (unit leading entry implied)
+        std::vector<double> m_tau;
+        unsigned long m_rows, m_cols, m_rank;
+        bool m_hasReflectors;
+
+        void _reflect(unsigned long j);
+        void _applyReflector(unsigned long j, double* column) const;
+        void _applyBlock(unsigned long first, unsigned long width);
     };
 
 }
@@ -0,0 +1,209 @@
+#include <cmath>
+#include <limits>
+#include "VectorKernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define WILDCATSTKCORE_VECTORKERNELS_SSE2 1
+#endif
+
+namespace
+{
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    #define WILDCATSTKCORE_BINARY_KERNEL(NAME, SIMD_OP, SCALAR_OP)                                                      \
+    void NAME(const double* lhs, const double* rhs, double* out, std::size_t n)                                         \
+    {                                                                                                                   \
+        std::size_t i = 0;                                                                                              \
+        for (; i + 4 <= n; i += 4)                                                                                      \
+        {                                                                                                               \
+            const __m128d a0 = _mm_loadu_pd(lhs + i), a1 = _mm_loadu_pd(lhs + i + 2);                                   \
+            const __m128d b0 = _mm_loadu_pd(rhs + i), b1 = _mm_loadu_pd(rhs + i + 2);                                   \
+            _mm_storeu_pd(out + i, SIMD_OP(a0, b0));                                                                    \
+            _mm_storeu_pd(out + i + 2, SIMD_OP(a1, b1));                                                                \
+        }                                                                                                               \
+        for (; i < n; ++i)                                                                                              \
+            out[i] = lhs[i] SCALAR_OP rhs[i];                                                                           \
+    }
+#else
+    #define WILDCATSTKCORE_BINARY_KERNEL(NAME, SIMD_OP, SCALAR_OP)                                                      \
+    void NAME(const double* lhs, const double* rhs, double* out, std::size_t n)                                         \
+    {                                                                                                                   \
+        for (std::size_t i = 0; i < n; ++i)                                                                             \
+            out[i] = lhs[i] SCALAR_OP rhs[i];                                                                           \
+    }
+#endif
+
+    WILDCATSTKCORE_BINARY_KERNEL(addKernel, _mm_add_pd, +)
+    WILDCATSTKCORE_BINARY_KERNEL(substractKernel, _mm_sub_pd, -)
+    WILDCATSTKCORE_BINARY_KERNEL(multiplyKernel, _mm_mul_pd, *)
+    WILDCATSTKCORE_BINARY_KERNEL(divideKernel, _mm_div_pd, /)
+
+    #undef WILDCATSTKCORE_BINARY_KERNEL
+
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    // Minpd / maxpd return the second operand when either is NaN, unordered lanes are patched with lhs + rhs
+    template <bool IsMinimum>
+    void extremumKernel(const double* lhs, const double* rhs, double* out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d a = _mm_loadu_pd(lhs + i), b = _mm_loadu_pd(rhs + i);
+            const __m128d unordered = _mm_cmpunord_pd(a, b);
+            const __m128d extremum = IsMinimum ? _mm_min_pd(a, b) : _mm_max_pd(a, b);
+            _mm_storeu_pd(out + i, _mm_or_pd(_mm_and_pd(unordered, _mm_add_pd(a, b)), _mm_andnot_pd(unordered, extremum)));
+        }
+        for (; i < n; ++i)
+            out[i] = IsMinimum ? Math::VectorKernels::minimum(lhs[i], rhs[i]) : Math::VectorKernels::maximum(lhs[i], rhs[i]);
+    }
+#endif
+}
+
+void Math::VectorKernels::add(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+    addKernel(lhs, rhs, out, n);
+}
+
+void Math::VectorKernels::substract(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+    substractKernel(lhs, rhs, out, n);
+}
+
+void Math::VectorKernels::multiply(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+    multiplyKernel(lhs, rhs, out, n);
+}
+
+void Math::VectorKernels::divide(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+    divideKernel(lhs, rhs, out, n);
+}
+
+void Math::VectorKernels::power(const double *base, const double *exponent, double *out, std::size_t n)
+{
+    // SSE2 has no vector pow, this one stays scalar
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = std::pow(base[i], exponent[i]);
+}
+
+void Math::VectorKernels::log(const double *values, double *out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = std::log(values[i]);
+}
+
+void Math::VectorKernels::exp(const double *values, double *out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = std::exp(values[i]);
+}
+
+void Math::VectorKernels::abs(const double *values, double *out, std::size_t n)
+{
+    std::size_t i = 0;
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    const __m128d signMask = _mm_set1_pd(-0.);
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_andnot_pd(signMask, _mm_loadu_pd(values + i)));
+#endif
+    for (; i < n; ++i)
+        out[i] = std::fabs(values[i]);
+}
+
+void Math::VectorKernels::minimum(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    extremumKernel<true>(lhs, rhs, out, n);
+#else
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = minimum(lhs[i], rhs[i]);
+#endif
+}
+
+void Math::VectorKernels::maximum(const double *lhs, const double *rhs, double *out, std::size_t n)
+{
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    extremumKernel<false>(lhs, rhs, out, n);
+#else
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = maximum(lhs[i], rhs[i]);
+#endif
+}
+
+void Math::VectorKernels::substractScaled(const double *values, double scale, double *out, std::size_t n)
+{
+    std::size_t i = 0;
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    const __m128d s = _mm_set1_pd(scale);
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(out + i), _mm_mul_pd(s, _mm_loadu_pd(values + i))));
+        _mm_storeu_pd(out + i + 2, _mm_sub_pd(_mm_loadu_pd(out + i + 2), _mm_mul_pd(s, _mm_loadu_pd(values + i + 2))));
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] -= scale * values[i];
+}
+
+void Math::VectorKernels::movingAverage(const double *values, double *out, std::size_t n, std::size_t window)
+{
+    // Running sum over the finite values, NaNs and infinities in the window are counted instead of summed so they do
+    // not stick once they leave it. The sum is taken again from the window values every window rows, and whenever the
+    // value leaving it dwarfs what is left, which would otherwise carry the rounding of the large value along.
+    const double nan = std::numeric_limits<double>::quiet_NaN(), inf = std::numeric_limits<double>::infinity();
+    const double cancellation = 65536.;
+    double sum = 0.;
+    std::size_t nanCount = 0, positiveInfCount = 0, negativeInfCount = 0;
+    const auto count = [&](double value, int sign)
+    {
+        if (std::isnan(value))
+            nanCount += sign;
+        else if (std::isinf(value))
+            (value > 0 ? positiveInfCount : negativeInfCount) += sign;
+        else
+            return true;
+        return false;
+    };
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (count(values[i], 1))
+            sum += values[i];
+
+        if (i >= window)
+        {
+            const bool isFinite = count(values[i - window], -1);
+            if (isFinite)
+                sum -= values[i - window];
+            if ((i + 1) % window == 0 or (isFinite and std::abs(values[i - window]) > cancellation * std::abs(sum)))
+            {
+                sum = 0.;
+                for (std::size_t j = i + 1 - window; j <= i; ++j)
+                    if (std::isfinite(values[j]))
+                        sum += values[j];
+            }
+        }
+
+        if (i + 1 < window or nanCount > 0 or (positiveInfCount > 0 and negativeInfCount > 0))
+            out[i] = nan;
+        else if (positiveInfCount > 0 or negativeInfCount > 0)
+            out[i] = positiveInfCount > 0 ? inf : -inf;
+        else
+            out[i] = sum / static_cast<double>(window);
+    }
+}
+
+void Math::VectorKernels::fill(double value, double *out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = value;
+}
+
+bool Math::VectorKernels::hasSIMD()
+{
+#if defined(WILDCATSTKCORE_VECTORKERNELS_SSE2)
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,53 @@
+#ifndef WILDCATSTKCORE_VECTORKERNELS_H
+#define WILDCATSTKCORE_VECTORKERNELS_H
+
+#include <cmath>
+#include <cstddef>
+
+namespace Math
+{
+    //
+    // Element-wise kernels over contiguous double buffers. Outputs may alias either input. Add, subtract, multiply,
+    // divide, absolute value, minimum and maximum process two lanes per instruction with SSE2 where the
+    // target has it, and fall back to scalar loops otherwise. Minimum and maximum are NaN when either operand is; their
+    // scalar forms are the single definition of that rule, used as well by every evaluator of algebraic formulas.
+    //
+    // substractScaled is the axpy update out[i] -= scale * values[i] used by the matrix factorisations; its output must
+    // not alias its input.
+    //
+    // movingAverage is the only kernel reading more than one row per output: out[i] is the mean of the window values
+    // ending at row i, NaN for the first window - 1 rows or when the window holds a NaN or infinities of both signs,
+    // +-inf when it holds infinities of one sign. Its output must not alias its input.
+    //
+    class VectorKernels
+    {
+    public:
+        static void add(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void substract(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void multiply(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void divide(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void power(const double* base, const double* exponent, double* out, std::size_t n);
+        static void log(const double* values, double* out, std::size_t n);
+        static void exp(const double* values, double* out, std::size_t n);
+        static void abs(const double* values, double* out, std::size_t n);
+        static void minimum(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void maximum(const double* lhs, const double* rhs, double* out, std::size_t n);
+        static void substractScaled(const double* values, double scale, double* out, std::size_t n);
+        static void movingAverage(const double* values, double* out, std::size_t n, std::size_t window);
+
+        static double minimum(double lhs, double rhs)
+        {
+            return std::isnan(lhs) or std::isnan(rhs) ? lhs + rhs : (rhs < lhs ? rhs : lhs);
+        }
+
+        static double maximum(double lhs, double rhs)
+        {
+            return std::isnan(lhs) or std::isnan(rhs) ? lhs + rhs : (rhs > lhs ? rhs : lhs);
+        }
+
+        static void fill(double value, double* out, std::size_t n);
+        static bool hasSIMD();
+    };
+}
+
+#endif //WILDCATSTKCORE_VECTORKERNELS_H
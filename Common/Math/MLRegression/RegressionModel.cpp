@@ -5,6 +5,7 @@
 
 #include "RegressionModel.h"
 #include "../Statistics/Stat.h"
+#include <utility>
 #include <boost/numeric/ublas/lu.hpp>
 #include <boost/qvm/mat_operations.hpp>
 #include <boost/qvm/mat_traits_array.hpp>
@@ -14,63 +15,165 @@
 //
 // ANOVA class implementation
 //
+void Math::RegressionSufficientStatistics::compute(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                                   const boost::numeric::ublas::matrix<double> &independentVariableValues)
+{
+    XtX = boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues), independentVariableValues);
+    XtY = boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues), dependentVariableValues);
+}
+
+void Math::RegressionSumsOfSquares::compute(const boost::numeric::ublas::vector<double> &coefficients,
+                                            const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                            const boost::numeric::ublas::matrix<double> &independentVariableValues)
+{
+    Math::UnivariateStat acc;
+    for (const auto& value : dependentVariableValues)
+        acc.add(value);
+
+    sampleSize = dependentVariableValues.size();
+    mean = acc.mean();
+    total = model = residual = 0;
+
+    const boost::numeric::ublas::vector<double> fittedValues = boost::numeric::ublas::prod(independentVariableValues, coefficients);
+    for (unsigned long i = 0; i < fittedValues.size(); ++i)
+    {
+        total += (dependentVariableValues(i) - mean) * (dependentVariableValues(i) - mean);
+        model += (fittedValues(i) - mean) * (fittedValues(i) - mean);
+        residual += (dependentVariableValues(i) - fittedValues(i)) * (dependentVariableValues(i) - fittedValues(i));
+    }
+}
+
+Math::RegressionWorkspace::RegressionWorkspace(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) :
+    m_depVariableVals(dependentVariableValues), m_indepVariableVals(independentVariableValues), m_statistics(),
+    m_hasStatistics(false)
+{
+
+}
+
+const boost::numeric::ublas::vector<double>& Math::RegressionWorkspace::getDependentVariableValues() const
+{
+    return m_depVariableVals;
+}
+
+const boost::numeric::ublas::matrix<double>& Math::RegressionWorkspace::getIndependentVariableValues() const
+{
+    return m_indepVariableVals;
+}
+
+const Math::RegressionSufficientStatistics& Math::RegressionWorkspace::getStatistics() const
+{
+    if (!m_hasStatistics)
+    {
+        m_statistics.compute(m_depVariableVals, m_indepVariableVals);
+        m_hasStatistics = true;
+    }
+
+    return m_statistics;
+}
+
+bool Math::RegressionWorkspace::hasStatistics() const
+{
+    return m_hasStatistics;
+}
+
 Math::ANOVASummary Math::ANOVA::computeANOVA(const boost::numeric::ublas::vector<double> &coefficients,
                                              const boost::numeric::ublas::vector<double> &dependentVariableValues,
                                              const boost::numeric::ublas::matrix<double> &independentVariableValues,
                                              const Math::RegressionModelAlgorithm &reg) const
+{
+    Math::RegressionSumsOfSquares sumsOfSquares;
+    sumsOfSquares.compute(coefficients, dependentVariableValues, independentVariableValues);
+
+    Math::ANOVASummary rv = computeANOVA(coefficients, sumsOfSquares, reg);
+    computeResiduals(rv, coefficients, dependentVariableValues, independentVariableValues);
+    return rv;
+}
+
+Math::ANOVASummary Math::ANOVA::computeANOVA(const boost::numeric::ublas::vector<double> &coefficients,
+                                             const Math::RegressionSumsOfSquares &sumsOfSquares,
+                                             const Math::RegressionModelAlgorithm &reg) const
 {
     Math::ANOVASummary rv;
+    const double k = coefficients.size();
 
     // Overall regression diagnostics
-    Math::UnivariateStat acc;
-    for (const auto& value : dependentVariableValues)
-        acc.add(value);
-
-    rv.totalMean = acc.mean();
-    rv.sampleSize = dependentVariableValues.size();
+    rv.totalMean = sumsOfSquares.mean;
+    rv.sampleSize = sumsOfSquares.sampleSize;
     rv.totalDoF = rv.sampleSize - 1;
-    rv.totalMSEVariance = acc.variance() * dependentVariableValues.size() / rv.totalDoF;
+    rv.totalMSEVariance = sumsOfSquares.total / rv.totalDoF;
 
-    rv.fittedValues = boost::numeric::ublas::prod(independentVariableValues, coefficients);
-    rv.residuals = dependentVariableValues - rv.fittedValues;
-    rv.residualDoF = rv.sampleSize - independentVariableValues.size2();
-    rv.residualMSEVariance = boost::numeric::ublas::inner_prod(rv.residuals, rv.residuals) / rv.residualDoF;
+    rv.residualDoF = rv.sampleSize - k;
+    rv.residualMSEVariance = sumsOfSquares.residual / rv.residualDoF;
+    rv.regressionStdErr = sqrt(rv.residualMSEVariance);
 
-    const boost::numeric::ublas::vector<double> modelMeanDeviation = rv.fittedValues -
-                                                             boost::numeric::ublas::vector<double>(rv.fittedValues.size(), rv.totalMean);
-
-    rv.modelDoF = independentVariableValues.size2() - 1;
-    rv.modelMSEVariance = boost::numeric::ublas::inner_prod(modelMeanDeviation, modelMeanDeviation) / rv.modelDoF;
+    rv.modelDoF = k - 1;
+    rv.modelMSEVariance = sumsOfSquares.model / rv.modelDoF;
 
     rv.adjRSquared = 1 - rv.residualMSEVariance / rv.totalMSEVariance;
     rv.RSquared = 1 - (rv.residualMSEVariance * rv.residualDoF) / (rv.totalMSEVariance * rv.totalDoF);
 
+    _computeCoefficientStatistics(rv, coefficients, reg);
+    return rv;
+}
+
+void Math::ANOVA::computeResiduals(Math::ANOVASummary &summary,
+                                   const boost::numeric::ublas::vector<double> &coefficients,
+                                   const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                   const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    summary.fittedValues = boost::numeric::ublas::prod(independentVariableValues, coefficients);
+    summary.residuals = dependentVariableValues - summary.fittedValues;
+}
+
+void Math::ANOVA::_computeCoefficientStatistics(Math::ANOVASummary &summary,
+                                                const boost::numeric::ublas::vector<double> &coefficients,
+                                                const Math::RegressionModelAlgorithm &reg) const
+{
     // Estimated coefficient diagnostics
-    const boost::numeric::ublas::matrix<double> coeffsCovMatrix = reg.computeCoefficientCovarianceMatrix(rv.residualMSEVariance);
+    const boost::numeric::ublas::matrix<double> coeffsCovMatrix = reg.computeCoefficientCovarianceMatrix(summary.residualMSEVariance);
     Math::SummaryStatistic st;
 
     for (unsigned long i = 0; i < coeffsCovMatrix.size1(); ++i)
     {
         st.stdErr = sqrt(coeffsCovMatrix(i, i));
         st.tRatio = coefficients(i) / st.stdErr;
-        st.pValue = 2 * boost::math::cdf(boost::math::students_t_distribution<double>(rv.sampleSize - 1), -std::abs(st.tRatio));
-        rv.coefficientSummaryStat.push_back(st);
+        st.pValue = 2 * boost::math::cdf(boost::math::students_t_distribution<double>(summary.sampleSize - 1), -std::abs(st.tRatio));
+        summary.coefficientSummaryStat.push_back(st);
     }
-    return rv;
 }
 
 
 //
 // Regression model interface implementation for OLS sub-type
 //
-Math::RegressionModelOLS::RegressionModelOLS() :
-    m_algorithmPtr(Math::RegressionModelAlgorithmCholesky().clone()) //[AC] initialize to default algorithm (first link in chain)
+Math::RegressionModelOLS::RegressionModelOLS(bool storeDesignMatrix) :
+    m_algorithmPtr(Math::RegressionModelAlgorithmQR().clone()), // initialize to default algorithm (first link in chain)
+    m_chain(nullptr),
+    m_storeDesignMatrix(storeDesignMatrix)
 {
+    // Construct chain of responsibility
+    std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> head =
+            std::make_shared<Math::RegressionModelAlgorithmOLSChain>(m_storeDesignMatrix);
+
+    std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> firstLink =
+            std::make_shared<Math::RegressionModelOLSLinkQR>(m_storeDesignMatrix);
+
+    std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> secondLink =
+            std::make_shared<Math::RegressionModelOLSLinkCholesky>(m_storeDesignMatrix);
 
+    std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> lastLink =
+            std::make_shared<Math::RegressionModelOLSLinkMoorePenrose>(m_storeDesignMatrix);
+
+    // Add chain links to head in order of priority execution
+    head -> addLink(firstLink), head -> addLink(secondLink), head -> addLink(lastLink);
+    m_chain = head;
 }
 
 Math::RegressionModelOLS::RegressionModelOLS(const Math::RegressionModelOLS &other) :
-    m_algorithmPtr(other.m_algorithmPtr -> clone())
+    m_algorithmPtr(other.m_algorithmPtr -> clone()),
+    m_chain(other.m_chain),
+    m_storeDesignMatrix(other.m_storeDesignMatrix)
 {
 
 }
@@ -78,7 +181,11 @@ Math::RegressionModelOLS::RegressionModelOLS(const Math::RegressionModelOLS &oth
 Math::RegressionModelOLS& Math::RegressionModelOLS::operator=(const Math::RegressionModelOLS &other)
 {
     if (&other != this)
+    {
         m_algorithmPtr = other.m_algorithmPtr -> clone();
+        m_chain = other.m_chain;
+        m_storeDesignMatrix = other.m_storeDesignMatrix;
+    }
 
     return *this;
 }
@@ -89,27 +196,47 @@ void Math::RegressionModelOLS::calibrate(boost::numeric::ublas::vector<double> &
 {
     if (dependentVariableValues.size() == independentVariableValues.size1() and independentVariableValues.size1() > 2)
     {
-        // Construct chain of responsibility
-        std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> head =
-                std::make_shared<Math::RegressionModelAlgorithmOLSChain>(Math::RegressionModelAlgorithmOLSChain());
-
-        std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> firstLink =
-                std::make_shared<Math::RegressionModelOLSLinkCholesky>(Math::RegressionModelOLSLinkCholesky());
-
-        std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> lastLink =
-                std::make_shared<Math::RegressionModelOLSLinkMoorePenrose>(Math::RegressionModelOLSLinkMoorePenrose());
-
-        // Add chain links to head in order of priority execution
-        head -> addLink(firstLink), head -> addLink(lastLink);
+        // Links falling through share the workspace, the normal equations are formed at most once per calibration
+        const Math::RegressionWorkspace workspace(dependentVariableValues, independentVariableValues);
 
         // Recursively descend chain and return pointer to algorithm being used for calibration
-        m_algorithmPtr = head -> handle(coefficients, dependentVariableValues, independentVariableValues);
+        m_algorithmPtr = m_chain -> handle(coefficients, workspace);
     }
     else
         throw std::runtime_error("Math::RegressionModelOLS::calibrate : "
                                  "at least two observations are needed for regression model to run.");
 }
 
+void Math::RegressionModelOLS::calibrate(boost::numeric::ublas::matrix<double> &coefficients,
+                                         const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                                         const boost::numeric::ublas::matrix<double> &independentVariableValues,
+                                         const std::vector<Math::RegressionModel*> &models) const
+{
+    if (dependentVariableValues.size2() != models.size() or models.empty())
+        throw std::runtime_error("Math::RegressionModelOLS::calibrate : one model is needed per dependent variable column.");
+    if (dependentVariableValues.size1() != independentVariableValues.size1() or independentVariableValues.size1() <= 2)
+        throw std::runtime_error("Math::RegressionModelOLS::calibrate : "
+                                 "at least two observations are needed for regression model to run.");
+
+    // The chain picks and factorises on the first column, the factor is then solved against every column at once
+    const boost::numeric::ublas::vector<double> firstColumn(boost::numeric::ublas::column(dependentVariableValues, 0));
+    const Math::RegressionWorkspace design(firstColumn, independentVariableValues);
+    boost::numeric::ublas::vector<double> firstCoefficients(independentVariableValues.size2());
+    const std::unique_ptr<Math::RegressionModelAlgorithm> factor = m_chain -> handle(firstCoefficients, design);
+    factor -> solve(coefficients, dependentVariableValues, independentVariableValues);
+
+    for (unsigned long j = 0; j < models.size(); ++j)
+    {
+        Math::RegressionModelOLS* model = dynamic_cast<Math::RegressionModelOLS*>(models[j]);
+        if (!model)
+            throw std::runtime_error("Math::RegressionModelOLS::calibrate : models sharing an OLS factor must be OLS models.");
+
+        model -> m_algorithmPtr = factor -> share(boost::numeric::ublas::column(coefficients, j),
+                                                  boost::numeric::ublas::column(dependentVariableValues, j),
+                                                  design, model -> m_storeDesignMatrix);
+    }
+}
+
 Math::ANOVASummary Math::RegressionModelOLS::getANOVA() const
 {
     return m_algorithmPtr -> getANOVA();
@@ -124,7 +251,8 @@ std::unique_ptr<Math::RegressionModel> Math::RegressionModelOLS::clone() const
 //
 // Implementation of recursive descent chain of responsibility for OLS linear system solution
 //
-Math::RegressionModelAlgorithmOLSChain::RegressionModelAlgorithmOLSChain() : m_nextLink(nullptr)
+Math::RegressionModelAlgorithmOLSChain::RegressionModelAlgorithmOLSChain(bool storeDesignMatrix) :
+    m_storeDesignMatrix(storeDesignMatrix), m_nextLink(nullptr)
 {
 
 }
@@ -138,52 +266,112 @@ void Math::RegressionModelAlgorithmOLSChain::addLink(const std::shared_ptr<Math:
 }
 
 std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithmOLSChain::handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                                                               const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+                                                                                               const Math::RegressionWorkspace &workspace) const
 {
     if (m_nextLink)
-        return m_nextLink -> handle(coefficients, dependentVariableValues, independentVariableValues);
+        return m_nextLink -> handle(coefficients, workspace);
     else
         throw std::runtime_error("Math::RegressionModelAlgorithmOLSChain::calibrate : impossible to run OLS algorithm chain.");
 }
 
+std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelOLSLinkQR::handle(boost::numeric::ublas::vector<double> &coefficients,
+                                                                                       const Math::RegressionWorkspace &workspace) const
+{
+    Math::RegressionModelAlgorithmQR qr;
+    qr.setStoreDesignMatrix(m_storeDesignMatrix);
+    qr.calibrate(coefficients, workspace);
+
+    // A rank deficient X makes XtX singular too, the normal equations links further down would only fail again
+    if (qr.isRankDeficient())
+        throw std::runtime_error("Math::RegressionModelOLSLinkQR::handle : design matrix is rank deficient, "
+                                 "OLS coefficients are not unique.");
+
+    if (qr.hasFailed())
+        return Math::RegressionModelAlgorithmOLSChain::handle(coefficients, workspace);
+    else
+        return std::make_unique<Math::RegressionModelAlgorithmQR>(std::move(qr));
+}
+
 std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelOLSLinkCholesky::handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                                                             const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                                                             const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+                                                                                             const Math::RegressionWorkspace &workspace) const
 {
     Math::RegressionModelAlgorithmCholesky ch;
-    ch.calibrate(coefficients, dependentVariableValues, independentVariableValues);
+    ch.setStoreDesignMatrix(m_storeDesignMatrix);
+    ch.calibrate(coefficients, workspace);
 
     if (ch.hasFailed())
-        return Math::RegressionModelAlgorithmOLSChain::handle(coefficients, dependentVariableValues, independentVariableValues);
+        return Math::RegressionModelAlgorithmOLSChain::handle(coefficients, workspace);
     else
-        return std::make_unique<Math::RegressionModelAlgorithmCholesky>(ch);
+        return std::make_unique<Math::RegressionModelAlgorithmCholesky>(std::move(ch));
 }
 
 std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelOLSLinkMoorePenrose::handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                                                                 const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                                                                 const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+                                                                                                 const Math::RegressionWorkspace &workspace) const
 {
     Math::RegressionModelAlgorithmMoorePenrose mp;
-    mp.calibrate(coefficients, dependentVariableValues, independentVariableValues);
+    mp.setStoreDesignMatrix(m_storeDesignMatrix);
+    mp.calibrate(coefficients, workspace);
 
     if (mp.hasFailed())
-        return Math::RegressionModelAlgorithmOLSChain::handle(coefficients, dependentVariableValues, independentVariableValues);
+        return Math::RegressionModelAlgorithmOLSChain::handle(coefficients, workspace);
     else
-        return std::make_unique<Math::RegressionModelAlgorithmMoorePenrose>(mp);
+        return std::make_unique<Math::RegressionModelAlgorithmMoorePenrose>(std::move(mp));
 }
 
 
 //
 // Regression model algorithm interface implementation
 //
+void Math::RegressionModelAlgorithm::calibrate(boost::numeric::ublas::vector<double> &coefficients,
+                                               const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    calibrate(coefficients, Math::RegressionWorkspace(dependentVariableValues, independentVariableValues));
+}
+
 Math::ANOVASummary Math::RegressionModelAlgorithm::getANOVA() const
 {
     Math::ANOVA anova;
-    return anova.computeANOVA(m_coefficients, m_depVariableVals, m_indepVariableVals, *this);
+    if (m_storeDesignMatrix)
+        return anova.computeANOVA(m_coefficients, m_depVariableVals, m_indepVariableVals, *this);
+    else
+        return anova.computeANOVA(m_coefficients, m_sumsOfSquares, *this);
+}
+
+void Math::RegressionModelAlgorithm::setStoreDesignMatrix(bool storeDesignMatrix)
+{
+    m_storeDesignMatrix = storeDesignMatrix;
+}
+
+std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithm::share(const boost::numeric::ublas::vector<double> &coefficients,
+                                                                                      const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                                                                      const Math::RegressionWorkspace &design,
+                                                                                      bool storeDesignMatrix) const
+{
+    std::unique_ptr<Math::RegressionModelAlgorithm> rv = clone();
+    rv -> m_storeDesignMatrix = storeDesignMatrix;
+    rv -> m_coefficients = coefficients;
+    if (storeDesignMatrix)
+        rv -> m_depVariableVals = dependentVariableValues, rv -> m_indepVariableVals = design.getIndependentVariableValues();
+    else
+    {
+        rv -> m_sumsOfSquares.compute(coefficients, dependentVariableValues, design.getIndependentVariableValues());
+        rv -> m_depVariableVals.resize(0), rv -> m_indepVariableVals.resize(0, 0);
+    }
+
+    return rv;
+}
+
+void Math::RegressionModelAlgorithm::_storeSample(const Math::RegressionWorkspace &workspace) const
+{
+    if (m_storeDesignMatrix)
+        m_depVariableVals = workspace.getDependentVariableValues(), m_indepVariableVals = workspace.getIndependentVariableValues();
+    else
+        m_sumsOfSquares.compute(m_coefficients, workspace.getDependentVariableValues(), workspace.getIndependentVariableValues());
 }
 
-Math::RegressionModelAlgorithmMoorePenrose::RegressionModelAlgorithmMoorePenrose() : m_invXtX(), m_isInvertible(true)
+Math::RegressionModelAlgorithmMoorePenrose::RegressionModelAlgorithmMoorePenrose() :
+    m_invXtX(std::make_shared<const boost::numeric::ublas::matrix<double>>()), m_isInvertible(true)
 {
 
 }
@@ -206,21 +394,27 @@ void Math::RegressionModelAlgorithmMoorePenrose::_computeInverseByLUFactorizatio
 }
 
 void Math::RegressionModelAlgorithmMoorePenrose::calibrate(boost::numeric::ublas::vector<double> &coefficients,
-                                                           const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                           const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+                                                           const Math::RegressionWorkspace &workspace) const
 {
-    m_depVariableVals = dependentVariableValues, m_indepVariableVals = independentVariableValues;
-
-    const boost::numeric::ublas::matrix<double> Xt(boost::numeric::ublas::trans(independentVariableValues));
-    const boost::numeric::ublas::matrix<double> XtX(boost::numeric::ublas::prod(Xt, independentVariableValues));
-
-    _computeInverseByLUFactorization(XtX, m_invXtX);
+    const Math::RegressionSufficientStatistics& statistics = workspace.getStatistics();
+    const std::shared_ptr<boost::numeric::ublas::matrix<double>> invXtX = std::make_shared<boost::numeric::ublas::matrix<double>>();
+    _computeInverseByLUFactorization(statistics.XtX, *invXtX);
     if (!m_isInvertible)
         return;
 
-    const boost::numeric::ublas::vector<double> XtY = boost::numeric::ublas::prod(Xt, dependentVariableValues);
-    coefficients = boost::numeric::ublas::prod(m_invXtX, XtY);
+    m_invXtX = invXtX;
+    coefficients = boost::numeric::ublas::prod(*m_invXtX, statistics.XtY);
     m_coefficients = coefficients;
+    _storeSample(workspace);
+}
+
+void Math::RegressionModelAlgorithmMoorePenrose::solve(boost::numeric::ublas::matrix<double> &coefficients,
+                                                       const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                                                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    const boost::numeric::ublas::matrix<double> XtY(boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues),
+                                                                                dependentVariableValues));
+    coefficients = boost::numeric::ublas::prod(*m_invXtX, XtY);
 }
 
 bool Math::RegressionModelAlgorithmMoorePenrose::hasFailed() const
@@ -231,7 +425,7 @@ bool Math::RegressionModelAlgorithmMoorePenrose::hasFailed() const
 boost::numeric::ublas::matrix<double> Math::RegressionModelAlgorithmMoorePenrose::computeCoefficientCovarianceMatrix(
         double residualVariance) const
 {
-    return residualVariance * m_invXtX;
+    return residualVariance * *m_invXtX;
 }
 
 std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithmMoorePenrose::clone() const
@@ -240,90 +434,68 @@ std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithmMo
 }
 
 void Math::RegressionModelAlgorithmCholesky::calibrate(boost::numeric::ublas::vector<double> &coefficients,
-                                                       const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+                                                       const Math::RegressionWorkspace &workspace) const
 {
-    m_depVariableVals = dependentVariableValues, m_indepVariableVals = independentVariableValues;
-
-    const boost::numeric::ublas::matrix<double> Xt(boost::numeric::ublas::trans(independentVariableValues));
-    const boost::numeric::ublas::matrix<double> XtX(boost::numeric::ublas::prod(Xt, independentVariableValues));
-
-    m_ch.decompose(XtX);
-    if (m_ch.hasFailed())
+    const Math::RegressionSufficientStatistics& statistics = workspace.getStatistics();
+    const std::shared_ptr<Math::CholeskyDecompose> ch = std::make_shared<Math::CholeskyDecompose>();
+    ch -> decompose(statistics.XtX);
+    m_ch = ch;
+    if (m_ch -> hasFailed())
         return;
 
-    const boost::numeric::ublas::vector<double> XtY(boost::numeric::ublas::prod(Xt, dependentVariableValues));
-    coefficients = _choleskySolve(m_ch.getCholeskyFactor(), XtY);
+    coefficients = _choleskySolve(m_ch -> getFactor(), statistics.XtY);
     m_coefficients = coefficients;
+    _storeSample(workspace);
 }
 
 boost::numeric::ublas::vector<double> Math::RegressionModelAlgorithmCholesky::_choleskySolve(
-        const boost::numeric::ublas::matrix<double> &choleskyFactor, const boost::numeric::ublas::vector<double> &rhs) const
+        const std::vector<double> &choleskyFactor, const boost::numeric::ublas::vector<double> &rhs) const
 {
-    const long dim = choleskyFactor.size1();
+    const long dim = rhs.size();
 
-    // solve lower triangular system Lt*w=y for x by forward substitution
-    boost::numeric::ublas::vector<double> omega(dim);
-    for (unsigned long i = 0; i < dim; ++i)
+    // solve lower triangular system L*w=y for w by forward substitution, L is read in place (column-major)
+    boost::numeric::ublas::vector<double> omega(rhs);
+    for (long j = 0; j < dim; ++j)
     {
-        double sum = 0;
-        for (unsigned long j = 0; j < i; ++j)
-        {
-            sum += choleskyFactor(i, j) * omega(j);
-        }
-        omega(i) = (rhs(i) - sum) / choleskyFactor(i, i);
+        omega(j) /= choleskyFactor[j + j * dim];
+        for (long i = j + 1; i < dim; ++i)
+            omega(i) -= choleskyFactor[i + j * dim] * omega(j);
     }
 
-    // solve upper triangular system L*x=w for x by backward substitution
+    // solve upper triangular system Lt*x=w for x by backward substitution
     boost::numeric::ublas::vector<double> x(dim);
     for (long i = dim - 1; i >= 0 ; --i)
     {
         double sum = 0;
-        for (unsigned long j = i + 1; j < dim ; ++j)
-        {
-            sum += choleskyFactor(j, i) * x(j);
-        }
-        x(i) = (omega(i) - sum) / choleskyFactor(i, i);
+        for (long j = i + 1; j < dim ; ++j)
+            sum += choleskyFactor[j + i * dim] * x(j);
+        x(i) = (omega(i) - sum) / choleskyFactor[i + i * dim];
     }
     return x;
 }
 
 boost::numeric::ublas::matrix<double> Math::RegressionModelAlgorithmCholesky::_choleskySolve(
-        const boost::numeric::ublas::matrix<double> &choleskyFactor, const boost::numeric::ublas::matrix<double> &rhs) const
+        const std::vector<double> &choleskyFactor, const boost::numeric::ublas::matrix<double> &rhs) const
 {
-    const long dim = choleskyFactor.size1();
-
-    // solve lower triangular system Lt*W=Y for x by forward substitution
-    boost::numeric::ublas::matrix<double> omega(dim, dim);
-    for (unsigned long i = 0; i < dim; ++i)
-    {
-        boost::numeric::ublas::vector<double> sum(dim, 0);
-        for (unsigned long j = 0; j < i; ++j)
-        {
-            for (unsigned long k = 0; k < dim; ++k)
-                sum(k) += choleskyFactor(i, j) * omega(j, k);
-        }
-        boost::numeric::ublas::row(omega, i) = (boost::numeric::ublas::row(rhs, i) - sum) / choleskyFactor(i, i);
-    }
+    boost::numeric::ublas::matrix<double> x(rhs.size1(), rhs.size2());
+    for (unsigned long k = 0; k < rhs.size2(); ++k)
+        boost::numeric::ublas::column(x, k) = _choleskySolve(choleskyFactor, boost::numeric::ublas::vector<double>(boost::numeric::ublas::column(rhs, k)));
 
-    // solve upper triangular system L*X=W for x by backward substitution
-    boost::numeric::ublas::matrix<double> x(dim, dim);
-    for (long i = dim - 1; i >= 0 ; --i)
-    {
-        boost::numeric::ublas::vector<double> sum(dim, 0);
-        for (unsigned long j = i + 1; j < dim ; ++j)
-        {
-            for (unsigned long k = 0; k < dim; ++k)
-                sum(k) += choleskyFactor(j, i) * x(j, k);
-        }
-        boost::numeric::ublas::row(x, i) = (boost::numeric::ublas::row(omega, i) - sum) / choleskyFactor(i, i);
-    }
     return x;
 }
 
+void Math::RegressionModelAlgorithmCholesky::solve(boost::numeric::ublas::matrix<double> &coefficients,
+                                                   const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                                                   const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    const boost::numeric::ublas::matrix<double> XtY(boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues),
+                                                                                dependentVariableValues));
+    coefficients = _choleskySolve(m_ch -> getFactor(), XtY);
+}
+
 bool Math::RegressionModelAlgorithmCholesky::hasFailed() const
 {
-    return m_ch.hasFailed();
+    return m_ch -> hasFailed();
 }
 
 boost::numeric::ublas::matrix<double> Math::RegressionModelAlgorithmCholesky::computeCoefficientCovarianceMatrix(
@@ -331,10 +503,72 @@ boost::numeric::ublas::matrix<double> Math::RegressionModelAlgorithmCholesky::co
 {
     const boost::numeric::ublas::matrix<double> sigmaSquaredI =
             residualVariance * boost::numeric::ublas::identity_matrix<double>(m_coefficients.size());
-    return _choleskySolve(m_ch.getCholeskyFactor(), sigmaSquaredI);
+    return _choleskySolve(m_ch -> getFactor(), sigmaSquaredI);
 }
 
 std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithmCholesky::clone() const
 {
     return std::make_unique<RegressionModelAlgorithmCholesky> (*this);
+}
+
+void Math::RegressionModelAlgorithmQR::calibrate(boost::numeric::ublas::vector<double> &coefficients,
+                                                 const Math::RegressionWorkspace &workspace) const
+{
+    // A fresh factor on every calibration, so algorithms still sharing the previous one are left untouched
+    const std::shared_ptr<Math::QRDecompose> qr = std::make_shared<Math::QRDecompose>();
+    qr -> decompose(workspace.getIndependentVariableValues());
+    m_qr = qr;
+    if (m_qr -> hasFailed())
+        return;
+
+    coefficients = m_qr -> solve(workspace.getDependentVariableValues());
+    m_coefficients = coefficients;
+    _storeSample(workspace);
+    if (!m_storeDesignMatrix)
+        qr -> releaseReflectors();
+}
+
+void Math::RegressionModelAlgorithmQR::solve(boost::numeric::ublas::matrix<double> &coefficients,
+                                             const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                                             const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    if (m_qr -> hasReflectors())
+    {
+        coefficients = m_qr -> solve(dependentVariableValues);
+        return;
+    }
+
+    // Only R is left: RtR x = XtY, then one refinement step on the residuals, which brings the error back to that of
+    // the QR solution for all but the worst conditioned designs
+    coefficients = m_qr -> solveRtR(boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues),
+                                                             dependentVariableValues));
+    const boost::numeric::ublas::matrix<double> residuals = dependentVariableValues -
+                                                            boost::numeric::ublas::prod(independentVariableValues, coefficients);
+    coefficients += m_qr -> solveRtR(boost::numeric::ublas::prod(boost::numeric::ublas::trans(independentVariableValues), residuals));
+}
+
+bool Math::RegressionModelAlgorithmQR::hasFailed() const
+{
+    return m_qr -> hasFailed();
+}
+
+bool Math::RegressionModelAlgorithmQR::isRankDeficient() const
+{
+    return m_qr -> isRankDeficient();
+}
+
+boost::numeric::ublas::matrix<double> Math::RegressionModelAlgorithmQR::computeCoefficientCovarianceMatrix(
+        double residualVariance) const
+{
+    return residualVariance * m_qr -> computeInverseRtR();
+}
+
+boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> Math::RegressionModelAlgorithmQR::getR() const
+{
+    return m_qr -> getR();
+}
+
+std::unique_ptr<Math::RegressionModelAlgorithm> Math::RegressionModelAlgorithmQR::clone() const
+{
+    return std::make_unique<RegressionModelAlgorithmQR> (*this);
 }
\ No newline at end of file
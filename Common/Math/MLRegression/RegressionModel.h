@@ -5,6 +5,7 @@
 #ifndef WILDCATSTKCORE_REGRESSIONMODEL_H
 #define WILDCATSTKCORE_REGRESSIONMODEL_H
 
+#include <memory>
 #include <boost/numeric/ublas/matrix.hpp>
 #include "../LinearAlgebra/MatrixDecompose.h"
 
@@ -12,6 +13,7 @@
 namespace Math
 {
     class RegressionModelAlgorithm;
+    class RegressionModelAlgorithmOLSChain;
 
     //
     // Regression ANOVA summary stat data structs (rvs to client code) and computation
@@ -43,6 +45,59 @@ namespace Math
         double adjRSquared;
     };
 
+    //
+    // Normal equations of a calibration sample, in O(k^2) memory whatever the sample size
+    //
+    struct RegressionSufficientStatistics
+    {
+        boost::numeric::ublas::matrix<double> XtX;
+        boost::numeric::ublas::vector<double> XtY;
+
+        void compute(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                     const boost::numeric::ublas::matrix<double> &independentVariableValues);
+    };
+
+    //
+    // Everything ANOVA needs from a calibrated sample. The sums are taken on the sample itself while it is available,
+    // not expanded around XtX and YtY afterwards: those expansions cancel as soon as the fit is good or the mean is
+    // large against the spread.
+    //
+    struct RegressionSumsOfSquares
+    {
+        double sampleSize;
+        double mean;
+        double total;       // |y - mean|^2
+        double model;       // |Xb - mean|^2
+        double residual;    // |y - Xb|^2
+
+        void compute(const boost::numeric::ublas::vector<double> &coefficients,
+                     const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                     const boost::numeric::ublas::matrix<double> &independentVariableValues);
+    };
+
+    //
+    // Calibration sample shared by the OLS chain links. The normal equations (XtX, XtY, ...) are computed the first
+    // time a link asks for them and reused by every link after it, so a spec falling through the chain forms them once.
+    // The sample is referenced, not copied: the workspace must not outlive the vector and matrix it was built on.
+    //
+    class RegressionWorkspace
+    {
+    public:
+        RegressionWorkspace(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                            const boost::numeric::ublas::matrix<double> &independentVariableValues);
+
+        const boost::numeric::ublas::vector<double>& getDependentVariableValues() const;
+        const boost::numeric::ublas::matrix<double>& getIndependentVariableValues() const;
+        const Math::RegressionSufficientStatistics& getStatistics() const;
+        bool hasStatistics() const;
+
+    private:
+        const boost::numeric::ublas::vector<double> &m_depVariableVals;
+        const boost::numeric::ublas::matrix<double> &m_indepVariableVals;
+        mutable Math::RegressionSufficientStatistics m_statistics;
+        mutable bool m_hasStatistics;
+    };
+
     class ANOVA
     {
     public:
@@ -51,6 +106,21 @@ namespace Math
                                         const boost::numeric::ublas::vector<double> &dependentVariableValues,
                                         const boost::numeric::ublas::matrix<double> &independentVariableValues,
                                         const Math::RegressionModelAlgorithm &reg) const;
+
+        // Same diagnostics from the sums of squares only, fittedValues and residuals are left empty
+        Math::ANOVASummary computeANOVA(const boost::numeric::ublas::vector<double> &coefficients,
+                                        const Math::RegressionSumsOfSquares &sumsOfSquares,
+                                        const Math::RegressionModelAlgorithm &reg) const;
+
+        void computeResiduals(Math::ANOVASummary &summary,
+                              const boost::numeric::ublas::vector<double> &coefficients,
+                              const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                              const boost::numeric::ublas::matrix<double> &independentVariableValues) const;
+
+    private:
+        void _computeCoefficientStatistics(Math::ANOVASummary &summary,
+                                           const boost::numeric::ublas::vector<double> &coefficients,
+                                           const Math::RegressionModelAlgorithm &reg) const;
     };
 
 
@@ -63,6 +133,12 @@ namespace Math
         virtual void calibrate(boost::numeric::ublas::vector<double> &coefficients,
                                const boost::numeric::ublas::vector<double> &dependentVariableValues,
                                const boost::numeric::ublas::matrix<double> &independentVariableValues) const = 0;
+        // One calibration per column of dependentVariableValues, all on the same design matrix: X is factorised once
+        // and models[j] is left as if calibrate had been run on it with column j (coefficients are column j too)
+        virtual void calibrate(boost::numeric::ublas::matrix<double> &coefficients,
+                               const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                               const boost::numeric::ublas::matrix<double> &independentVariableValues,
+                               const std::vector<Math::RegressionModel*> &models) const = 0;
         virtual Math::ANOVASummary getANOVA() const = 0;
 
         virtual std::unique_ptr<Math::RegressionModel> clone() const = 0;
@@ -70,22 +146,32 @@ namespace Math
         virtual ~RegressionModel() = default;
     };
 
+    //
+    // storeDesignMatrix = false keeps only the sums of squares (see RegressionSumsOfSquares) and a k x k factor after
+    // calibration, getANOVA then returns every diagnostic except fittedValues and residuals.
+    //
     class RegressionModelOLS : public RegressionModel
     {
     public:
-        RegressionModelOLS();
+        explicit RegressionModelOLS(bool storeDesignMatrix = true);
         RegressionModelOLS(const RegressionModelOLS& other);
         RegressionModelOLS& operator=(const RegressionModelOLS& other);
 
         void calibrate(boost::numeric::ublas::vector<double> &coefficients,
                        const boost::numeric::ublas::vector<double> &dependentVariableValues,
                        const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+        void calibrate(boost::numeric::ublas::matrix<double> &coefficients,
+                       const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                       const boost::numeric::ublas::matrix<double> &independentVariableValues,
+                       const std::vector<Math::RegressionModel*> &models) const final;
         Math::ANOVASummary getANOVA() const final;
 
         std::unique_ptr<Math::RegressionModel> clone() const final;
 
     private:
         mutable std::unique_ptr<Math::RegressionModelAlgorithm> m_algorithmPtr;
+        std::shared_ptr<const Math::RegressionModelAlgorithmOLSChain> m_chain;     // stateless, shared by copies
+        bool m_storeDesignMatrix;
     };
 
 
@@ -95,31 +181,49 @@ namespace Math
     class RegressionModelAlgorithmOLSChain
     {
     public:
-        RegressionModelAlgorithmOLSChain();
+        explicit RegressionModelAlgorithmOLSChain(bool storeDesignMatrix = true);
         virtual std::unique_ptr<Math::RegressionModelAlgorithm> handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                                       const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const;
+                                                                       const Math::RegressionWorkspace &workspace) const;
 
         void addLink(const std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> &link);
 
         virtual ~RegressionModelAlgorithmOLSChain() = default;
 
+    protected:
+        bool m_storeDesignMatrix;
+
     private:
         std::shared_ptr<Math::RegressionModelAlgorithmOLSChain> m_nextLink;
     };
 
+    class RegressionModelOLSLinkQR : public RegressionModelAlgorithmOLSChain
+    {
+    public:
+        using RegressionModelAlgorithmOLSChain::RegressionModelAlgorithmOLSChain;
+
+    private:
+        std::unique_ptr<Math::RegressionModelAlgorithm> handle(boost::numeric::ublas::vector<double> &coefficients,
+                                                               const Math::RegressionWorkspace &workspace) const final;
+    };
+
     class RegressionModelOLSLinkCholesky : public RegressionModelAlgorithmOLSChain
     {
+    public:
+        using RegressionModelAlgorithmOLSChain::RegressionModelAlgorithmOLSChain;
+
+    private:
         std::unique_ptr<Math::RegressionModelAlgorithm> handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                               const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+                                                               const Math::RegressionWorkspace &workspace) const final;
     };
 
     class RegressionModelOLSLinkMoorePenrose : public RegressionModelAlgorithmOLSChain
     {
+    public:
+        using RegressionModelAlgorithmOLSChain::RegressionModelAlgorithmOLSChain;
+
+    private:
         std::unique_ptr<Math::RegressionModelAlgorithm> handle(boost::numeric::ublas::vector<double> &coefficients,
-                                                               const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+                                                               const Math::RegressionWorkspace &workspace) const final;
     };
 
 
@@ -129,12 +233,32 @@ namespace Math
     class RegressionModelAlgorithm
     {
     public:
+        RegressionModelAlgorithm() = default;
+        RegressionModelAlgorithm(const RegressionModelAlgorithm&) = default;
+        RegressionModelAlgorithm(RegressionModelAlgorithm&&) = default;
+        RegressionModelAlgorithm& operator=(const RegressionModelAlgorithm&) = default;
+        RegressionModelAlgorithm& operator=(RegressionModelAlgorithm&&) = default;
+
+        void calibrate(boost::numeric::ublas::vector<double> &coefficients,
+                       const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const;
         virtual void calibrate(boost::numeric::ublas::vector<double> &coefficients,
-                               const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const = 0;
+                               const Math::RegressionWorkspace &workspace) const = 0;
+        // Solves the factor of the last calibration against several dependent variable columns of the same design matrix
+        virtual void solve(boost::numeric::ublas::matrix<double> &coefficients,
+                           const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                           const boost::numeric::ublas::matrix<double> &independentVariableValues) const = 0;
         virtual bool hasFailed() const = 0;
         virtual boost::numeric::ublas::matrix<double> computeCoefficientCovarianceMatrix(double residualVariance) const = 0;
         Math::ANOVASummary getANOVA() const;
+        void setStoreDesignMatrix(bool storeDesignMatrix);
+
+        // Copy holding the same factor, by reference rather than by value, with the coefficients and the sample of another
+        // dependent variable on the same design. Calibrating either afterwards gives it a factor of its own.
+        std::unique_ptr<Math::RegressionModelAlgorithm> share(const boost::numeric::ublas::vector<double> &coefficients,
+                                                              const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                                              const Math::RegressionWorkspace &design,
+                                                              bool storeDesignMatrix) const;
 
         virtual ~RegressionModelAlgorithm() = default;
 
@@ -143,22 +267,29 @@ namespace Math
     protected:
         mutable boost::numeric::ublas::vector<double> m_coefficients, m_depVariableVals;
         mutable boost::numeric::ublas::matrix<double> m_indepVariableVals;
+        mutable Math::RegressionSumsOfSquares m_sumsOfSquares;
+        bool m_storeDesignMatrix = true;
+
+        void _storeSample(const Math::RegressionWorkspace &workspace) const;
     };
 
     class RegressionModelAlgorithmMoorePenrose : public RegressionModelAlgorithm
     {
     public:
         RegressionModelAlgorithmMoorePenrose();
+        using RegressionModelAlgorithm::calibrate;
         void calibrate(boost::numeric::ublas::vector<double> &coefficients,
-                       const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+                       const Math::RegressionWorkspace &workspace) const final;
+        void solve(boost::numeric::ublas::matrix<double> &coefficients,
+                   const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                   const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
         bool hasFailed() const final;
         boost::numeric::ublas::matrix<double> computeCoefficientCovarianceMatrix(double residualVariance) const final;
 
         std::unique_ptr<Math::RegressionModelAlgorithm> clone() const final;
 
     private:
-        mutable boost::numeric::ublas::matrix<double> m_invXtX;
+        mutable std::shared_ptr<const boost::numeric::ublas::matrix<double>> m_invXtX;
         mutable bool m_isInvertible;
 
         void _computeInverseByLUFactorization(boost::numeric::ublas::matrix<double> M,
@@ -168,23 +299,51 @@ namespace Math
     class RegressionModelAlgorithmCholesky : public RegressionModelAlgorithm
     {
     public:
+        using RegressionModelAlgorithm::calibrate;
         void calibrate(boost::numeric::ublas::vector<double> &coefficients,
-                       const boost::numeric::ublas::vector<double> &dependentVariableValues,
-                       const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+                       const Math::RegressionWorkspace &workspace) const final;
+        void solve(boost::numeric::ublas::matrix<double> &coefficients,
+                   const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                   const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
         bool hasFailed() const final;
         boost::numeric::ublas::matrix<double> computeCoefficientCovarianceMatrix(double residualVariance) const final;
 
         std::unique_ptr<Math::RegressionModelAlgorithm> clone() const final;
 
     private:
-        mutable Math::CholeskyDecompose m_ch;
+        mutable std::shared_ptr<const Math::CholeskyDecompose> m_ch = std::make_shared<const Math::CholeskyDecompose>();
 
-        boost::numeric::ublas::vector<double> _choleskySolve(const boost::numeric::ublas::matrix<double> &choleskyFactor,
+        boost::numeric::ublas::vector<double> _choleskySolve(const std::vector<double> &choleskyFactor,
                                                              const boost::numeric::ublas::vector<double> &rhs) const;
-        boost::numeric::ublas::matrix<double> _choleskySolve(const boost::numeric::ublas::matrix<double> &choleskyFactor,
+        boost::numeric::ublas::matrix<double> _choleskySolve(const std::vector<double> &choleskyFactor,
                                                              const boost::numeric::ublas::matrix<double> &rhs) const;
     };
 
+    //
+    // Least squares on the design matrix itself, without forming XtX: conditioning is that of X rather than its
+    // square, and the coefficient covariance comes from R as residualVariance * (RtR)^-1. With storeDesignMatrix = false
+    // only R is kept after calibration, solve then runs the corrected semi-normal equations on the design it is given.
+    //
+    class RegressionModelAlgorithmQR : public RegressionModelAlgorithm
+    {
+    public:
+        using RegressionModelAlgorithm::calibrate;
+        void calibrate(boost::numeric::ublas::vector<double> &coefficients,
+                       const Math::RegressionWorkspace &workspace) const final;
+        void solve(boost::numeric::ublas::matrix<double> &coefficients,
+                   const boost::numeric::ublas::matrix<double> &dependentVariableValues,
+                   const boost::numeric::ublas::matrix<double> &independentVariableValues) const final;
+        bool hasFailed() const final;
+        bool isRankDeficient() const;
+        boost::numeric::ublas::matrix<double> computeCoefficientCovarianceMatrix(double residualVariance) const final;
+        boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> getR() const;
+
+        std::unique_ptr<Math::RegressionModelAlgorithm> clone() const final;
+
+    private:
+        mutable std::shared_ptr<const Math::QRDecompose> m_qr = std::make_shared<const Math::QRDecompose>();
+    };
+
 
 }
 #endif //WILDCATSTKCORE_REGRESSIONMODEL_H
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "RollingRegression.h"
+#include "../LinearAlgebra/MatrixDecompose.h"
+
+namespace
+{
+    // The factor carried across windows is that of the augmented Gram matrix [X y]t[X y], column-major over
+    // dim = k + 1: its leading k x k block is the factor L of XtX, the last row is (L^-1 XtY, sqrt(RSS)). The residual sum
+    // of squares is thus read from the factor rather than recovered as YtY - btXtY. The last pivot is zero for a
+    // perfect fit, so windows are moved with the raw factor rotations of CholeskyDecompose, which allow it.
+
+    // Factor of the rows first..last taken from the rows themselves by Householder QR, L = Rt with a positive
+    // diagonal. False when the independent variables of the window are rank deficient.
+    bool factorise(std::vector<double> &L, unsigned long dim, const boost::numeric::ublas::vector<double> &Y,
+                   const boost::numeric::ublas::matrix<double> &X, unsigned long first, unsigned long last)
+    {
+        boost::numeric::ublas::matrix<double> A(last - first + 1, dim);
+        for (unsigned long row = first; row <= last; ++row)
+        {
+            for (unsigned long j = 0; j + 1 < dim; ++j)
+                A(row - first, j) = X(row, j);
+            A(row - first, dim - 1) = Y(row);
+        }
+
+        Math::QRDecompose qr;
+        qr.decompose(A);
+        const boost::numeric::ublas::triangular_matrix<double, boost::numeric::ublas::upper> R = qr.getR();
+
+        double maxDiagonal = 0;
+        for (unsigned long j = 0; j + 1 < dim; ++j)
+            maxDiagonal = std::max(maxDiagonal, std::abs(R(j, j)));
+        const double tolerance = A.size1() * std::numeric_limits<double>::epsilon() * maxDiagonal;
+
+        L.assign(dim * dim, 0);
+        for (unsigned long i = 0; i < dim; ++i)
+        {
+            if (i + 1 < dim and !(std::abs(R(i, i)) > tolerance))
+                return false;
+
+            const double sign = R(i, i) < 0 ? -1. : 1.;
+            for (unsigned long j = i; j < dim; ++j)
+                L[j + i * dim] = sign * R(i, j);
+        }
+        return true;
+    }
+
+    // diag((L Lt)^-1) for the leading k x k block of a column-major factor, the squared norms of the columns of L^-1
+    std::vector<double> inverseDiagonal(const std::vector<double> &L, unsigned long k, unsigned long dim)
+    {
+        std::vector<double> rv(k), z(k);
+        for (unsigned long j = 0; j < k; ++j)
+        {
+            double sum = 0;
+            for (unsigned long i = j; i < k; ++i)
+            {
+                double value = i == j ? 1. : 0.;
+                for (unsigned long p = j; p < i; ++p)
+                    value -= L[i + p * dim] * z[p];
+                z[i] = value / L[i + i * dim];
+                sum += z[i] * z[i];
+            }
+            rv[j] = sum;
+        }
+        return rv;
+    }
+}
+
+Math::RollingRegression::RollingRegression(unsigned long window, bool isExpanding, unsigned long refactorInterval) :
+    m_window(window), m_isExpanding(isExpanding), m_refactorInterval(refactorInterval)
+{
+
+}
+
+Math::RollingRegressionPath Math::RollingRegression::calibrate(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                                               const boost::numeric::ublas::matrix<double> &independentVariableValues) const
+{
+    const unsigned long nRows = independentVariableValues.size1(), nCols = independentVariableValues.size2();
+    if (dependentVariableValues.size() != nRows)
+        throw std::runtime_error("Math::RollingRegression::calibrate : dependent and independent variables have different sizes.");
+    if (m_window <= nCols or m_window > nRows)
+        throw std::runtime_error("Math::RollingRegression::calibrate : window must exceed the number of coefficients "
+                                 "and fit in the sample.");
+    if (m_refactorInterval == 0)
+        throw std::runtime_error("Math::RollingRegression::calibrate : refactorisation interval must be positive.");
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const unsigned long nWindows = nRows - m_window + 1, dim = nCols + 1;
+    Math::RollingRegressionPath rv;
+    rv.coefficients.resize(nWindows, nCols, false), rv.stdErrs.resize(nWindows, nCols, false);
+    rv.lastObservations.reserve(nWindows), rv.residualMSEVariance.reserve(nWindows);
+
+    // Rows with a non finite value are never rotated into the factor, the windows holding them are skipped
+    std::vector<bool> isFinite(nRows, true);
+    for (unsigned long row = 0; row < nRows; ++row)
+    {
+        isFinite[row] = std::isfinite(dependentVariableValues(row));
+        for (unsigned long j = 0; j < nCols; ++j)
+            isFinite[row] = isFinite[row] and std::isfinite(independentVariableValues(row, j));
+    }
+
+    std::vector<double> L, z(dim);
+    const auto augmentedRow = [&](unsigned long row) -> const std::vector<double>&
+    {
+        for (unsigned long j = 0; j < nCols; ++j)
+            z[j] = independentVariableValues(row, j);
+        z[nCols] = dependentVariableValues(row);
+        return z;
+    };
+
+    bool isCarried = false;
+    unsigned long nonFinite = 0, sinceFactorised = 0;
+    for (unsigned long row = 0; row + 1 < m_window; ++row)
+        nonFinite += !isFinite[row];
+
+    for (unsigned long last = m_window - 1; last < nRows; ++last)
+    {
+        const unsigned long first = m_isExpanding ? 0 : last + 1 - m_window;
+        nonFinite += !isFinite[last];
+        if (!m_isExpanding and last >= m_window)
+            nonFinite -= !isFinite[last - m_window];
+
+        const unsigned long w = rv.lastObservations.size();
+        rv.lastObservations.push_back(last);
+
+        // Carried by one update and one downdate, and rebuilt from the window rows every refactorInterval windows to
+        // bound the drift of the rotations, or whenever a downdate fails
+        if (nonFinite == 0 and isCarried and sinceFactorised < m_refactorInterval)
+        {
+            Math::CholeskyDecompose::updateFactor(L, dim, augmentedRow(last));
+            if (!m_isExpanding)
+                isCarried = Math::CholeskyDecompose::downdateFactor(L, dim, augmentedRow(last - m_window));
+        }
+        else
+            isCarried = false;
+
+        if (nonFinite == 0 and !isCarried)
+            isCarried = factorise(L, dim, dependentVariableValues, independentVariableValues, first, last), sinceFactorised = 0;
+        ++sinceFactorised;
+
+        if (nonFinite > 0 or !isCarried)
+        {
+            for (unsigned long j = 0; j < nCols; ++j)
+                rv.coefficients(w, j) = rv.stdErrs(w, j) = nan;
+            rv.residualMSEVariance.push_back(nan);
+            continue;
+        }
+
+        // Lt b = L^-1 XtY by back substitution, the right hand side being the last row of the factor
+        std::vector<double> beta(nCols);
+        for (long i = nCols - 1; i >= 0; --i)
+        {
+            double sum = L[nCols + i * dim];
+            for (unsigned long j = i + 1; j < nCols; ++j)
+                sum -= L[j + i * dim] * beta[j];
+            beta[i] = sum / L[i + i * dim];
+        }
+
+        const double sampleSize = last - first + 1;
+        const double rss = L[nCols + nCols * dim] * L[nCols + nCols * dim];
+        const double residualVariance = rss / (sampleSize - nCols);
+        const std::vector<double> diagonal = inverseDiagonal(L, nCols, dim);
+        for (unsigned long j = 0; j < nCols; ++j)
+        {
+            rv.coefficients(w, j) = beta[j];
+            rv.stdErrs(w, j) = std::sqrt(residualVariance * diagonal[j]);
+        }
+        rv.residualMSEVariance.push_back(residualVariance);
+    }
+
+    return rv;
+}
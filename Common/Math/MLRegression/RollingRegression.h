@@ -0,0 +1,45 @@
+#ifndef WILDCATSTKCORE_ROLLINGREGRESSION_H
+#define WILDCATSTKCORE_ROLLINGREGRESSION_H
+
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+
+
+namespace Math
+{
+    //
+    // Coefficient paths, one row per window, in the column order of the design matrix
+    //
+    struct RollingRegressionPath
+    {
+        std::vector<unsigned long> lastObservations;    // sample row of the last observation in each window
+        boost::numeric::ublas::matrix<double> coefficients;
+        boost::numeric::ublas::matrix<double> stdErrs;
+        std::vector<double> residualMSEVariance;
+    };
+
+    //
+    // OLS over every window of window consecutive rows (rolling) or over every leading sample of at least window rows
+    // (expanding). The Cholesky factor of the augmented matrix [X y]t[X y] is carried from one window to the next with a
+    // rank-1 update for the row entering and a downdate for the row leaving, so coefficients and the residual sum of
+    // squares cost O(k^2) per window instead of O(nk^2); standard errors add one triangular inversion, O(k^3 / 6). Every
+    // refactorInterval windows, and whenever a downdate fails, the factor is rebuilt by QR of the window rows, which
+    // bounds the drift of the updates. Windows with a rank deficient X, or holding a row with a non finite value, get
+    // NaN coefficients and standard errors; the windows after them are unaffected.
+    //
+    class RollingRegression
+    {
+    public:
+        explicit RollingRegression(unsigned long window, bool isExpanding = false, unsigned long refactorInterval = 64);
+
+        Math::RollingRegressionPath calibrate(const boost::numeric::ublas::vector<double> &dependentVariableValues,
+                                              const boost::numeric::ublas::matrix<double> &independentVariableValues) const;
+
+    private:
+        unsigned long m_window;
+        bool m_isExpanding;
+        unsigned long m_refactorInterval;
+    };
+}
+
+#endif //WILDCATSTKCORE_ROLLINGREGRESSION_H
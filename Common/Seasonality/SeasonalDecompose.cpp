@@ -2,6 +2,7 @@
 // Created by Alberto Campi on 2019-08-27.
 //
 
+#include <utility>
 #include "SeasonalDecompose.h"
 #include "../Math/Statistics/Stat.h"
 
@@ -39,7 +40,7 @@ Common::TimeSeries Common::SeasonalDecomposeConvolution::getNoise() const
 
 void Common::SeasonalDecomposeConvolution::decompose(const Common::TimeSeries &ts)
 {
-    if (ts.getValues().size() < 2 * getPeriod())
+    if (ts.length() < 2 * getPeriod())
         throw std::runtime_error("Common::SeasonalDecomposeConvolution::decompose : data should cover at least two seasonal cycles");
 
     _extractTrend(ts);
@@ -47,7 +48,7 @@ void Common::SeasonalDecomposeConvolution::decompose(const Common::TimeSeries &t
 
     _extractSeason(deTrended);
     const Common::TimeSeries noise = _extractNoise(ts);
-    m_noise.set(ts.getName() + Common::SeasonalDecompose::noiseNamePostfix, noise.getValues(), noise.getDates());
+    m_noise = Common::TimeSeries(ts.getName() + Common::SeasonalDecompose::noiseNamePostfix, noise);
 }
 
 void Common::SeasonalDecomposeConvolution::_extractTrend(const Common::TimeSeries &ts)
@@ -87,7 +88,7 @@ void Common::SeasonalDecomposeConvolution::_extractTrend(const Common::TimeSerie
     }
 
     headExtrapolation.insert(headExtrapolation.end(), trend.begin(), trend.end());
-    m_trend.set(ts.getName() + SeasonalDecompose::trendNamePostfix, headExtrapolation, ts.getDates());
+    m_trend = Common::TimeSeries(ts.getName() + SeasonalDecompose::trendNamePostfix, std::move(headExtrapolation), ts.getCalendar());
 }
 
 void Common::SeasonalDecomposeConvolution::_extractSeason(const Common::TimeSeries &ts)
@@ -108,7 +109,7 @@ void Common::SeasonalDecomposeConvolution::_extractSeason(const Common::TimeSeri
         counters.at(index) += 1;
     }
 
-    std::vector<double> seasonality(ts.getValues().size());
+    std::vector<double> seasonality(ts.length());
     for (unsigned long i = 0; i < ts.length(); ++i)
     {
         unsigned long index;
@@ -120,7 +121,7 @@ void Common::SeasonalDecomposeConvolution::_extractSeason(const Common::TimeSeri
         seasonality.at(i) = accumulators.at(index) / counters.at(index);
     }
 
-    m_season.set(ts.getName() + SeasonalDecompose::seasonNamePostfix, seasonality, ts.getDates());
+    m_season = Common::TimeSeries(ts.getName() + SeasonalDecompose::seasonNamePostfix, std::move(seasonality), ts.getCalendar());
 }
 /*
 unsigned int Common::SeasonalDecomposeConvolution::_getPeriod() const
@@ -6,6 +6,7 @@
 #define WILDCATSTKCORE_SEASONALDECOMPOSE_H
 
 #include <vector>
+#include <memory>
 #include "../Types/TimeSeries.h"
 
 
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <stdexcept>
+#include "AlignedColumns.h"
+#include "TimeSeries.h"
+
+Common::AlignedColumns::AlignedColumns(const std::vector<const Common::TimeSeries*>& series) :
+    m_columns(series.size())
+{
+    if (series.empty())
+        throw std::runtime_error("E: AlignedColumns::AlignedColumns : no series to take dates from.");
+
+    const std::shared_ptr<const Common::Calendar>& first = series.front() -> getCalendarRef();
+    const bool isAligned = std::all_of(series.begin(), series.end(), [&first](const Common::TimeSeries* ts)
+    { return ts -> getCalendarRef() == first or *ts -> getCalendarRef() == *first; });
+
+    if (isAligned)
+    {
+        for (std::size_t i = 0; i < series.size(); ++i)
+            m_columns[i] = series[i] -> getValuesView().begin();
+        m_calendar = first;
+        return;
+    }
+
+    std::vector<boost::gregorian::date> dates;
+    for (const auto& it: first -> getDatesView())
+        if (std::all_of(series.begin() + 1, series.end(), [&it](const Common::TimeSeries* ts) { return ts -> hasDate(it); }))
+            dates.push_back(it);
+
+    m_gathered.resize(series.size());
+    for (std::size_t i = 0; i < series.size(); ++i)
+    {
+        m_gathered[i].reserve(dates.size());
+        for (const auto& it: dates)
+            m_gathered[i].push_back(series[i] -> getValue(it));
+        m_columns[i] = m_gathered[i].data();
+    }
+    m_calendar = std::make_shared<const Common::Calendar>(std::move(dates));
+}
+
+std::size_t Common::AlignedColumns::getRowCount() const
+{
+    return m_calendar -> size();
+}
+
+std::size_t Common::AlignedColumns::getColumnCount() const
+{
+    return m_columns.size();
+}
+
+const double* Common::AlignedColumns::getColumn(std::size_t column) const
+{
+    if (column >= m_columns.size())
+        throw std::out_of_range("E: AlignedColumns::getColumn : column " + std::to_string(column) + " out of range.");
+
+    return m_columns[column];
+}
+
+const double* const* Common::AlignedColumns::getColumns() const
+{
+    return m_columns.data();
+}
+
+std::shared_ptr<const Common::Calendar> Common::AlignedColumns::getCalendar() const
+{
+    return m_calendar;
+}
@@ -0,0 +1,35 @@
+#ifndef WILDCATSTKCORE_ALIGNEDCOLUMNS_H
+#define WILDCATSTKCORE_ALIGNEDCOLUMNS_H
+
+#include <memory>
+#include <vector>
+#include "Calendar.h"
+
+namespace Common
+{
+    class TimeSeries;
+
+    //
+    // Values of several series lined up row by row on the dates they all have, which is how every formula evaluator
+    // aligns its inputs. Series sharing one calendar are read in place. Otherwise the common dates are taken in the
+    // order of the first series and the values gathered on them are owned by the object.
+    //
+    class AlignedColumns
+    {
+    public:
+        explicit AlignedColumns(const std::vector<const Common::TimeSeries*>& series);
+
+        std::size_t getRowCount() const;
+        std::size_t getColumnCount() const;
+        const double* getColumn(std::size_t column) const;
+        const double* const* getColumns() const;
+        std::shared_ptr<const Common::Calendar> getCalendar() const;
+
+    private:
+        std::shared_ptr<const Common::Calendar> m_calendar;
+        std::vector<const double*> m_columns;
+        std::vector<std::vector<double>> m_gathered;
+    };
+}
+
+#endif //WILDCATSTKCORE_ALIGNEDCOLUMNS_H
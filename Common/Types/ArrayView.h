@@ -0,0 +1,64 @@
+#ifndef WILDCATSTKCORE_ARRAYVIEW_H
+#define WILDCATSTKCORE_ARRAYVIEW_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+namespace Common
+{
+    //
+    // Non-owning, read-only pointer+length view over contiguous storage. Views do not extend the lifetime of the
+    // underlying buffer: they are invalidated by any mutation (e.g. pushBack) or destruction of the owning object.
+    //
+    template <typename T>
+    class ArrayView
+    {
+    public:
+        using value_type = T;
+        using const_iterator = const T*;
+
+        ArrayView() : m_data(nullptr), m_size(0) {}
+        ArrayView(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+        ArrayView(const std::vector<T>& other) : m_data(other.data()), m_size(other.size()) {}
+
+        const T* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+        const T& operator[](std::size_t index) const { return m_data[index]; }
+        const T& at(std::size_t index) const
+        {
+            if (index < m_size)
+                return m_data[index];
+            else
+                throw std::out_of_range("E: Common::ArrayView::at : index " + std::to_string(index) + " is not in range.");
+        }
+
+        const T& front() const { return m_data[0]; }
+        const T& back() const { return m_data[m_size - 1]; }
+
+        ArrayView<T> subView(std::size_t offset, std::size_t count) const
+        {
+            if (offset > m_size or count > m_size - offset)
+                throw std::out_of_range("E: Common::ArrayView::subView : requested range is not in range.");
+            return ArrayView<T>(m_data + offset, count);
+        }
+
+        std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+    private:
+        const T* m_data;
+        std::size_t m_size;
+    };
+
+    using ValuesView = ArrayView<double>;
+    using DatesView = ArrayView<boost::gregorian::date>;
+}
+
+#endif //WILDCATSTKCORE_ARRAYVIEW_H
@@ -0,0 +1,62 @@
+#include <functional>
+#include <utility>
+#include "Calendar.h"
+
+Common::Calendar::Calendar(std::vector<boost::gregorian::date> dates) : m_dates(std::move(dates))
+{
+    m_dateIndex.rebuild(m_dates);
+}
+
+std::vector<boost::gregorian::date> Common::Calendar::getDates() const
+{
+    return m_dates;
+}
+
+Common::DatesView Common::Calendar::getDatesView() const
+{
+    return Common::DatesView(m_dates);
+}
+
+std::size_t Common::Calendar::size() const
+{
+    return m_dates.size();
+}
+
+bool Common::Calendar::empty() const
+{
+    return m_dates.empty();
+}
+
+std::size_t Common::Calendar::find(const boost::gregorian::date &date) const
+{
+    return m_dateIndex.find(m_dates, date);
+}
+
+Common::DateIndex::Frequency Common::Calendar::getFrequency() const
+{
+    return m_dateIndex.getFrequency();
+}
+
+std::size_t Common::Calendar::hash() const
+{
+    std::size_t rv = m_dates.size();
+    for (const auto& it: m_dates)
+        rv ^= std::hash<long>()(it.day_number()) + 0x9e3779b97f4a7c15ull + (rv << 6) + (rv >> 2);
+    return rv;
+}
+
+void Common::Calendar::append(const boost::gregorian::date &date)
+{
+    m_dates.push_back(date);
+    m_dateIndex.append(m_dates);
+}
+
+bool Common::Calendar::operator==(const Common::Calendar &other) const
+{
+    return this == &other or m_dates == other.m_dates;
+}
+
+bool Common::Calendar::operator!=(const Common::Calendar &other) const
+{
+    return !(*this == other);
+}
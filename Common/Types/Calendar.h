@@ -0,0 +1,42 @@
+#ifndef WILDCATSTKCORE_CALENDAR_H
+#define WILDCATSTKCORE_CALENDAR_H
+
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "ArrayView.h"
+#include "DateIndex.h"
+
+namespace Common
+{
+    //
+    // Ordered sequence of observation dates plus its date index. Calendars are shared (reference counted) between
+    // all the TimeSeries and DataPanel columns observed on the same dates, so dates are stored once per data set
+    // rather than once per variable.
+    //
+    class Calendar
+    {
+    public:
+        Calendar() = default;
+        explicit Calendar(std::vector<boost::gregorian::date> dates);
+
+        std::vector<boost::gregorian::date> getDates() const;
+        Common::DatesView getDatesView() const;
+        std::size_t size() const;
+        bool empty() const;
+
+        std::size_t find(const boost::gregorian::date &date) const;
+        Common::DateIndex::Frequency getFrequency() const;
+        std::size_t hash() const;
+
+        void append(const boost::gregorian::date &date);
+
+        bool operator==(const Common::Calendar &other) const;
+        bool operator!=(const Common::Calendar &other) const;
+
+    private:
+        std::vector<boost::gregorian::date> m_dates;
+        Common::DateIndex m_dateIndex;
+    };
+}
+
+#endif //WILDCATSTKCORE_CALENDAR_H
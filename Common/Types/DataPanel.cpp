@@ -0,0 +1,127 @@
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "DataPanel.h"
+
+using namespace Common;
+
+DataPanel::DataPanel() : m_calendar(std::make_shared<Common::Calendar>())
+{
+
+}
+
+DataPanel::DataPanel(std::shared_ptr<const Common::Calendar> calendar) : m_calendar(std::move(calendar))
+{
+    if (!m_calendar)
+        throw std::runtime_error("E: DataPanel::DataPanel : DataPanel object cannot be constructed on a null calendar.");
+}
+
+DataPanel::ColumnHandle DataPanel::addColumn(const std::string &variableName, const Common::ValuesView &values)
+{
+    if (values.size() != m_calendar->size())
+        throw std::runtime_error("E: DataPanel::addColumn : values of " + variableName + " do not match the panel calendar size.");
+    if (hasColumn(variableName))
+        throw std::runtime_error("E: DataPanel::addColumn : variable " + variableName + " is already in the panel.");
+
+    const ColumnHandle column = m_columnNames.size();
+    m_values.insert(m_values.end(), values.begin(), values.end());
+    m_columnNames.push_back(variableName);
+    m_columnHandles.emplace(variableName, column);
+    return column;
+}
+
+DataPanel::ColumnHandle DataPanel::addColumn(const Common::TimeSeries &ts)
+{
+    if (*ts.getCalendar() == *m_calendar)
+        return addColumn(ts.getName(), ts.getValuesView());
+
+    // Align on the panel calendar, observations outside of it are dropped and gaps are left as NaN
+    std::vector<double> aligned(m_calendar->size(), std::numeric_limits<double>::quiet_NaN());
+    const Common::DatesView dates = ts.getDatesView();
+    const Common::ValuesView values = ts.getValuesView();
+    for (std::size_t i = 0; i < dates.size(); ++i)
+    {
+        const std::size_t row = m_calendar->find(dates[i]);
+        if (row != Common::DateIndex::npos)
+            aligned[row] = values[i];
+    }
+
+    return addColumn(ts.getName(), Common::ValuesView(aligned));
+}
+
+bool DataPanel::hasColumn(const std::string &variableName) const
+{
+    return m_columnHandles.find(variableName) != m_columnHandles.end();
+}
+
+DataPanel::ColumnHandle DataPanel::getColumnHandle(const std::string &variableName) const
+{
+    const auto it = m_columnHandles.find(variableName);
+    if (it != m_columnHandles.end())
+        return it -> second;
+    throw std::runtime_error("E: DataPanel::getColumnHandle : variable " + variableName + " is not in the panel.");
+}
+
+std::string DataPanel::getColumnName(ColumnHandle column) const
+{
+    _checkColumn(column, "getColumnName");
+    return m_columnNames[column];
+}
+
+std::vector<std::string> DataPanel::getColumnNames() const
+{
+    return m_columnNames;
+}
+
+std::size_t DataPanel::getRowCount() const
+{
+    return m_calendar->size();
+}
+
+std::size_t DataPanel::getColumnCount() const
+{
+    return m_columnNames.size();
+}
+
+std::size_t DataPanel::getRow(const boost::gregorian::date &date) const
+{
+    const std::size_t row = m_calendar->find(date);
+    if (row != Common::DateIndex::npos)
+        return row;
+    throw std::out_of_range("E: DataPanel::getRow : date " + boost::gregorian::to_simple_string(date) + " is not in range.");
+}
+
+Common::ValuesView DataPanel::getColumn(ColumnHandle column) const
+{
+    _checkColumn(column, "getColumn");
+    return Common::ValuesView(m_values.data() + column * getRowCount(), getRowCount());
+}
+
+double DataPanel::getValue(ColumnHandle column, std::size_t row) const
+{
+    _checkColumn(column, "getValue");
+    if (row >= getRowCount())
+        throw std::out_of_range("E: DataPanel::getValue : row " + std::to_string(row) + " is not in range.");
+    return m_values[column * getRowCount() + row];
+}
+
+const double* DataPanel::data() const
+{
+    return m_values.data();
+}
+
+std::shared_ptr<const Common::Calendar> DataPanel::getCalendar() const
+{
+    return m_calendar;
+}
+
+Common::TimeSeries DataPanel::getTimeSeries(ColumnHandle column) const
+{
+    return Common::TimeSeries(getColumnName(column), getColumn(column).toVector(), m_calendar);
+}
+
+void DataPanel::_checkColumn(ColumnHandle column, const std::string &method) const
+{
+    if (column >= m_columnNames.size())
+        throw std::out_of_range("E: DataPanel::" + method + " : column " + std::to_string(column) + " is not in range.");
+}
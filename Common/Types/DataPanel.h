@@ -0,0 +1,57 @@
+#ifndef WILDCATSTKCORE_DATAPANEL_H
+#define WILDCATSTKCORE_DATAPANEL_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "ArrayView.h"
+#include "Calendar.h"
+#include "TimeSeries.h"
+
+namespace Common
+{
+    //
+    // Aligned panel of variables observed on one shared calendar. Values are stored column-major in a single
+    // contiguous buffer, so each variable is a contiguous column addressed by a handle and a row resolved once from
+    // a date serves every variable. Observations missing from a variable are stored as quiet NaN.
+    //
+    class DataPanel
+    {
+    public:
+        typedef std::size_t ColumnHandle;
+
+        DataPanel();
+        explicit DataPanel(std::shared_ptr<const Common::Calendar> calendar);
+
+        ColumnHandle addColumn(const std::string& variableName, const Common::ValuesView& values);
+        ColumnHandle addColumn(const Common::TimeSeries& ts);
+
+        bool hasColumn(const std::string& variableName) const;
+        ColumnHandle getColumnHandle(const std::string& variableName) const;
+        std::string getColumnName(ColumnHandle column) const;
+        std::vector<std::string> getColumnNames() const;
+
+        std::size_t getRowCount() const;
+        std::size_t getColumnCount() const;
+        std::size_t getRow(const boost::gregorian::date& date) const;
+
+        Common::ValuesView getColumn(ColumnHandle column) const;
+        double getValue(ColumnHandle column, std::size_t row) const;
+        const double* data() const;
+
+        std::shared_ptr<const Common::Calendar> getCalendar() const;
+        Common::TimeSeries getTimeSeries(ColumnHandle column) const;
+
+    private:
+        std::shared_ptr<const Common::Calendar> m_calendar;
+        std::vector<double> m_values;
+        std::vector<std::string> m_columnNames;
+        std::unordered_map<std::string, ColumnHandle> m_columnHandles;
+
+        void _checkColumn(ColumnHandle column, const std::string& method) const;
+    };
+}
+
+#endif //WILDCATSTKCORE_DATAPANEL_H
@@ -2,6 +2,7 @@
 // Created by Alberto Campi on 27/07/2019.
 //
 
+#include <set>
 #include "DataSet.h"
 #include "TimeSeries.h"
 
@@ -11,11 +12,33 @@ Common::DataSet::DataSet(const std::vector<Common::TimeSeries> &ts)
 {
     for (const auto& el: ts)
     {
-        m_data.emplace(el.getName(), el);
+        const auto it = m_data.emplace(el.getName(), el);
+        if (it.second)
+        {
+            _shareCalendar(it.first -> second);
+            _index(it.first -> first, &it.first -> second);
+        }
+    }
+}
+
+Common::DataSet::DataSet(const Common::DataSet &other) : m_data(other.m_data), m_calendars(other.m_calendars)
+{
+    _rebuildIndex();
+}
+
+Common::DataSet& Common::DataSet::operator=(const Common::DataSet &other)
+{
+    if (&other != this)
+    {
+        m_data = other.m_data;
+        m_calendars = other.m_calendars;
+        _rebuildIndex();
     }
+
+    return *this;
 }
 
-std::unordered_map<std::string, Common::TimeSeries> Common::DataSet::getData() const
+const std::unordered_map<std::string, Common::TimeSeries>& Common::DataSet::getData() const
 {
     return m_data;
 }
@@ -24,13 +47,18 @@ void Common::DataSet::addData(const Common::TimeSeries &otherTs)
 {
     //[AC] if logic gets used frequently in critical way consider storing mapping at construction stage
     const std::string key = otherTs.getName();
-    if (m_data.find(key) == m_data.end())
-        m_data.emplace(key, otherTs);
+    auto it = m_data.find(key);
+    if (it == m_data.end())
+    {
+        it = m_data.emplace(key, otherTs).first;
+        _index(key, &it -> second);
+    }
     else    //[AC] are we sure we want to allow this? Flagging a warning for now, it may be an error in the future.
     {
-        m_data.at(key) = otherTs;
+        it -> second = otherTs;
         std::cerr << "W: Common::DataSet::addData : existing data set values for variable " << key << " is being replaced." << std::endl;
     }
+    _shareCalendar(it -> second);
 }
 
 void Common::DataSet::appendValue(const std::string &variableName, const boost::gregorian::date &date, double value)
@@ -40,34 +68,106 @@ void Common::DataSet::appendValue(const std::string &variableName, const boost::
 
 void Common::DataSet::removeData(const std::string &variableName)
 {
-    m_data.erase(variableName);
+    if (m_data.erase(variableName) > 0)
+        _index(variableName, nullptr);
 }
 
 void Common::DataSet::clearAllData()
 {
     m_data.clear();
+    m_calendars.clear();
+    m_dataById.clear();
 }
 
 double Common::DataSet::getValue(const std::string &variableName, unsigned int index) const
 {
-    if (m_data.find(variableName) != m_data.end())
-        return m_data.at(variableName).getValue(index);
+    const auto it = m_data.find(variableName);
+    if (it != m_data.end())
+        return it -> second.getValue(index);
     else
         throw std::runtime_error("E: DataSet::getValue : variable " + variableName + " is not in the data set.");
 }
 
 double Common::DataSet::getValue(const std::string &variableName, const boost::gregorian::date &date) const
 {
-    if (m_data.find(variableName) != m_data.end())
-        return m_data.at(variableName).getValue(date);
+    const auto it = m_data.find(variableName);
+    if (it != m_data.end())
+        return it -> second.getValue(date);
     throw std::runtime_error("E: DataSet::getValue : variable " + variableName + " is not in the data set.");
 }
 
 Common::TimeSeries Common::DataSet::getTimeSeries(const std::string &variableName) const
 {
-    if (m_data.find(variableName) != m_data.end())
-        return m_data.at(variableName);
-    throw std::runtime_error("E: DataSet::getValue : variable " + variableName + " is not in the data set.");
+    return getTimeSeriesRef(variableName);
+}
+
+const Common::TimeSeries& Common::DataSet::getTimeSeriesRef(const std::string &variableName) const
+{
+    // Reference is invalidated by removeData/clearAllData on the same variable, do not hold on to it
+    const auto it = m_data.find(variableName);
+    if (it != m_data.end())
+        return it -> second;
+    throw std::runtime_error("E: DataSet::getTimeSeries : variable " + variableName + " is not in the data set.");
+}
+
+bool Common::DataSet::hasVariable(Global::VariableId variableId) const
+{
+    return variableId < m_dataById.size() and m_dataById[variableId] != nullptr;
+}
+
+double Common::DataSet::getValue(Global::VariableId variableId, unsigned int index) const
+{
+    return getTimeSeriesRef(variableId).getValue(index);
+}
+
+double Common::DataSet::getValue(Global::VariableId variableId, const boost::gregorian::date &date) const
+{
+    return getTimeSeriesRef(variableId).getValue(date);
+}
+
+const Common::TimeSeries& Common::DataSet::getTimeSeriesRef(Global::VariableId variableId) const
+{
+    if (hasVariable(variableId))
+        return *m_dataById[variableId];
+
+    const std::string variableName = variableId < Global::VariableSymbols::instance() -> size() ?
+            Global::VariableSymbols::instance() -> getName(variableId) : "id " + std::to_string(variableId);
+    throw std::runtime_error("E: DataSet::getTimeSeries : variable " + variableName + " is not in the data set.");
+}
+
+Common::DataPanel Common::DataSet::getPanel(const std::vector<std::string> &variableNames) const
+{
+    // Panel calendar is the common calendar of the variables when they share one, the union of their dates otherwise
+    std::shared_ptr<const Common::Calendar> calendar;
+    bool isCalendarShared = true;
+    for (const auto& variableName: variableNames)
+    {
+        const auto tsCalendar = getTimeSeriesRef(variableName).getCalendar();
+        if (!calendar)
+            calendar = tsCalendar;
+        else if (*tsCalendar != *calendar)
+            isCalendarShared = false;
+    }
+
+    if (!calendar)
+        return Common::DataPanel();
+
+    if (!isCalendarShared)
+    {
+        std::set<boost::gregorian::date> dates;
+        for (const auto& variableName: variableNames)
+        {
+            const Common::DatesView tsDates = getTimeSeriesRef(variableName).getDatesView();
+            dates.insert(tsDates.begin(), tsDates.end());
+        }
+        calendar = std::make_shared<Common::Calendar>(std::vector<boost::gregorian::date>(dates.begin(), dates.end()));
+    }
+
+    Common::DataPanel panel(calendar);
+    for (const auto& variableName: variableNames)
+        panel.addColumn(getTimeSeriesRef(variableName));
+
+    return panel;
 }
 
 bool Common::DataSet::operator==(const Common::DataSet &other) const
@@ -97,7 +197,45 @@ bool Common::DataSet::operator!=(const Common::DataSet &other) const
     return !(*this == other);
 }
 
+void Common::DataSet::_shareCalendar(Common::TimeSeries &ts)
+{
+    const auto calendar = ts.getCalendar();
+    const std::size_t key = calendar -> hash();
+    const auto candidates = m_calendars.equal_range(key);
+    for (auto it = candidates.first; it != candidates.second;)
+    {
+        const auto sharedCalendar = it -> second.lock();
+        if (!sharedCalendar)
+        {
+            it = m_calendars.erase(it);
+            continue;
+        }
 
+        if (sharedCalendar == calendar)
+            return;
+        if (*sharedCalendar == *calendar)
+        {
+            ts.shareCalendar(sharedCalendar);
+            return;
+        }
+        ++it;
+    }
 
+    m_calendars.emplace(key, calendar);
+}
 
+void Common::DataSet::_index(const std::string &variableName, const Common::TimeSeries *ts)
+{
+    // Map nodes are stable, so pointers to the stored series stay valid until the variable is removed
+    const Global::VariableId id = Global::VariableSymbols::instance() -> intern(variableName);
+    if (id >= m_dataById.size())
+        m_dataById.resize(id + 1, nullptr);
+    m_dataById[id] = ts;
+}
 
+void Common::DataSet::_rebuildIndex()
+{
+    m_dataById.clear();
+    for (const auto& it: m_data)
+        _index(it.first, &it.second);
+}
@@ -7,35 +7,63 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include "TimeSeries.h"
+#include "Calendar.h"
+#include "DataPanel.h"
+#include "../../Global/Symbols/VariableSymbols.h"
 
 namespace Common
 {
     class TimeSeries;
 
+    //
+    // Collection of named time series. Series added to the data set are rebound to an equal calendar already held
+    // by the data set, found through a registry hashed on the dates, so variables observed on the same dates share
+    // one copy of them. Series can also be accessed by
+    // their interned Global::VariableId, which resolves to an array lookup instead of a string hash.
+    //
     class DataSet
     {
     public:
         DataSet() = default;
         explicit DataSet(const std::vector<Common::TimeSeries> &ts);
+        DataSet(const Common::DataSet &other);
+        DataSet(Common::DataSet &&other) = default;
+        Common::DataSet& operator=(const Common::DataSet &other);
+        Common::DataSet& operator=(Common::DataSet &&other) = default;
 
         void addData(const Common::TimeSeries &otherTs);
         void removeData(const std::string &variableName);
         void appendValue(const std::string &variableName, const boost::gregorian::date &date, double value);
         void clearAllData();
 
-        std::unordered_map<std::string, Common::TimeSeries> getData() const;
+        const std::unordered_map<std::string, Common::TimeSeries>& getData() const;
         double getValue(const std::string &variableName, unsigned int index) const;
         double getValue(const std::string &variableName, const boost::gregorian::date &date) const;
         Common::TimeSeries getTimeSeries(const std::string &variableName) const;
+        const Common::TimeSeries& getTimeSeriesRef(const std::string &variableName) const;
+
+        bool hasVariable(Global::VariableId variableId) const;
+        double getValue(Global::VariableId variableId, unsigned int index) const;
+        double getValue(Global::VariableId variableId, const boost::gregorian::date &date) const;
+        const Common::TimeSeries& getTimeSeriesRef(Global::VariableId variableId) const;
+
+        Common::DataPanel getPanel(const std::vector<std::string> &variableNames) const;
 
         bool operator==(const Common::DataSet &other) const;
         bool operator!=(const Common::DataSet &other) const;
 
     private:
         std::unordered_map<std::string, Common::TimeSeries> m_data;
+        std::unordered_multimap<std::size_t, std::weak_ptr<const Common::Calendar>> m_calendars;     // by Calendar::hash
+        std::vector<const Common::TimeSeries*> m_dataById;
+
+        void _shareCalendar(Common::TimeSeries &ts);
+        void _index(const std::string &variableName, const Common::TimeSeries *ts);
+        void _rebuildIndex();
     };
 
 }
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include "DateIndex.h"
+
+using namespace Common;
+
+namespace
+{
+    // Julian day numbers are congruent to 0 modulo 7 on Mondays
+    const long daysPerWeek = 7;
+    const long businessDaysPerWeek = 5;
+    const long monthsPerYear = 12;
+
+    long getPeriodStep(DateIndex::Frequency frequency)
+    {
+        switch (frequency)
+        {
+            case DateIndex::Frequency::QuarterEnd:
+                return 3;
+            case DateIndex::Frequency::YearEnd:
+                return 12;
+            default:
+                return 1;
+        }
+    }
+}
+
+const std::size_t DateIndex::npos = static_cast<std::size_t>(-1);
+
+DateIndex::DateIndex() : m_frequency(Frequency::Irregular), m_isSorted(true), m_firstDate()
+{
+
+}
+
+void DateIndex::rebuild(const Common::DatesView &dates)
+{
+    m_frequency = Frequency::Irregular;
+    m_isSorted = true;
+    m_firstDate = dates.empty() ? boost::gregorian::date() : dates.front();
+
+    for (std::size_t i = 1; i < dates.size(); ++i)
+        if (dates[i] < dates[i - 1])
+        {
+            m_isSorted = false;
+            break;
+        }
+
+    if (dates.size() < 2 or !m_isSorted or dates[0].is_special() or dates[1].is_special())
+        return;
+
+    const Frequency candidate = _detectFrequency(dates[0], dates[1]);
+    if (candidate == Frequency::Irregular)
+        return;
+
+    const long step = getPeriodStep(candidate);
+    const long firstPeriod = _getPeriodNumber(candidate, dates[0]);
+    for (std::size_t i = 0; i < dates.size(); ++i)
+    {
+        if (dates[i].is_special() or !_isOnCalendar(candidate, dates[i]) or
+            _getPeriodNumber(candidate, dates[i]) - firstPeriod != static_cast<long>(i) * step)
+            return;
+    }
+
+    m_frequency = candidate;
+}
+
+void DateIndex::append(const Common::DatesView &dates)
+{
+    // Dates is expected to already contain the appended date at its back
+    const std::size_t n = dates.size();
+    if (n <= 2)
+    {
+        rebuild(dates);
+        return;
+    }
+
+    const boost::gregorian::date& newDate = dates.back();
+    m_isSorted = m_isSorted and !(newDate < dates[n - 2]);
+
+    if (isRegular() and (newDate.is_special() or !_isOnCalendar(m_frequency, newDate) or
+        _getPeriodNumber(m_frequency, newDate) - _getPeriodNumber(m_frequency, m_firstDate) !=
+        static_cast<long>(n - 1) * getPeriodStep(m_frequency)))
+        m_frequency = Frequency::Irregular;
+}
+
+std::size_t DateIndex::find(const Common::DatesView &dates, const boost::gregorian::date &date) const
+{
+    if (dates.empty())
+        return npos;
+
+    if (date.is_special() or (!isRegular() and !m_isSorted))
+    {
+        const auto it = std::find(dates.begin(), dates.end(), date);
+        return it == dates.end() ? npos : static_cast<std::size_t>(it - dates.begin());
+    }
+
+    if (isRegular())
+    {
+        if (!_isOnCalendar(m_frequency, date))
+            return npos;
+
+        const long step = getPeriodStep(m_frequency);
+        const long periods = _getPeriodNumber(m_frequency, date) - _getPeriodNumber(m_frequency, m_firstDate);
+        if (periods < 0 or periods % step != 0 or static_cast<std::size_t>(periods / step) >= dates.size())
+            return npos;
+
+        return static_cast<std::size_t>(periods / step);
+    }
+
+    const auto it = std::lower_bound(dates.begin(), dates.end(), date);
+    return (it == dates.end() or *it != date) ? npos : static_cast<std::size_t>(it - dates.begin());
+}
+
+DateIndex::Frequency DateIndex::getFrequency() const
+{
+    return m_frequency;
+}
+
+bool DateIndex::isRegular() const
+{
+    return m_frequency != Frequency::Irregular;
+}
+
+bool DateIndex::isSorted() const
+{
+    return m_isSorted;
+}
+
+DateIndex::Frequency DateIndex::_detectFrequency(const boost::gregorian::date &first, const boost::gregorian::date &second)
+{
+    if (_isOnCalendar(Frequency::MonthEnd, first) and _isOnCalendar(Frequency::MonthEnd, second))
+    {
+        switch (_getPeriodNumber(Frequency::MonthEnd, second) - _getPeriodNumber(Frequency::MonthEnd, first))
+        {
+            case 1:
+                return Frequency::MonthEnd;
+            case 3:
+                return Frequency::QuarterEnd;
+            case 12:
+                return Frequency::YearEnd;
+            default:
+                return Frequency::Irregular;
+        }
+    }
+
+    if (_isOnCalendar(Frequency::BusinessDaily, first) and _isOnCalendar(Frequency::BusinessDaily, second) and
+        _getPeriodNumber(Frequency::BusinessDaily, second) - _getPeriodNumber(Frequency::BusinessDaily, first) == 1)
+        return Frequency::BusinessDaily;
+
+    return Frequency::Irregular;
+}
+
+long DateIndex::_getPeriodNumber(Frequency frequency, const boost::gregorian::date &date)
+{
+    if (frequency == Frequency::BusinessDaily)
+    {
+        const long dayNumber = static_cast<long>(date.day_number());
+        return (dayNumber / daysPerWeek) * businessDaysPerWeek + std::min(dayNumber % daysPerWeek, businessDaysPerWeek);
+    }
+
+    // Month-based calendars share the same month counter, step between consecutive dates is applied by caller
+    return static_cast<long>(date.year()) * monthsPerYear + static_cast<long>(date.month()) - 1;
+}
+
+bool DateIndex::_isOnCalendar(Frequency frequency, const boost::gregorian::date &date)
+{
+    if (frequency == Frequency::BusinessDaily)
+        return static_cast<long>(date.day_number()) % daysPerWeek < businessDaysPerWeek;
+
+    return date == date.end_of_month();
+}
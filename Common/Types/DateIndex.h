@@ -0,0 +1,52 @@
+#ifndef WILDCATSTKCORE_DATEINDEX_H
+#define WILDCATSTKCORE_DATEINDEX_H
+
+#include <cstddef>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "ArrayView.h"
+
+namespace Common
+{
+    //
+    // Date-to-position lookup for a sequence of dates. Regular calendars (month-end, quarter-end, year-end and
+    // business daily) are resolved arithmetically in O(1); any other calendar falls back to a binary search when
+    // dates are sorted, or to a linear scan otherwise. The index does not own the dates: every call receives a
+    // view of the sequence the index was built from.
+    //
+    class DateIndex
+    {
+    public:
+        enum class Frequency
+        {
+            Irregular,
+            BusinessDaily,
+            MonthEnd,
+            QuarterEnd,
+            YearEnd
+        };
+
+        static const std::size_t npos;
+
+        DateIndex();
+
+        void rebuild(const Common::DatesView& dates);
+        void append(const Common::DatesView& dates);
+
+        std::size_t find(const Common::DatesView& dates, const boost::gregorian::date& date) const;
+
+        Frequency getFrequency() const;
+        bool isRegular() const;
+        bool isSorted() const;
+
+    private:
+        Frequency m_frequency;
+        bool m_isSorted;
+        boost::gregorian::date m_firstDate;
+
+        static Frequency _detectFrequency(const boost::gregorian::date& first, const boost::gregorian::date& second);
+        static long _getPeriodNumber(Frequency frequency, const boost::gregorian::date& date);
+        static bool _isOnCalendar(Frequency frequency, const boost::gregorian::date& date);
+    };
+}
+
+#endif //WILDCATSTKCORE_DATEINDEX_H
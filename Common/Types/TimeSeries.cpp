@@ -3,28 +3,87 @@
 //
 
 #include "TimeSeries.h"
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
 using namespace Common;
 
+namespace
+{
+    // Default constructed series all share the same empty calendar, which is detached on first pushBack
+    const std::shared_ptr<const Common::Calendar>& getEmptyCalendar()
+    {
+        static const std::shared_ptr<const Common::Calendar> emptyCalendar = std::make_shared<Common::Calendar>();
+        return emptyCalendar;
+    }
+
+    const std::shared_ptr<const Common::TimeSeriesName>& getEmptyName()
+    {
+        static const std::shared_ptr<const Common::TimeSeriesName> emptyName = std::make_shared<Common::TimeSeriesName>("");
+        return emptyName;
+    }
+}
+
 //TimeSeries class implementation
+TimeSeries::TimeSeries() : m_name(getEmptyName()), m_ownedValues(nullptr), m_values(nullptr), m_length(0),
+                           m_calendar(getEmptyCalendar()), m_ownedCalendar(nullptr)
+{
+
+}
+
 TimeSeries::TimeSeries(std::string variableName, const std::vector<double> &variableData,
                        const std::vector<boost::gregorian::date> &dates) :
-        m_name(std::move(variableName)), m_data(variableData), m_dates(dates)
+        m_name(std::make_shared<Common::TimeSeriesName>(std::move(variableName))), m_ownedCalendar(nullptr)
 {
     if (variableData.size() != dates.size())
         throw std::runtime_error("E: TimeSeries::TimeSeries : TimeSeries object cannot be constructed due to data-date size mismatch");
+
+    _setOwnedValues(std::make_shared<std::vector<double>>(variableData));
+    _setOwnedCalendar(std::make_shared<Common::Calendar>(dates));
+}
+
+TimeSeries::TimeSeries(std::string variableName, std::vector<double> variableData,
+                       std::shared_ptr<const Common::Calendar> calendar) :
+        m_name(std::make_shared<Common::TimeSeriesName>(std::move(variableName))), m_calendar(std::move(calendar)),
+        m_ownedCalendar(nullptr)
+{
+    if (!m_calendar)
+        throw std::runtime_error("E: TimeSeries::TimeSeries : TimeSeries object cannot be constructed on a null calendar");
+    if (variableData.size() != m_calendar->size())
+        throw std::runtime_error("E: TimeSeries::TimeSeries : TimeSeries object cannot be constructed due to data-date size mismatch");
+
+    _setOwnedValues(std::make_shared<std::vector<double>>(std::move(variableData)));
+}
+
+TimeSeries::TimeSeries(std::string variableName, const Common::TimeSeries &other) :
+        m_name(std::make_shared<Common::TimeSeriesName>(std::move(variableName))), m_valuesOwner(other.m_valuesOwner),
+        m_ownedValues(other.m_ownedValues), m_values(other.m_values), m_length(other.m_length),
+        m_calendar(other.m_calendar), m_ownedCalendar(other.m_ownedCalendar)
+{
+
+}
+
+TimeSeries::TimeSeries(std::string variableName, std::shared_ptr<const void> valuesOwner, const double *values,
+                       std::size_t length, std::shared_ptr<const Common::Calendar> calendar) :
+        m_name(std::make_shared<Common::TimeSeriesName>(std::move(variableName))), m_valuesOwner(std::move(valuesOwner)),
+        m_ownedValues(nullptr), m_values(values), m_length(length), m_calendar(std::move(calendar)),
+        m_ownedCalendar(nullptr)
+{
+    if (!m_calendar)
+        throw std::runtime_error("E: TimeSeries::TimeSeries : TimeSeries object cannot be constructed on a null calendar");
+    if (m_length != m_calendar->size())
+        throw std::runtime_error("E: TimeSeries::TimeSeries : TimeSeries object cannot be constructed due to data-date size mismatch");
 }
 
 void TimeSeries::set(const std::string &otherName, const std::vector<double> &otherData,
                      const std::vector<boost::gregorian::date> &otherDates)
 {
-    m_name = otherName;
+    m_name = std::make_shared<Common::TimeSeriesName>(otherName);
     if (otherData.size() == otherDates.size())
     {
-        m_data = otherData;
-        m_dates = otherDates;
+        _setOwnedValues(std::make_shared<std::vector<double>>(otherData));
+        _setOwnedCalendar(std::make_shared<Common::Calendar>(otherDates));
     }
     else
         throw std::runtime_error("E: TimeSeries::set : TimeSeries object cannot be set due to data-date size mismatch");
@@ -32,119 +91,119 @@ void TimeSeries::set(const std::string &otherName, const std::vector<double> &ot
 
 std::string TimeSeries::getName() const
 {
-    return m_name;
+    return m_name -> str();
 }
 
 std::vector<double> TimeSeries::getValues() const
 {
-    return m_data;
+    return std::vector<double>(m_values, m_values + m_length);
 }
 
 std::vector<boost::gregorian::date> TimeSeries::getDates() const
 {
-    return m_dates;
+    return m_calendar->getDates();
 }
 
-double TimeSeries::getValue(unsigned int index) const
+Common::ValuesView TimeSeries::getValuesView() const
 {
-    if (index < m_data.size())
-        return m_data.at(index);
-    else
-        throw std::out_of_range("E: TimeSeries::getValue : index " + std::to_string(index) + " is not in range.");
+    return Common::ValuesView(m_values, m_length);
 }
 
-double TimeSeries::getValue(const boost::gregorian::date& date) const
+Common::DatesView TimeSeries::getDatesView() const
 {
-    return m_data.at(getIndex(date));
+    return m_calendar->getDatesView();
 }
 
-unsigned int TimeSeries::getIndex(const boost::gregorian::date& date) const
+std::shared_ptr<const Common::Calendar> TimeSeries::getCalendar() const
+{
+    return m_calendar;
+}
+
+void TimeSeries::shareCalendar(const std::shared_ptr<const Common::Calendar> &calendar)
 {
-    for (unsigned long i = 0; i < m_dates.size(); ++i)
+    if (!calendar or *calendar != *m_calendar)
+        throw std::runtime_error("E: TimeSeries::shareCalendar : calendar of " + getName() + " cannot be replaced by a calendar with different dates.");
+
+    if (calendar != m_calendar)
     {
-        if (m_dates[i] == date)
-            return i;
+        m_calendar = calendar;
+        m_ownedCalendar = nullptr;
     }
-    throw std::out_of_range("E: TimeSeries::getValue : date " + boost::gregorian::to_simple_string(date) + "is not in range.");
 }
 
-size_t TimeSeries::length() const
+double TimeSeries::getValue(unsigned int index) const
 {
-    return m_data.size();
+    if (index < m_length)
+        return m_values[index];
+    else
+        throw std::out_of_range("E: TimeSeries::getValue : index " + std::to_string(index) + " is not in range.");
 }
 
-void TimeSeries::pushBack(const boost::gregorian::date &date, double value)
+double TimeSeries::getValue(const boost::gregorian::date& date) const
 {
-    m_data.push_back(value);
-    m_dates.push_back(date);
+    return m_values[getIndex(date)];
 }
 
-bool TimeSeries::operator==(const Common::TimeSeries &other) const
+unsigned int TimeSeries::getIndex(const boost::gregorian::date& date) const
 {
-    return m_name == other.m_name and m_data == other.m_data and m_dates == other.m_dates;
+    const std::size_t index = m_calendar->find(date);
+    if (index != Common::DateIndex::npos)
+        return static_cast<unsigned int>(index);
+
+    throw std::out_of_range("E: TimeSeries::getValue : date " + boost::gregorian::to_simple_string(date) + "is not in range.");
 }
 
-bool TimeSeries::operator!=(const Common::TimeSeries &other) const
+bool TimeSeries::hasDate(const boost::gregorian::date &date) const
 {
-    return !(*this == other);
+    return m_calendar->find(date) != Common::DateIndex::npos;
 }
 
-Common::TimeSeries TimeSeries::operator+(const Common::TimeSeries &rhs) const
+size_t TimeSeries::length() const
 {
-    if (m_data.size() != rhs.getValues().size())
-        throw std::runtime_error("TimeSeries::operator+ : binary operator cannot be applied to timeseries with mismatching size.");
-    if (m_dates != rhs.m_dates)
-        throw std::runtime_error("TimeSeries::operator+ :  binary operator cannot be applied to timeseries with mismatching dates.");
-
-    Common::TimeSeries res;
-    for (unsigned int i = 0; i < m_data.size(); ++i)
-        res.pushBack(m_dates.at(i), m_data.at(i) + rhs.m_data.at(i));
-
-    res.m_name = m_name + "+" + rhs.m_name;
-    return res;
+    return m_length;
 }
 
-Common::TimeSeries TimeSeries::operator-(const Common::TimeSeries &rhs) const
+Common::DateIndex::Frequency TimeSeries::getFrequency() const
 {
-    if (m_data.size() != rhs.getValues().size())
-        throw std::runtime_error("TimeSeries::operator- : binary operator cannot be applied to timeseries with mismatching size.");
-    if (m_dates != rhs.m_dates)
-        throw std::runtime_error("TimeSeries::operator- :  binary operator cannot be applied to timeseries with mismatching dates.");
-
-    Common::TimeSeries res;
-    for (unsigned int i = 0; i < m_data.size(); ++i)
-        res.pushBack(m_dates.at(i), m_data.at(i) - rhs.m_data.at(i));
-
-    res.m_name = m_name + "-" + rhs.m_name;
-    return res;
+    return m_calendar->getFrequency();
 }
 
-Common::TimeSeries TimeSeries::operator*(const Common::TimeSeries &rhs) const
+void TimeSeries::pushBack(const boost::gregorian::date &date, double value)
 {
-    if (m_data.size() != rhs.getValues().size())
-        throw std::runtime_error("TimeSeries::operator* : binary operator cannot be applied to timeseries with mismatching size.");
-    if (m_dates != rhs.m_dates)
-        throw std::runtime_error("TimeSeries::operator* :  binary operator cannot be applied to timeseries with mismatching dates.");
+    // Copy on write: values and calendar are only modified in place when they were allocated here and are not
+    // shared
+    if (!m_ownedValues or m_valuesOwner.use_count() > 1)
+        _setOwnedValues(std::make_shared<std::vector<double>>(m_values, m_values + m_length));
+    if (!m_ownedCalendar or m_calendar.use_count() > 1)
+        _setOwnedCalendar(std::make_shared<Common::Calendar>(*m_calendar));
 
-    Common::TimeSeries res;
-    for (unsigned int i = 0; i < m_data.size(); ++i)
-        res.pushBack(m_dates.at(i), m_data.at(i) * rhs.m_data.at(i));
+    m_ownedValues -> push_back(value);
+    m_values = m_ownedValues -> data(), m_length = m_ownedValues -> size();
+    m_ownedCalendar -> append(date);
+}
 
-    res.m_name = m_name + "*" + rhs.m_name;
-    return res;
+bool TimeSeries::operator==(const Common::TimeSeries &other) const
+{
+    return m_length == other.m_length and
+           (m_values == other.m_values or std::equal(m_values, m_values + m_length, other.m_values)) and
+           *m_calendar == *other.m_calendar and
+           (m_name == other.m_name or getName() == other.getName());
 }
 
-Common::TimeSeries TimeSeries::operator/(const Common::TimeSeries &rhs) const
+bool TimeSeries::operator!=(const Common::TimeSeries &other) const
 {
-    if (m_data.size() != rhs.getValues().size())
-        throw std::runtime_error("TimeSeries::operator/ : binary operator cannot be applied to timeseries with mismatching size.");
-    if (m_dates != rhs.m_dates)
-        throw std::runtime_error("TimeSeries::operator/ :  binary operator cannot be applied to timeseries with mismatching dates.");
+    return !(*this == other);
+}
 
-    Common::TimeSeries res;
-    for (unsigned int i = 0; i < m_data.size(); ++i)
-        res.pushBack(m_dates.at(i), m_data.at(i) / rhs.m_data.at(i));
+void TimeSeries::_setOwnedValues(std::shared_ptr<std::vector<double>> values)
+{
+    m_ownedValues = values.get();
+    m_values = values -> data(), m_length = values -> size();
+    m_valuesOwner = std::move(values);
+}
 
-    res.m_name = m_name + "/" + rhs.m_name;
-    return res;
-}
\ No newline at end of file
+void TimeSeries::_setOwnedCalendar(std::shared_ptr<Common::Calendar> calendar)
+{
+    m_ownedCalendar = calendar.get();
+    m_calendar = std::move(calendar);
+}
@@ -8,18 +8,42 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <boost/date_time/gregorian/gregorian.hpp>
+#include "ArrayView.h"
+#include "DateIndex.h"
+#include "Calendar.h"
+#include "TimeSeriesExpression.h"
 
 namespace Common
 {
-    class TimeSeries
+    //
+    // Named sequence of values observed on a calendar. Values and calendar are reference counted: copies share them
+    // in O(1) and a series copies them on write the first time it is extended while they are shared. The calendar
+    // is also shared between series observed on the same dates. Values may also live in an external read-only buffer
+    // (e.g. a memory-mapped file) kept alive by an opaque owner, which is copied out on the first pushBack.
+    // Arithmetic operators (see TimeSeriesExpression.h) are evaluated lazily and materialised on conversion.
+    //
+    class TimeSeries : public Common::TimeSeriesExpression<Common::TimeSeries>
     {
     public:
-        TimeSeries() = default;
+        TimeSeries();
         TimeSeries(const Common::TimeSeries& other) = default;
         TimeSeries(std::string variableName, const std::vector<double> &variableData,
                    const std::vector<boost::gregorian::date> &dates);
+        TimeSeries(std::string variableName, std::vector<double> variableData,
+                   std::shared_ptr<const Common::Calendar> calendar);
+        TimeSeries(std::string variableName, const Common::TimeSeries& other);
+        TimeSeries(std::string variableName, std::shared_ptr<const void> valuesOwner, const double* values,
+                   std::size_t length, std::shared_ptr<const Common::Calendar> calendar);
+
+        template <typename E>
+        TimeSeries(const Common::TimeSeriesExpression<E>& expression);
+
+        Common::TimeSeries& operator=(const Common::TimeSeries& other) = default;
+        template <typename E>
+        Common::TimeSeries& operator=(const Common::TimeSeriesExpression<E>& expression);
 
         void set(const std::string& otherName, const std::vector<double>& otherData,
                 const std::vector<boost::gregorian::date>& otherDates);
@@ -27,27 +51,64 @@ namespace Common
         std::string getName() const;
         std::vector<double> getValues() const;
         std::vector<boost::gregorian::date> getDates() const;
+        Common::ValuesView getValuesView() const;
+        Common::DatesView getDatesView() const;
+        std::shared_ptr<const Common::Calendar> getCalendar() const;
+        void shareCalendar(const std::shared_ptr<const Common::Calendar>& calendar);
 
         double getValue(unsigned int index) const;
         double getValue(const boost::gregorian::date &date) const;
         unsigned int getIndex(const boost::gregorian::date &date) const;
+        bool hasDate(const boost::gregorian::date &date) const;
         size_t length() const;
+        Common::DateIndex::Frequency getFrequency() const;
 
         void pushBack(const boost::gregorian::date &date, double value);
 
+        // Equality covers the name as well as values and dates: an arithmetic result compares unequal to a series
+        // with the same contents under another name
         bool operator==(const Common::TimeSeries &other) const;
         bool operator!=(const Common::TimeSeries &other) const;
-        Common::TimeSeries operator+(const Common::TimeSeries& rhs) const;
-        Common::TimeSeries operator-(const Common::TimeSeries& rhs) const;
-        Common::TimeSeries operator/(const Common::TimeSeries& rhs) const;
-        Common::TimeSeries operator*(const Common::TimeSeries& rhs) const;
+
+        // TimeSeriesExpression interface
+        double valueAt(std::size_t index) const { return m_values[index]; }
+        const std::shared_ptr<const Common::Calendar>& getCalendarRef() const { return m_calendar; }
+        std::shared_ptr<const Common::TimeSeriesName> getNameNode() const { return m_name; }
 
     private:
-        std::string m_name;
-        std::vector<double> m_data;
-        std::vector<boost::gregorian::date> m_dates;
+        std::shared_ptr<const Common::TimeSeriesName> m_name;
+        std::shared_ptr<const void> m_valuesOwner;
+        std::vector<double>* m_ownedValues;     // m_valuesOwner when it is a buffer allocated here, null otherwise
+        const double* m_values;
+        std::size_t m_length;
+        std::shared_ptr<const Common::Calendar> m_calendar;
+        Common::Calendar* m_ownedCalendar;      // m_calendar when it was allocated here, null when it may be shared
+
+        void _setOwnedValues(std::shared_ptr<std::vector<double>> values);
+        void _setOwnedCalendar(std::shared_ptr<Common::Calendar> calendar);
     };
 
+    template <typename E>
+    TimeSeries::TimeSeries(const Common::TimeSeriesExpression<E> &expression) :
+            m_name(expression.derived().getNameNode()), m_calendar(expression.derived().getCalendarRef()),
+            m_ownedCalendar(nullptr)
+    {
+        // Single fused loop over the whole expression tree, operands were aligned when the tree was built
+        const E& expr = expression.derived();
+        auto values = std::make_shared<std::vector<double>>(expr.length());
+        double* out = values -> data();
+        for (std::size_t i = 0; i < values -> size(); ++i)
+            out[i] = expr.valueAt(i);
+        _setOwnedValues(std::move(values));
+    }
+
+    template <typename E>
+    Common::TimeSeries& TimeSeries::operator=(const Common::TimeSeriesExpression<E> &expression)
+    {
+        *this = Common::TimeSeries(expression);
+        return *this;
+    }
+
 }
 
 #endif //WILDCATSTKCORE_TIMESERIES_H
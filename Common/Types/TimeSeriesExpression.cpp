@@ -0,0 +1,49 @@
+#include <stdexcept>
+#include <utility>
+#include "TimeSeriesExpression.h"
+
+Common::TimeSeriesName::TimeSeriesName(std::string name) : m_name(std::move(name)), m_operator('\0')
+{
+
+}
+
+Common::TimeSeriesName::TimeSeriesName(std::shared_ptr<const Common::TimeSeriesName> lhs, char binaryOperator,
+                                       std::shared_ptr<const Common::TimeSeriesName> rhs) :
+        m_lhs(std::move(lhs)), m_rhs(std::move(rhs)), m_operator(binaryOperator)
+{
+
+}
+
+std::string Common::TimeSeriesName::str() const
+{
+    if (!m_lhs)
+        return m_name;
+
+    std::string name;
+    _append(name);
+    return name;
+}
+
+void Common::TimeSeriesName::_append(std::string &out) const
+{
+    if (!m_lhs)
+    {
+        out += m_name;
+        return;
+    }
+
+    m_lhs -> _append(out);
+    out += m_operator;
+    m_rhs -> _append(out);
+}
+
+void Common::checkTimeSeriesAlignment(std::size_t lhsLength, const Common::Calendar &lhsCalendar,
+                                      std::size_t rhsLength, const Common::Calendar &rhsCalendar, char binaryOperator)
+{
+    if (lhsLength != rhsLength)
+        throw std::runtime_error(std::string("TimeSeries::operator") + binaryOperator +
+                                 " : binary operator cannot be applied to timeseries with mismatching size.");
+    if (lhsCalendar != rhsCalendar)
+        throw std::runtime_error(std::string("TimeSeries::operator") + binaryOperator +
+                                 " :  binary operator cannot be applied to timeseries with mismatching dates.");
+}
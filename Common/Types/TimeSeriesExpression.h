@@ -0,0 +1,141 @@
+#ifndef WILDCATSTKCORE_TIMESERIESEXPRESSION_H
+#define WILDCATSTKCORE_TIMESERIESEXPRESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "Calendar.h"
+
+namespace Common
+{
+    class TimeSeries;
+
+    //
+    // Immutable name of a TimeSeries. Names of arithmetic results are kept as a tree of their operands' names and
+    // only concatenated when the name is requested.
+    //
+    class TimeSeriesName
+    {
+    public:
+        explicit TimeSeriesName(std::string name);
+        TimeSeriesName(std::shared_ptr<const Common::TimeSeriesName> lhs, char binaryOperator,
+                       std::shared_ptr<const Common::TimeSeriesName> rhs);
+
+        std::string str() const;
+
+    private:
+        std::string m_name;
+        std::shared_ptr<const Common::TimeSeriesName> m_lhs;
+        std::shared_ptr<const Common::TimeSeriesName> m_rhs;
+        char m_operator;
+
+        void _append(std::string& out) const;
+    };
+
+    void checkTimeSeriesAlignment(std::size_t lhsLength, const Common::Calendar& lhsCalendar,
+                                  std::size_t rhsLength, const Common::Calendar& rhsCalendar, char binaryOperator);
+
+    //
+    // CRTP base of lazily evaluated TimeSeries arithmetic. Every expression E provides
+    //      std::size_t length() const;
+    //      double valueAt(std::size_t index) const;    // unchecked
+    //      const std::shared_ptr<const Common::Calendar>& getCalendarRef() const;
+    //      std::shared_ptr<const Common::TimeSeriesName> getNameNode() const;
+    // Chained operators build a tree of expression nodes that is evaluated in a single loop into one allocation when
+    // it is converted to a TimeSeries. Nodes hold every operand by value: a TimeSeries copy only shares its name,
+    // values and calendar, so an expression stays valid after the temporaries it was built from are gone.
+    //
+    template <typename E>
+    class TimeSeriesExpression
+    {
+    public:
+        const E& derived() const { return static_cast<const E&>(*this); }
+    };
+
+    struct TimeSeriesAdd
+    {
+        static char symbol() { return '+'; }
+        static double apply(double lhs, double rhs) { return lhs + rhs; }
+    };
+
+    struct TimeSeriesSubtract
+    {
+        static char symbol() { return '-'; }
+        static double apply(double lhs, double rhs) { return lhs - rhs; }
+    };
+
+    struct TimeSeriesMultiply
+    {
+        static char symbol() { return '*'; }
+        static double apply(double lhs, double rhs) { return lhs * rhs; }
+    };
+
+    struct TimeSeriesDivide
+    {
+        static char symbol() { return '/'; }
+        static double apply(double lhs, double rhs) { return lhs / rhs; }
+    };
+
+    template <typename Op, typename L, typename R>
+    class TimeSeriesBinaryExpression : public Common::TimeSeriesExpression<TimeSeriesBinaryExpression<Op, L, R>>
+    {
+    public:
+        TimeSeriesBinaryExpression(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs)
+        {
+            // Operands sharing a calendar are checked by pointer, dates are only compared for distinct calendars
+            if (m_lhs.getCalendarRef() != m_rhs.getCalendarRef() or m_lhs.length() != m_rhs.length())
+                Common::checkTimeSeriesAlignment(m_lhs.length(), *m_lhs.getCalendarRef(),
+                                                 m_rhs.length(), *m_rhs.getCalendarRef(), Op::symbol());
+        }
+
+        std::size_t length() const { return m_lhs.length(); }
+        double valueAt(std::size_t index) const { return Op::apply(m_lhs.valueAt(index), m_rhs.valueAt(index)); }
+        const std::shared_ptr<const Common::Calendar>& getCalendarRef() const { return m_lhs.getCalendarRef(); }
+        std::shared_ptr<const Common::TimeSeriesName> getNameNode() const
+        {
+            return std::make_shared<Common::TimeSeriesName>(m_lhs.getNameNode(), Op::symbol(), m_rhs.getNameNode());
+        }
+
+        std::string getName() const { return getNameNode() -> str(); }
+        std::vector<boost::gregorian::date> getDates() const { return getCalendarRef() -> getDates(); }
+        std::vector<double> getValues() const
+        {
+            std::vector<double> values(length());
+            for (std::size_t i = 0; i < values.size(); ++i)
+                values[i] = valueAt(i);
+            return values;
+        }
+
+    private:
+        const L m_lhs;
+        const R m_rhs;
+    };
+
+    template <typename L, typename R>
+    TimeSeriesBinaryExpression<TimeSeriesAdd, L, R> operator+(const TimeSeriesExpression<L>& lhs, const TimeSeriesExpression<R>& rhs)
+    {
+        return TimeSeriesBinaryExpression<TimeSeriesAdd, L, R>(lhs.derived(), rhs.derived());
+    }
+
+    template <typename L, typename R>
+    TimeSeriesBinaryExpression<TimeSeriesSubtract, L, R> operator-(const TimeSeriesExpression<L>& lhs, const TimeSeriesExpression<R>& rhs)
+    {
+        return TimeSeriesBinaryExpression<TimeSeriesSubtract, L, R>(lhs.derived(), rhs.derived());
+    }
+
+    template <typename L, typename R>
+    TimeSeriesBinaryExpression<TimeSeriesMultiply, L, R> operator*(const TimeSeriesExpression<L>& lhs, const TimeSeriesExpression<R>& rhs)
+    {
+        return TimeSeriesBinaryExpression<TimeSeriesMultiply, L, R>(lhs.derived(), rhs.derived());
+    }
+
+    template <typename L, typename R>
+    TimeSeriesBinaryExpression<TimeSeriesDivide, L, R> operator/(const TimeSeriesExpression<L>& lhs, const TimeSeriesExpression<R>& rhs)
+    {
+        return TimeSeriesBinaryExpression<TimeSeriesDivide, L, R>(lhs.derived(), rhs.derived());
+    }
+}
+
+#endif //WILDCATSTKCORE_TIMESERIESEXPRESSION_H
@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "AlgebraicBytecode.h"
+#include "../../Math/LinearAlgebra/VectorKernels.h"
+
+namespace
+{
+    // Stack entry of the column machine: row i of the operand is values[i - shift], defined for rows from validFrom
+    struct ColumnOperand
+    {
+        const double* values;
+        std::size_t shift, validFrom;
+        const double* block;        // scratch block holding the values, null for input columns and constants
+    };
+
+    void applyUnary(Common::AlgebraicOpCode opCode, const double* values, double* out, std::size_t n)
+    {
+        switch (opCode)
+        {
+            case Common::AlgebraicOpCode::Log: Math::VectorKernels::log(values, out, n); break;
+            case Common::AlgebraicOpCode::Exp: Math::VectorKernels::exp(values, out, n); break;
+            case Common::AlgebraicOpCode::Abs: Math::VectorKernels::abs(values, out, n); break;
+            default: break;
+        }
+    }
+
+    void applyBinary(Common::AlgebraicOpCode opCode, const double* lhs, const double* rhs, double* out, std::size_t n)
+    {
+        switch (opCode)
+        {
+            case Common::AlgebraicOpCode::Add: Math::VectorKernels::add(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Substract: Math::VectorKernels::substract(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Multiply: Math::VectorKernels::multiply(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Divide: Math::VectorKernels::divide(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Power: Math::VectorKernels::power(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Min: Math::VectorKernels::minimum(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Max: Math::VectorKernels::maximum(lhs, rhs, out, n); break;
+            default: break;
+        }
+    }
+}
+
+void Common::AlgebraicBytecode::pushConstant(double constant)
+{
+    m_instructions.push_back({Common::AlgebraicOpCode::PushConstant, static_cast<unsigned int>(m_constants.size())});
+    m_constants.push_back(constant);
+    m_stackDepth = std::max(m_stackDepth, ++m_stackSize);
+}
+
+void Common::AlgebraicBytecode::pushVariable(const std::string &variable)
+{
+    const auto it = m_slots.emplace(variable, static_cast<unsigned int>(m_variables.size())).first;
+    if (it -> second == m_variables.size())
+        m_variables.push_back(variable);
+
+    m_instructions.push_back({Common::AlgebraicOpCode::PushVariable, it -> second});
+    m_stackDepth = std::max(m_stackDepth, ++m_stackSize);
+}
+
+void Common::AlgebraicBytecode::emit(Common::AlgebraicOpCode opCode, unsigned int operand)
+{
+    if (opCode == Common::AlgebraicOpCode::PushConstant or opCode == Common::AlgebraicOpCode::PushVariable)
+        throw std::runtime_error("E: AlgebraicBytecode::emit : push instructions need an operand.");
+    if (m_stackSize < (isUnary(opCode) ? 1u : 2u))
+        throw std::runtime_error("E: AlgebraicBytecode::emit : operator applied to too few operands.");
+    if (opCode == Common::AlgebraicOpCode::MovingAverage and operand == 0)
+        throw std::runtime_error("E: AlgebraicBytecode::emit : moving average window must be positive.");
+
+    m_instructions.push_back({opCode, isHistory(opCode) ? operand : 0});
+    if (!isUnary(opCode))
+        --m_stackSize;
+    m_hasHistory = m_hasHistory or isHistory(opCode);
+}
+
+bool Common::AlgebraicBytecode::isUnary(Common::AlgebraicOpCode opCode)
+{
+    switch (opCode)
+    {
+        case Common::AlgebraicOpCode::Log:
+        case Common::AlgebraicOpCode::Exp:
+        case Common::AlgebraicOpCode::Abs:
+        case Common::AlgebraicOpCode::Lag:
+        case Common::AlgebraicOpCode::Diff:
+        case Common::AlgebraicOpCode::MovingAverage:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Common::AlgebraicBytecode::isHistory(Common::AlgebraicOpCode opCode)
+{
+    return opCode == Common::AlgebraicOpCode::Lag or opCode == Common::AlgebraicOpCode::Diff or
+           opCode == Common::AlgebraicOpCode::MovingAverage;
+}
+
+bool Common::AlgebraicBytecode::hasHistory() const
+{
+    return m_hasHistory;
+}
+
+double Common::AlgebraicBytecode::evaluate(const double *slots) const
+{
+    _checkBalanced();
+    if (m_hasHistory)
+        throw std::runtime_error("E: AlgebraicBytecode::evaluate : lag, diff and ma need whole series, use evaluateColumns.");
+
+    if (m_stackDepth <= inlineStackDepth())
+    {
+        double stack[inlineStackDepth()];
+        return _run(slots, stack);
+    }
+
+    std::vector<double> stack(m_stackDepth);
+    return _run(slots, stack.data());
+}
+
+double Common::AlgebraicBytecode::evaluate(const std::vector<double> &slots) const
+{
+    if (slots.size() < m_variables.size())
+        throw std::out_of_range("E: AlgebraicBytecode::evaluate : " + std::to_string(m_variables.size()) +
+                                " slots expected, " + std::to_string(slots.size()) + " given.");
+
+    return evaluate(slots.data());
+}
+
+void Common::AlgebraicBytecode::evaluateColumns(const double *const *columns, std::size_t length, double *out) const
+{
+    _checkBalanced();
+
+    // Programs reading earlier rows run in a single block over the whole series. Every stack level has two scratch
+    // blocks and results go to the one not holding the operand below, so that an offset view is never overwritten
+    // while it is read. Constants get one broadcast block each, variables are read in place.
+    const std::size_t blockSize = m_hasHistory ? std::max<std::size_t>(length, 1) : columnBlockSize();
+    std::vector<double> buffers(2 * m_stackDepth * blockSize), constants(m_constants.size() * blockSize);
+    for (std::size_t i = 0; i < m_constants.size(); ++i)
+        Math::VectorKernels::fill(m_constants[i], constants.data() + i * blockSize, blockSize);
+
+    std::vector<ColumnOperand> stack(m_stackDepth);
+    for (std::size_t first = 0; first < length; first += blockSize)
+    {
+        const std::size_t n = std::min(blockSize, length - first);
+        std::size_t top = 0;
+        for (const auto& it: m_instructions)
+        {
+            if (it.opCode == Common::AlgebraicOpCode::PushConstant)
+            {
+                stack[top++] = {constants.data() + it.operand * blockSize, 0, 0, nullptr};
+                continue;
+            }
+            if (it.opCode == Common::AlgebraicOpCode::PushVariable)
+            {
+                stack[top++] = {columns[it.operand] + first, 0, 0, nullptr};
+                continue;
+            }
+            if (it.opCode == Common::AlgebraicOpCode::Lag)
+            {
+                // Zero copy, the operand is only viewed it.operand rows later
+                stack[top - 1].shift += it.operand;
+                stack[top - 1].validFrom += it.operand;
+                continue;
+            }
+
+            const std::size_t level = top - (isUnary(it.opCode) ? 1 : 2);
+            const ColumnOperand& lhs = stack[level];
+            double* result = buffers.data() + 2 * level * blockSize;
+            if (lhs.block == result)
+                result += blockSize;
+
+            std::size_t validFrom = lhs.validFrom;
+            if (it.opCode == Common::AlgebraicOpCode::Diff)
+            {
+                validFrom = lhs.validFrom + 1;
+                if (validFrom < n)
+                    Math::VectorKernels::substract(lhs.values + validFrom - lhs.shift, lhs.values + validFrom - 1 - lhs.shift,
+                                                   result + validFrom, n - validFrom);
+            }
+            else if (it.opCode == Common::AlgebraicOpCode::MovingAverage)
+            {
+                validFrom = lhs.validFrom + it.operand - 1;
+                if (lhs.validFrom < n)
+                    Math::VectorKernels::movingAverage(lhs.values + lhs.validFrom - lhs.shift, result + lhs.validFrom,
+                                                       n - lhs.validFrom, it.operand);
+            }
+            else if (isUnary(it.opCode))
+            {
+                if (validFrom < n)
+                    applyUnary(it.opCode, lhs.values + validFrom - lhs.shift, result + validFrom, n - validFrom);
+            }
+            else
+            {
+                const ColumnOperand& rhs = stack[level + 1];
+                validFrom = std::max(lhs.validFrom, rhs.validFrom);
+                if (validFrom < n)
+                    applyBinary(it.opCode, lhs.values + validFrom - lhs.shift, rhs.values + validFrom - rhs.shift,
+                                result + validFrom, n - validFrom);
+            }
+
+            stack[level] = {result, 0, validFrom, result};
+            top = level + 1;
+        }
+
+        const ColumnOperand& rv = stack[0];
+        const std::size_t validFrom = std::min(rv.validFrom, n);
+        std::fill(out + first, out + first + validFrom, std::numeric_limits<double>::quiet_NaN());
+        if (validFrom < n)
+            std::copy(rv.values + validFrom - rv.shift, rv.values + n - rv.shift, out + first + validFrom);
+    }
+}
+
+const std::vector<std::string>& Common::AlgebraicBytecode::getVariables() const
+{
+    return m_variables;
+}
+
+std::size_t Common::AlgebraicBytecode::getSlotCount() const
+{
+    return m_variables.size();
+}
+
+std::size_t Common::AlgebraicBytecode::getSlot(const std::string &variable) const
+{
+    const auto it = m_slots.find(variable);
+    if (it == m_slots.end())
+        throw std::out_of_range("E: AlgebraicBytecode::getSlot : variable " + variable + " is not used by the program.");
+
+    return it -> second;
+}
+
+const std::vector<Common::AlgebraicInstruction>& Common::AlgebraicBytecode::getInstructions() const
+{
+    return m_instructions;
+}
+
+const std::vector<double>& Common::AlgebraicBytecode::getConstants() const
+{
+    return m_constants;
+}
+
+std::size_t Common::AlgebraicBytecode::getStackDepth() const
+{
+    return m_stackDepth;
+}
+
+double Common::AlgebraicBytecode::_run(const double *slots, double *stack) const
+{
+    // Top points one past the last operand, programs were checked for stack balance when emitted
+    double* top = stack;
+    const double* constants = m_constants.data();
+    for (const auto& it: m_instructions)
+    {
+        switch (it.opCode)
+        {
+            case Common::AlgebraicOpCode::PushConstant: *top++ = constants[it.operand]; break;
+            case Common::AlgebraicOpCode::PushVariable: *top++ = slots[it.operand]; break;
+            case Common::AlgebraicOpCode::Add: --top; top[-1] += *top; break;
+            case Common::AlgebraicOpCode::Substract: --top; top[-1] -= *top; break;
+            case Common::AlgebraicOpCode::Multiply: --top; top[-1] *= *top; break;
+            case Common::AlgebraicOpCode::Divide: --top; top[-1] /= *top; break;
+            case Common::AlgebraicOpCode::Power: --top; top[-1] = std::pow(top[-1], *top); break;
+            case Common::AlgebraicOpCode::Log: top[-1] = std::log(top[-1]); break;
+            case Common::AlgebraicOpCode::Exp: top[-1] = std::exp(top[-1]); break;
+            case Common::AlgebraicOpCode::Abs: top[-1] = std::fabs(top[-1]); break;
+            case Common::AlgebraicOpCode::Min: --top; top[-1] = Math::VectorKernels::minimum(top[-1], *top); break;
+            case Common::AlgebraicOpCode::Max: --top; top[-1] = Math::VectorKernels::maximum(top[-1], *top); break;
+            default: break;     // history instructions never reach the scalar machine
+        }
+    }
+
+    return stack[0];
+}
+
+void Common::AlgebraicBytecode::_checkBalanced() const
+{
+    if (m_stackSize != 1)
+        throw std::runtime_error("E: AlgebraicBytecode::evaluate : program does not leave exactly one value on the stack.");
+}
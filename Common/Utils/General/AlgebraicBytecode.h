@@ -0,0 +1,87 @@
+#ifndef WILDCATSTKCORE_ALGEBRAICBYTECODE_H
+#define WILDCATSTKCORE_ALGEBRAICBYTECODE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Common
+{
+    enum class AlgebraicOpCode : unsigned char
+    {
+        PushConstant,
+        PushVariable,
+        Add,
+        Substract,
+        Multiply,
+        Divide,
+        Power,
+        Log,
+        Exp,
+        Abs,
+        Min,
+        Max,
+        Lag,                // unary, operand is the number of rows
+        Diff,               // unary, x - lag(x, 1)
+        MovingAverage       // unary, operand is the window length
+    };
+
+    struct AlgebraicInstruction
+    {
+        Common::AlgebraicOpCode opCode;
+        unsigned int operand;       // constant or variable slot index for the push instructions, rows for lag and ma
+    };
+
+    //
+    // Postfix program for a small stack machine, compiled from an expression tree. Variables are resolved to dense
+    // slot indices at compile time (in order of first appearance, see getVariables) and values are passed in as a flat
+    // array indexed by slot, so evaluation does no hashing, no virtual dispatch and no allocation for stacks up to
+    // inlineStackDepth() deep.
+    //
+    // evaluateColumns runs the same program over whole series: each slot is a contiguous column and every
+    // instruction is applied to a block of columnBlockSize() rows at a time through the vector kernels, so the
+    // dispatch cost is paid once per block rather than once per row.
+    //
+    // Lag, Diff and MovingAverage read earlier rows, so programs using them only run through evaluateColumns, in one
+    // block spanning the whole series. Lagged operands are offset views into their column or scratch buffer rather
+    // than copies, and rows reaching before the start of the series are NaN.
+    //
+    class AlgebraicBytecode
+    {
+    public:
+        static constexpr std::size_t inlineStackDepth() { return 32; }
+        static constexpr std::size_t columnBlockSize() { return 256; }
+
+        void pushConstant(double constant);
+        void pushVariable(const std::string& variable);
+        void emit(Common::AlgebraicOpCode opCode, unsigned int operand = 0);
+        static bool isUnary(Common::AlgebraicOpCode opCode);
+        static bool isHistory(Common::AlgebraicOpCode opCode);
+        bool hasHistory() const;
+
+        double evaluate(const double* slots) const;
+        double evaluate(const std::vector<double>& slots) const;
+        void evaluateColumns(const double* const* columns, std::size_t length, double* out) const;
+
+        const std::vector<std::string>& getVariables() const;
+        std::size_t getSlotCount() const;
+        std::size_t getSlot(const std::string& variable) const;
+
+        const std::vector<Common::AlgebraicInstruction>& getInstructions() const;
+        const std::vector<double>& getConstants() const;
+        std::size_t getStackDepth() const;
+
+    private:
+        std::vector<Common::AlgebraicInstruction> m_instructions;
+        std::vector<double> m_constants;
+        std::vector<std::string> m_variables;
+        std::unordered_map<std::string, unsigned int> m_slots;
+        std::size_t m_stackSize = 0, m_stackDepth = 0;
+        bool m_hasHistory = false;
+
+        double _run(const double* slots, double* stack) const;
+        void _checkBalanced() const;
+    };
+}
+
+#endif //WILDCATSTKCORE_ALGEBRAICBYTECODE_H
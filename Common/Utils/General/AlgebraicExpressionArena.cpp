@@ -0,0 +1,162 @@
+#include <cmath>
+#include <stdexcept>
+#include "AlgebraicExpressionArena.h"
+#include "AlgebraicExpressionInterpreter.h"
+#include "../../Math/LinearAlgebra/VectorKernels.h"
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::addConstant(double constant)
+{
+    m_constants.push_back(constant);
+    return _append({Common::AlgebraicOpCode::PushConstant, static_cast<NodeIndex>(m_constants.size() - 1), 0});
+}
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::addVariable(const std::string &variable)
+{
+    // Names are stored once per arena, repeated occurrences only add a node
+    const auto it = m_variableIds.emplace(variable, static_cast<NodeIndex>(m_variables.size()));
+    if (it.second)
+        m_variables.push_back(variable);
+
+    return _append({Common::AlgebraicOpCode::PushVariable, it.first -> second, 0});
+}
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::addOperator(Common::AlgebraicOpCode opCode,
+                                                                                         NodeIndex lhs, NodeIndex rhs)
+{
+    if (opCode == Common::AlgebraicOpCode::PushConstant or opCode == Common::AlgebraicOpCode::PushVariable)
+        throw std::runtime_error("E: AlgebraicExpressionArena::addOperator : push codes are not operators.");
+    if (Common::AlgebraicBytecode::isHistory(opCode))
+        throw std::runtime_error("E: AlgebraicExpressionArena::addOperator : lag, diff and ma are added with addFunction.");
+    if (lhs >= m_nodes.size() or rhs >= m_nodes.size())
+        throw std::out_of_range("E: AlgebraicExpressionArena::addOperator : operand is not in the arena.");
+
+    return _append({opCode, lhs, rhs});
+}
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::addFunction(Common::AlgebraicOpCode opCode,
+                                                                                         NodeIndex argument, unsigned int rows)
+{
+    if (opCode == Common::AlgebraicOpCode::PushConstant or opCode == Common::AlgebraicOpCode::PushVariable or
+        !Common::AlgebraicBytecode::isUnary(opCode))
+        throw std::runtime_error("E: AlgebraicExpressionArena::addFunction : function codes take a single argument.");
+    if (argument >= m_nodes.size())
+        throw std::out_of_range("E: AlgebraicExpressionArena::addFunction : argument is not in the arena.");
+
+    return _append({opCode, argument, Common::AlgebraicBytecode::isHistory(opCode) ? rows : 0});
+}
+
+void Common::AlgebraicExpressionArena::setRoot(NodeIndex root)
+{
+    if (root >= m_nodes.size())
+        throw std::out_of_range("E: AlgebraicExpressionArena::setRoot : root is not in the arena.");
+
+    m_root = root;
+}
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::getRoot() const
+{
+    return m_root;
+}
+
+double Common::AlgebraicExpressionArena::evaluate(const Common::AlgebraicExpressionContext &context) const
+{
+    if (m_nodes.empty())
+        throw std::runtime_error("E: AlgebraicExpressionArena::evaluate : empty expression.");
+
+    return _evaluate(m_root, [this, &context](NodeIndex variable) { return context.getValue(m_variables[variable]); });
+}
+
+double Common::AlgebraicExpressionArena::evaluate(const double* values) const
+{
+    if (m_nodes.empty())
+        throw std::runtime_error("E: AlgebraicExpressionArena::evaluate : empty expression.");
+
+    return _evaluate(m_root, [values](NodeIndex variable) { return values[variable]; });
+}
+
+void Common::AlgebraicExpressionArena::emit(Common::AlgebraicBytecode &code) const
+{
+    if (m_nodes.empty())
+        throw std::runtime_error("E: AlgebraicExpressionArena::emit : empty expression.");
+
+    _emit(m_root, code);
+}
+
+std::size_t Common::AlgebraicExpressionArena::size() const
+{
+    return m_nodes.size();
+}
+
+const Common::AlgebraicExpressionArena::Node& Common::AlgebraicExpressionArena::getNode(NodeIndex node) const
+{
+    return m_nodes.at(node);
+}
+
+double Common::AlgebraicExpressionArena::getConstant(const Node &node) const
+{
+    return m_constants.at(node.lhs);
+}
+
+const std::string& Common::AlgebraicExpressionArena::getVariable(const Node &node) const
+{
+    return m_variables.at(node.lhs);
+}
+
+const std::vector<std::string>& Common::AlgebraicExpressionArena::getVariables() const
+{
+    return m_variables;
+}
+
+Common::AlgebraicExpressionArena::NodeIndex Common::AlgebraicExpressionArena::_append(const Node &node)
+{
+    m_nodes.push_back(node);
+    m_root = static_cast<NodeIndex>(m_nodes.size() - 1);
+    return m_root;
+}
+
+template <typename VariableReader>
+double Common::AlgebraicExpressionArena::_evaluate(NodeIndex node, const VariableReader &variable) const
+{
+    const Node& n = m_nodes[node];
+    switch (n.opCode)
+    {
+        case Common::AlgebraicOpCode::PushConstant: return m_constants[n.lhs];
+        case Common::AlgebraicOpCode::PushVariable: return variable(n.lhs);
+        case Common::AlgebraicOpCode::Add: return _evaluate(n.lhs, variable) + _evaluate(n.rhs, variable);
+        case Common::AlgebraicOpCode::Substract: return _evaluate(n.lhs, variable) - _evaluate(n.rhs, variable);
+        case Common::AlgebraicOpCode::Multiply: return _evaluate(n.lhs, variable) * _evaluate(n.rhs, variable);
+        case Common::AlgebraicOpCode::Divide: return _evaluate(n.lhs, variable) / _evaluate(n.rhs, variable);
+        case Common::AlgebraicOpCode::Power: return std::pow(_evaluate(n.lhs, variable), _evaluate(n.rhs, variable));
+        case Common::AlgebraicOpCode::Log: return std::log(_evaluate(n.lhs, variable));
+        case Common::AlgebraicOpCode::Exp: return std::exp(_evaluate(n.lhs, variable));
+        case Common::AlgebraicOpCode::Abs: return std::fabs(_evaluate(n.lhs, variable));
+        case Common::AlgebraicOpCode::Min: return Math::VectorKernels::minimum(_evaluate(n.lhs, variable), _evaluate(n.rhs, variable));
+        case Common::AlgebraicOpCode::Max: return Math::VectorKernels::maximum(_evaluate(n.lhs, variable), _evaluate(n.rhs, variable));
+        case Common::AlgebraicOpCode::Lag:
+        case Common::AlgebraicOpCode::Diff:
+        case Common::AlgebraicOpCode::MovingAverage:
+            throw std::runtime_error("E: AlgebraicExpressionArena::evaluate : lag, diff and ma need whole series, "
+                                     "evaluate the bytecode over columns instead.");
+    }
+
+    return 0.;
+}
+
+void Common::AlgebraicExpressionArena::_emit(NodeIndex node, Common::AlgebraicBytecode &code) const
+{
+    const Node& n = m_nodes[node];
+    switch (n.opCode)
+    {
+        case Common::AlgebraicOpCode::PushConstant:
+            code.pushConstant(m_constants[n.lhs]);
+            break;
+        case Common::AlgebraicOpCode::PushVariable:
+            code.pushVariable(m_variables[n.lhs]);
+            break;
+        default:
+            _emit(n.lhs, code);
+            if (!Common::AlgebraicBytecode::isUnary(n.opCode))
+                _emit(n.rhs, code);
+            code.emit(n.opCode, Common::AlgebraicBytecode::isHistory(n.opCode) ? n.rhs : 0);
+    }
+}
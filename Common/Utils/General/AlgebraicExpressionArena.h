@@ -0,0 +1,62 @@
+#ifndef WILDCATSTKCORE_ALGEBRAICEXPRESSIONARENA_H
+#define WILDCATSTKCORE_ALGEBRAICEXPRESSIONARENA_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "AlgebraicBytecode.h"
+
+namespace Common
+{
+    class AlgebraicExpressionContext;
+
+    //
+    // Expression tree stored as one flat array of nodes. Nodes are appended once, in place, as the parser reduces them
+    // and refer to their operands by index, so building an n-node tree costs n appends and no copies, and the whole
+    // tree is released at once with the arena. Operands always precede the nodes using them and the last node appended
+    // by a complete parse is the root. Once built the arena is immutable and compiled formulas share it by pointer.
+    //
+    class AlgebraicExpressionArena
+    {
+    public:
+        typedef unsigned int NodeIndex;
+
+        struct Node
+        {
+            Common::AlgebraicOpCode opCode;
+            NodeIndex lhs, rhs;         // operands, constant index / variable index for the push codes, rows for lag and ma
+        };
+
+        NodeIndex addConstant(double constant);
+        NodeIndex addVariable(const std::string& variable);
+        NodeIndex addOperator(Common::AlgebraicOpCode opCode, NodeIndex lhs, NodeIndex rhs);
+        NodeIndex addFunction(Common::AlgebraicOpCode opCode, NodeIndex argument, unsigned int rows = 0);
+
+        void setRoot(NodeIndex root);
+        NodeIndex getRoot() const;
+
+        double evaluate(const Common::AlgebraicExpressionContext& context) const;
+        double evaluate(const double* values) const;        // values of getVariables(), in order
+        void emit(Common::AlgebraicBytecode& code) const;
+
+        std::size_t size() const;
+        const Node& getNode(NodeIndex node) const;
+        double getConstant(const Node& node) const;
+        const std::string& getVariable(const Node& node) const;
+        const std::vector<std::string>& getVariables() const;
+
+    private:
+        std::vector<Node> m_nodes;
+        std::vector<double> m_constants;
+        std::vector<std::string> m_variables;
+        std::unordered_map<std::string, NodeIndex> m_variableIds;
+        NodeIndex m_root = 0;
+
+        NodeIndex _append(const Node& node);
+        template <typename VariableReader>
+        double _evaluate(NodeIndex node, const VariableReader& variable) const;
+        void _emit(NodeIndex node, Common::AlgebraicBytecode& code) const;
+    };
+}
+
+#endif //WILDCATSTKCORE_ALGEBRAICEXPRESSIONARENA_H
@@ -3,7 +3,10 @@
 //
 
 #include <cmath>
+#include <stdexcept>
 #include "AlgebraicExpressionInterpreter.h"
+#include "AlgebraicBytecode.h"
+#include "AlgebraicLexer.h"
 #include "../../../Global/Symbols/AlgebraicOperatorSymbols.h"
 
 //AlgebraicOperatorsGrammar class implementation
@@ -63,8 +66,8 @@ bool Common::AlgebraicOperatorsGrammar::isOperator(const std::string &symbol) co
 
 bool Common::AlgebraicOperatorsGrammar::isFunction(const std::string &symbol) const
 {
-    //Currently functions are not supported
-    return false;
+    Common::AlgebraicOpCode opCode;
+    return Common::AlgebraicOperatorTable::function(symbol.data(), symbol.size(), opCode);
 }
 
 bool Common::AlgebraicOperatorsGrammar::isLeftBracket(const std::string &symbol) const
@@ -88,7 +91,8 @@ std::string Common::AlgebraicOperatorsGrammar::getCharOperators() const
     ptr -> getDivisionSymbol() +
     ptr -> getExponentiationSymbol() +
     ptr -> getLeftBracketSymbol() +
-    ptr -> getRightBracketSymbol();
+    ptr -> getRightBracketSymbol() +
+    ptr -> getArgumentSeparatorSymbol();
 }
 
 std::unique_ptr<Common::OperatorsGrammar> Common::AlgebraicOperatorsGrammar::clone() const
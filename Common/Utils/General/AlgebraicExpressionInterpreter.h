@@ -31,6 +31,7 @@ namespace Common
         virtual ~OperatorsGrammar() = default;
     };
 
+    // Algebraic grammar over the symbols of Global::AlgebraicOperatorSymbols, functions are those of AlgebraicOperatorTable
     class AlgebraicOperatorsGrammar : public OperatorsGrammar
     {
     public:
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include "AlgebraicFormulaSet.h"
+#include "Tools.h"
+#include "../../Auxiliary/AuxiliaryVariable.h"
+#include "../../Math/LinearAlgebra/VectorKernels.h"
+#include "../../Types/AlignedColumns.h"
+#include "../../Types/DataSet.h"
+#include "../../Types/TimeSeries.h"
+
+namespace
+{
+    double applyOperator(Common::AlgebraicOpCode opCode, double lhs, double rhs)
+    {
+        switch (opCode)
+        {
+            case Common::AlgebraicOpCode::Add: return lhs + rhs;
+            case Common::AlgebraicOpCode::Substract: return lhs - rhs;
+            case Common::AlgebraicOpCode::Multiply: return lhs * rhs;
+            case Common::AlgebraicOpCode::Divide: return lhs / rhs;
+            case Common::AlgebraicOpCode::Power: return std::pow(lhs, rhs);
+            case Common::AlgebraicOpCode::Log: return std::log(lhs);
+            case Common::AlgebraicOpCode::Exp: return std::exp(lhs);
+            case Common::AlgebraicOpCode::Abs: return std::fabs(lhs);
+            case Common::AlgebraicOpCode::Min: return Math::VectorKernels::minimum(lhs, rhs);
+            case Common::AlgebraicOpCode::Max: return Math::VectorKernels::maximum(lhs, rhs);
+            default: throw std::runtime_error("E: AlgebraicFormulaSet : push instruction used as an operator.");
+        }
+    }
+
+    void applyKernel(Common::AlgebraicOpCode opCode, const double* lhs, const double* rhs, double* out, std::size_t n)
+    {
+        switch (opCode)
+        {
+            case Common::AlgebraicOpCode::Add: Math::VectorKernels::add(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Substract: Math::VectorKernels::substract(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Multiply: Math::VectorKernels::multiply(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Divide: Math::VectorKernels::divide(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Power: Math::VectorKernels::power(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Log: Math::VectorKernels::log(lhs, out, n); break;
+            case Common::AlgebraicOpCode::Exp: Math::VectorKernels::exp(lhs, out, n); break;
+            case Common::AlgebraicOpCode::Abs: Math::VectorKernels::abs(lhs, out, n); break;
+            case Common::AlgebraicOpCode::Min: Math::VectorKernels::minimum(lhs, rhs, out, n); break;
+            case Common::AlgebraicOpCode::Max: Math::VectorKernels::maximum(lhs, rhs, out, n); break;
+            default: throw std::runtime_error("E: AlgebraicFormulaSet : push instruction used as an operator.");
+        }
+    }
+}
+
+Common::AlgebraicFormulaSet::AlgebraicFormulaSet(const Common::OperatorsGrammar &grammar) : m_grammar(grammar.clone())
+{
+
+}
+
+std::size_t Common::AlgebraicFormulaSet::addFormula(const std::string &name, const std::string &expression)
+{
+    Common::AlgebraicExpressionParser parser(expression, *m_grammar);
+    return addFormula(name, parser.compileBytecode());
+}
+
+std::size_t Common::AlgebraicFormulaSet::addFormula(const std::string &name, const Common::AlgebraicBytecode &code)
+{
+    // The postfix program is a faithful walk of the expression tree, the graph is rebuilt from it bottom up
+    if (code.hasHistory())
+        throw std::runtime_error("E: AlgebraicFormulaSet::addFormula : formula " + name + " reads earlier rows through lag, "
+                                 "diff or ma, which formula sets do not support.");
+    std::vector<unsigned int> stack;
+    for (const auto& it: code.getInstructions())
+    {
+        if (it.opCode == Common::AlgebraicOpCode::PushConstant)
+            stack.push_back(_constant(code.getConstants().at(it.operand)));
+        else if (it.opCode == Common::AlgebraicOpCode::PushVariable)
+            stack.push_back(_variable(code.getVariables().at(it.operand)));
+        else if (Common::AlgebraicBytecode::isUnary(it.opCode))
+            stack.back() = _operator(it.opCode, stack.back(), stack.back());
+        else
+        {
+            const unsigned int rhs = stack.back();
+            stack.pop_back();
+            stack.back() = _operator(it.opCode, stack.back(), rhs);
+        }
+    }
+
+    if (stack.size() != 1)
+        throw std::runtime_error("E: AlgebraicFormulaSet::addFormula : formula " + name + " is not a single expression.");
+
+    m_formulas.emplace_back(name, stack.back());
+    return m_formulas.size() - 1;
+}
+
+std::size_t Common::AlgebraicFormulaSet::addFormula(const Common::AuxiliaryVariable &variable)
+{
+    return addFormula(variable.getAuxiliaryVariableName(), variable.getAuxiliaryVariableExpression());
+}
+
+std::size_t Common::AlgebraicFormulaSet::getFormulaCount() const
+{
+    return m_formulas.size();
+}
+
+std::string Common::AlgebraicFormulaSet::getFormulaName(std::size_t formula) const
+{
+    return m_formulas.at(formula).first;
+}
+
+std::size_t Common::AlgebraicFormulaSet::getNodeCount() const
+{
+    return m_nodes.size();
+}
+
+const std::vector<std::string>& Common::AlgebraicFormulaSet::getVariables() const
+{
+    return m_variables;
+}
+
+std::vector<double> Common::AlgebraicFormulaSet::evaluate(const std::vector<double> &slots) const
+{
+    if (slots.size() < m_variables.size())
+        throw std::out_of_range("E: AlgebraicFormulaSet::evaluate : " + std::to_string(m_variables.size()) +
+                                " slots expected, " + std::to_string(slots.size()) + " given.");
+
+    std::vector<double> values(m_nodes.size());
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const Node& node = m_nodes[i];
+        if (node.opCode == Common::AlgebraicOpCode::PushConstant)
+            values[i] = m_constants[node.lhs];
+        else if (node.opCode == Common::AlgebraicOpCode::PushVariable)
+            values[i] = slots[node.lhs];
+        else
+            values[i] = applyOperator(node.opCode, values[node.lhs], values[node.rhs]);
+    }
+
+    std::vector<double> results;
+    results.reserve(m_formulas.size());
+    for (const auto& it: m_formulas)
+        results.push_back(values[it.second]);
+
+    return results;
+}
+
+std::vector<Common::TimeSeries> Common::AlgebraicFormulaSet::evaluateSeries(const Common::DataSet &ds) const
+{
+    // Formulas reading the same inputs are aligned and computed together, each group on the dates its own inputs
+    // have in common, so that every formula gets the rows it would get alone
+    const std::vector<std::vector<unsigned int>> formulaInputs = _formulaInputs();
+    std::map<std::vector<unsigned int>, std::vector<std::size_t>> groups;
+    for (std::size_t i = 0; i < m_formulas.size(); ++i)
+    {
+        if (formulaInputs[i].empty())
+            throw std::runtime_error("E: AlgebraicFormulaSet::evaluateSeries : formula " + m_formulas[i].first +
+                                     " has no input variable to take dates from.");
+        groups[formulaInputs[i]].push_back(i);
+    }
+
+    std::vector<std::vector<double>> results(m_formulas.size());
+    std::vector<std::shared_ptr<const Common::Calendar>> calendars(m_formulas.size());
+    std::vector<const Common::TimeSeries*> inputs;
+    std::vector<const double*> variableColumns(m_variables.size());
+    for (const auto& group: groups)
+    {
+        inputs.clear();
+        for (const auto& it: group.first)
+            inputs.push_back(&ds.getTimeSeriesRef(m_variables[it]));
+        const Common::AlignedColumns aligned(inputs);
+        for (std::size_t i = 0; i < group.first.size(); ++i)
+            variableColumns[group.first[i]] = aligned.getColumn(i);
+
+        _evaluateColumns(group.second, variableColumns.data(), aligned.getRowCount(), results);
+        for (const auto& it: group.second)
+            calendars[it] = aligned.getCalendar();
+    }
+
+    std::vector<Common::TimeSeries> series;
+    series.reserve(m_formulas.size());
+    for (std::size_t i = 0; i < m_formulas.size(); ++i)
+        series.emplace_back(m_formulas[i].first, std::move(results[i]), calendars[i]);
+
+    return series;
+}
+
+std::size_t Common::AlgebraicFormulaSet::NodeHash::operator()(const Node &node) const
+{
+    std::size_t rv = std::hash<int>()(static_cast<int>(node.opCode));
+    rv ^= std::hash<unsigned int>()(node.lhs) + 0x9e3779b97f4a7c15ull + (rv << 6) + (rv >> 2);
+    rv ^= std::hash<unsigned int>()(node.rhs) + 0x9e3779b97f4a7c15ull + (rv << 6) + (rv >> 2);
+    return rv;
+}
+
+bool Common::AlgebraicFormulaSet::NodeEqual::operator()(const Node &lhs, const Node &rhs) const
+{
+    return lhs.opCode == rhs.opCode and lhs.lhs == rhs.lhs and lhs.rhs == rhs.rhs;
+}
+
+unsigned int Common::AlgebraicFormulaSet::_node(const Node &node)
+{
+    const auto it = m_nodeIds.emplace(node, static_cast<unsigned int>(m_nodes.size()));
+    if (it.second)
+        m_nodes.push_back(node);
+
+    return it.first -> second;
+}
+
+unsigned int Common::AlgebraicFormulaSet::_constant(double constant)
+{
+    // Constants are identified by bit pattern, so that 0 and -0 stay distinct
+    std::uint64_t bits;
+    std::memcpy(&bits, &constant, sizeof(bits));
+    const auto it = m_constantIds.emplace(bits, static_cast<unsigned int>(m_constants.size()));
+    if (it.second)
+        m_constants.push_back(constant);
+
+    return _node({Common::AlgebraicOpCode::PushConstant, it.first -> second, 0});
+}
+
+unsigned int Common::AlgebraicFormulaSet::_variable(const std::string &variable)
+{
+    const auto it = m_slots.emplace(variable, static_cast<unsigned int>(m_variables.size()));
+    if (it.second)
+        m_variables.push_back(variable);
+
+    return _node({Common::AlgebraicOpCode::PushVariable, it.first -> second, 0});
+}
+
+unsigned int Common::AlgebraicFormulaSet::_operator(Common::AlgebraicOpCode opCode, unsigned int lhs, unsigned int rhs)
+{
+    const bool isUnary = Common::AlgebraicBytecode::isUnary(opCode);
+    if (isUnary)
+        rhs = lhs;
+
+    const bool isLhsConstant = m_nodes[lhs].opCode == Common::AlgebraicOpCode::PushConstant;
+    const bool isRhsConstant = m_nodes[rhs].opCode == Common::AlgebraicOpCode::PushConstant;
+    if (isLhsConstant and isRhsConstant)
+        return _constant(applyOperator(opCode, _constantValue(lhs), _constantValue(rhs)));
+
+    switch (opCode)
+    {
+        case Common::AlgebraicOpCode::Add:
+            if (_isConstant(rhs, -0.))          // x + 0 is +0 for x = -0, only -0 is an identity
+                return lhs;
+            if (_isConstant(lhs, -0.))
+                return rhs;
+            break;
+        case Common::AlgebraicOpCode::Substract:
+            if (_isConstant(rhs, 0.))
+                return lhs;
+            break;
+        case Common::AlgebraicOpCode::Multiply:
+            if (_isConstant(rhs, 1.))
+                return lhs;
+            if (_isConstant(lhs, 1.))
+                return rhs;
+            break;
+        case Common::AlgebraicOpCode::Divide:
+            if (_isConstant(rhs, 1.))
+                return lhs;
+            break;
+        case Common::AlgebraicOpCode::Power:
+            if (_isConstant(rhs, 1.))
+                return lhs;
+            if (_isConstant(rhs, 0.))
+                return _constant(1.);       // pow(x, 0) is 1 for every x, NaN included
+            if (_isConstant(rhs, 2.))
+                return _operator(Common::AlgebraicOpCode::Multiply, lhs, lhs);
+            break;
+        default:
+            break;
+    }
+
+    // Commutative operators get a canonical operand order so that a+b and b+a end up in the same node
+    if ((opCode == Common::AlgebraicOpCode::Add or opCode == Common::AlgebraicOpCode::Multiply or
+         opCode == Common::AlgebraicOpCode::Min or opCode == Common::AlgebraicOpCode::Max) and rhs < lhs)
+        std::swap(lhs, rhs);
+
+    return _node({opCode, lhs, rhs});
+}
+
+bool Common::AlgebraicFormulaSet::_isConstant(unsigned int node, double value) const
+{
+    return m_nodes[node].opCode == Common::AlgebraicOpCode::PushConstant and _constantValue(node) == value and
+           std::signbit(_constantValue(node)) == std::signbit(value);
+}
+
+double Common::AlgebraicFormulaSet::_constantValue(unsigned int node) const
+{
+    return m_constants[m_nodes[node].lhs];
+}
+
+void Common::AlgebraicFormulaSet::_evaluateColumns(const std::vector<std::size_t> &formulas, const double* const* variableColumns,
+                                                   std::size_t length, std::vector<std::vector<double>> &results) const
+{
+    // Only the nodes the formulas depend on are computed, once per block of rows
+    std::vector<bool> isUsed(m_nodes.size(), false);
+    for (const auto& it: formulas)
+        isUsed[m_formulas[it].second] = true;
+    for (std::size_t i = m_nodes.size(); i-- > 0;)
+        if (isUsed[i] and m_nodes[i].opCode != Common::AlgebraicOpCode::PushConstant and
+            m_nodes[i].opCode != Common::AlgebraicOpCode::PushVariable)
+            isUsed[m_nodes[i].lhs] = isUsed[m_nodes[i].rhs] = true;
+
+    // Each node gets a block of rows, taken back once its last user has run so that later nodes reuse it. Constants
+    // are filled once and formula roots are copied out after every block, so both keep their block throughout.
+    std::vector<std::size_t> lastUse(m_nodes.size(), 0);
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+        if (isUsed[i] and m_nodes[i].opCode != Common::AlgebraicOpCode::PushConstant and
+            m_nodes[i].opCode != Common::AlgebraicOpCode::PushVariable)
+            lastUse[m_nodes[i].lhs] = lastUse[m_nodes[i].rhs] = i;
+    for (const auto& it: formulas)
+        lastUse[m_formulas[it].second] = m_nodes.size();
+
+    const std::size_t blockSize = Common::AlgebraicBytecode::columnBlockSize();
+    std::vector<std::size_t> blocks(m_nodes.size()), freeBlocks;
+    std::size_t blockCount = 0;
+    const auto release = [&](unsigned int node)
+    {
+        if (lastUse[node] < m_nodes.size() and m_nodes[node].opCode != Common::AlgebraicOpCode::PushVariable and
+            m_nodes[node].opCode != Common::AlgebraicOpCode::PushConstant)
+            freeBlocks.push_back(blocks[node]);
+    };
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const Node& node = m_nodes[i];
+        if (!isUsed[i] or node.opCode == Common::AlgebraicOpCode::PushVariable)
+            continue;
+        if (node.opCode == Common::AlgebraicOpCode::PushConstant or freeBlocks.empty())
+            blocks[i] = blockCount++;
+        else
+        {
+            blocks[i] = freeBlocks.back();
+            freeBlocks.pop_back();
+        }
+        // Operands are released after the output block is taken, a kernel never writes over its own input
+        if (node.opCode != Common::AlgebraicOpCode::PushConstant)
+        {
+            if (lastUse[node.lhs] == i)
+                release(node.lhs);
+            if (node.rhs != node.lhs and lastUse[node.rhs] == i)
+                release(node.rhs);
+        }
+    }
+
+    std::vector<double> buffers(blockCount * blockSize);
+    std::vector<const double*> columns(m_nodes.size());
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+        if (isUsed[i] and m_nodes[i].opCode == Common::AlgebraicOpCode::PushConstant)
+        {
+            Math::VectorKernels::fill(m_constants[m_nodes[i].lhs], buffers.data() + blocks[i] * blockSize, blockSize);
+            columns[i] = buffers.data() + blocks[i] * blockSize;
+        }
+
+    for (const auto& it: formulas)
+        results[it].resize(length);
+    for (std::size_t first = 0; first < length; first += blockSize)
+    {
+        const std::size_t n = std::min(blockSize, length - first);
+        for (std::size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            const Node& node = m_nodes[i];
+            if (!isUsed[i] or node.opCode == Common::AlgebraicOpCode::PushConstant)
+                continue;
+            if (node.opCode == Common::AlgebraicOpCode::PushVariable)
+                columns[i] = variableColumns[node.lhs] + first;
+            else
+            {
+                double* out = buffers.data() + blocks[i] * blockSize;
+                applyKernel(node.opCode, columns[node.lhs], columns[node.rhs], out, n);
+                columns[i] = out;
+            }
+        }
+
+        for (const auto& it: formulas)
+            std::copy(columns[m_formulas[it].second], columns[m_formulas[it].second] + n, results[it].begin() + first);
+    }
+}
+
+std::vector<std::vector<unsigned int>> Common::AlgebraicFormulaSet::_formulaInputs() const
+{
+    // Input sets are interned and built bottom up, each distinct pair of operand sets merged once
+    std::vector<std::vector<unsigned int>> sets(1);
+    std::map<std::vector<unsigned int>, unsigned int> setIds = {{{}, 0}};
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> unions;
+    const auto intern = [&sets, &setIds](std::vector<unsigned int> set)
+    {
+        const auto it = setIds.emplace(std::move(set), static_cast<unsigned int>(sets.size()));
+        if (it.second)
+            sets.push_back(it.first -> first);
+        return it.first -> second;
+    };
+
+    std::vector<unsigned int> nodeSets(m_nodes.size(), 0);
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const Node& node = m_nodes[i];
+        if (node.opCode == Common::AlgebraicOpCode::PushVariable)
+            nodeSets[i] = intern({node.lhs});
+        else if (node.opCode != Common::AlgebraicOpCode::PushConstant)
+        {
+            const unsigned int lhs = std::min(nodeSets[node.lhs], nodeSets[node.rhs]);
+            const unsigned int rhs = std::max(nodeSets[node.lhs], nodeSets[node.rhs]);
+            if (lhs == 0 or lhs == rhs)
+                nodeSets[i] = rhs;
+            else
+            {
+                const auto it = unions.find({lhs, rhs});
+                if (it != unions.end())
+                    nodeSets[i] = it -> second;
+                else
+                {
+                    std::vector<unsigned int> merged;
+                    std::set_union(sets[lhs].begin(), sets[lhs].end(), sets[rhs].begin(), sets[rhs].end(),
+                                   std::back_inserter(merged));
+                    nodeSets[i] = unions[{lhs, rhs}] = intern(std::move(merged));
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned int>> rv;
+    rv.reserve(m_formulas.size());
+    for (const auto& it: m_formulas)
+        rv.push_back(sets[nodeSets[it.second]]);
+
+    return rv;
+}
\ No newline at end of file
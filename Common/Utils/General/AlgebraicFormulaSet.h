@@ -0,0 +1,86 @@
+#ifndef WILDCATSTKCORE_ALGEBRAICFORMULASET_H
+#define WILDCATSTKCORE_ALGEBRAICFORMULASET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "AlgebraicBytecode.h"
+#include "AlgebraicExpressionInterpreter.h"
+
+namespace Common
+{
+    class DataSet;
+    class TimeSeries;
+    class AuxiliaryVariable;
+
+    //
+    // Batch of formulas compiled into one shared expression graph. Nodes are hash-consed as they are built, so a
+    // sub-expression that appears several times, within a formula or across formulas, becomes a single node and is
+    // computed once per evaluation. While building, the graph also
+    //   - folds operators whose operands are all constants,
+    //   - strength-reduces x^2 to x*x,
+    //   - removes the identities x-0, x+(-0), (-0)+x, x*1, 1*x, x/1 and x^1, and replaces x^0 with 1,
+    //   - orders the operands of +, *, min and max so that a+b and b+a share a node.
+    // Every rewrite gives the same result for every operand, NaN, infinities and -0 included; rewrites that do not
+    // (x*0, x-x, x/x, x+0 for x = -0, x^0.5 for -inf and -0) are not applied. Rows are computed
+    // independently, so formulas using lag, diff or ma are rejected. Each formula is aligned on the dates its own
+    // inputs have in common, as a single FormulaVariableAlgebraic would be; formulas sharing inputs are computed together.
+    //
+    class AlgebraicFormulaSet
+    {
+    public:
+        explicit AlgebraicFormulaSet(const Common::OperatorsGrammar& grammar);
+
+        std::size_t addFormula(const std::string& name, const std::string& expression);
+        std::size_t addFormula(const std::string& name, const Common::AlgebraicBytecode& code);
+        std::size_t addFormula(const Common::AuxiliaryVariable& variable);
+
+        std::size_t getFormulaCount() const;
+        std::string getFormulaName(std::size_t formula) const;
+        std::size_t getNodeCount() const;
+        const std::vector<std::string>& getVariables() const;
+
+        std::vector<double> evaluate(const std::vector<double>& slots) const;
+        std::vector<Common::TimeSeries> evaluateSeries(const Common::DataSet& ds) const;
+
+    private:
+        struct Node
+        {
+            Common::AlgebraicOpCode opCode;
+            unsigned int lhs, rhs;      // operand nodes, or constant index / variable slot for the push codes
+        };
+
+        struct NodeHash
+        {
+            std::size_t operator()(const Node& node) const;
+        };
+
+        struct NodeEqual
+        {
+            bool operator()(const Node& lhs, const Node& rhs) const;
+        };
+
+        std::unique_ptr<Common::OperatorsGrammar> m_grammar;
+        std::vector<Node> m_nodes;                      // operands always precede the nodes using them
+        std::unordered_map<Node, unsigned int, NodeHash, NodeEqual> m_nodeIds;
+        std::vector<double> m_constants;
+        std::unordered_map<std::uint64_t, unsigned int> m_constantIds;
+        std::unordered_map<std::string, unsigned int> m_slots;
+        std::vector<std::string> m_variables;
+        std::vector<std::pair<std::string, unsigned int>> m_formulas;
+
+        unsigned int _node(const Node& node);
+        unsigned int _constant(double constant);
+        unsigned int _variable(const std::string& variable);
+        unsigned int _operator(Common::AlgebraicOpCode opCode, unsigned int lhs, unsigned int rhs);
+        bool _isConstant(unsigned int node, double value) const;
+        double _constantValue(unsigned int node) const;
+        void _evaluateColumns(const std::vector<std::size_t>& formulas, const double* const* variableColumns, std::size_t length,
+                              std::vector<std::vector<double>>& results) const;
+        std::vector<std::vector<unsigned int>> _formulaInputs() const;
+    };
+}
+
+#endif //WILDCATSTKCORE_ALGEBRAICFORMULASET_H
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include "AlgebraicLexer.h"
+#include "AlgebraicExpressionInterpreter.h"
+#include "../../../Global/Mappings/FactoryMappings.h"
+#include "../../../Global/Symbols/AlgebraicOperatorSymbols.h"
+
+namespace
+{
+    struct FunctionEntry
+    {
+        const char* name;
+        Common::AlgebraicOpCode opCode;
+    };
+
+    constexpr FunctionEntry functions[] = {{"log", Common::AlgebraicOpCode::Log},
+                                           {"exp", Common::AlgebraicOpCode::Exp},
+                                           {"abs", Common::AlgebraicOpCode::Abs},
+                                           {"min", Common::AlgebraicOpCode::Min},
+                                           {"max", Common::AlgebraicOpCode::Max},
+                                           {"lag", Common::AlgebraicOpCode::Lag},
+                                           {"diff", Common::AlgebraicOpCode::Diff},
+                                           {"ma", Common::AlgebraicOpCode::MovingAverage}};
+}
+
+Common::AlgebraicOperatorTable::AlgebraicOperatorTable(const Common::OperatorsGrammar &grammar) :
+    m_lowestPriority(grammar.lowestPriority())
+{
+    for (int c = 0; c < 256; ++c)
+    {
+        m_classes[c] = c == ' ' or c == '\t' or c == '\n' or c == '\r' ? Whitespace : Identifier;
+        m_opCodes[c] = Common::AlgebraicOpCode::PushConstant;
+    }
+    std::fill(std::begin(m_priorities), std::end(m_priorities), 0);
+    std::fill(std::begin(m_isRightAssociative), std::end(m_isRightAssociative), false);
+
+    // Function arguments are always separated by the global separator, whatever the grammar
+    for (const char c: Global::AlgebraicOperatorSymbols::instance() -> getArgumentSeparatorSymbol())
+        m_classes[static_cast<unsigned char>(c)] = Comma;
+
+    for (const char c: grammar.getCharOperators())
+    {
+        const std::string symbol(1, c);
+        const unsigned char i = static_cast<unsigned char>(c);
+        if (grammar.isOperator(symbol))
+        {
+            const Common::AlgebraicOpCode opCode = Global::AlgebraicExpressionFactoryMapping::instance() -> getOpCode(symbol);
+            m_classes[i] = Operator;
+            m_opCodes[i] = opCode;
+            m_priorities[static_cast<std::size_t>(opCode)] = grammar.priority(symbol);
+            m_isRightAssociative[static_cast<std::size_t>(opCode)] = grammar.isRightAssociative(symbol);
+        }
+        else if (grammar.isLeftBracket(symbol))
+            m_classes[i] = LeftBracket;
+        else if (grammar.isRightBracket(symbol))
+            m_classes[i] = RightBracket;
+    }
+}
+
+bool Common::AlgebraicOperatorTable::function(const char *name, std::size_t length, Common::AlgebraicOpCode &opCode)
+{
+    for (const auto& it: functions)
+        if (std::strlen(it.name) == length and std::strncmp(it.name, name, length) == 0)
+        {
+            opCode = it.opCode;
+            return true;
+        }
+
+    return false;
+}
+
+void Common::AlgebraicLexer::tokenize(const std::string &source, const Common::AlgebraicOperatorTable &table,
+                                      std::vector<Common::AlgebraicToken> &tokens)
+{
+    typedef Common::AlgebraicOperatorTable Table;
+    const auto classOf = [&table](char c) { return table.charClass(c); };
+    const char* const begin = source.c_str();
+    const char* const end = begin + source.size();
+
+    for (const char* p = begin; p != end;)
+    {
+        const Table::CharClass charClass = classOf(*p);
+        const unsigned int offset = static_cast<unsigned int>(p - begin);
+        switch (charClass)
+        {
+            case Table::Whitespace:
+                ++p;
+                break;
+            case Table::Operator:
+                tokens.push_back({Common::AlgebraicTokenKind::Operator, table.opCode(*p), offset, 1, 0.});
+                ++p;
+                break;
+            case Table::LeftBracket:
+                tokens.push_back({Common::AlgebraicTokenKind::LeftBracket, Common::AlgebraicOpCode::PushConstant, offset, 1, 0.});
+                ++p;
+                break;
+            case Table::RightBracket:
+                tokens.push_back({Common::AlgebraicTokenKind::RightBracket, Common::AlgebraicOpCode::PushConstant, offset, 1, 0.});
+                ++p;
+                break;
+            case Table::Comma:
+                tokens.push_back({Common::AlgebraicTokenKind::Comma, Common::AlgebraicOpCode::PushConstant, offset, 1, 0.});
+                ++p;
+                break;
+            case Table::Identifier:
+            {
+                const char* runEnd = p;
+                while (runEnd != end and classOf(*runEnd) == Table::Identifier)
+                    ++runEnd;
+
+                if ((*p >= '0' and *p <= '9') or *p == '.')
+                {
+                    // A signed exponent runs past the first operator, e.g. 1.5e-2
+                    char* numberEnd = nullptr;
+                    const double value = std::strtod(p, &numberEnd);
+                    if (numberEnd == runEnd or (numberEnd > runEnd and (runEnd[-1] == 'e' or runEnd[-1] == 'E') and
+                                                (numberEnd == end or classOf(*numberEnd) != Table::Identifier)))
+                    {
+                        tokens.push_back({Common::AlgebraicTokenKind::Number, Common::AlgebraicOpCode::PushConstant,
+                                          offset, static_cast<unsigned int>(numberEnd - p), value});
+                        p = numberEnd;
+                        break;
+                    }
+                }
+
+                const char* next = runEnd;
+                while (next != end and classOf(*next) == Table::Whitespace)
+                    ++next;
+
+                Common::AlgebraicOpCode opCode = Common::AlgebraicOpCode::PushVariable;
+                const bool isFunction = next != end and classOf(*next) == Table::LeftBracket and
+                                        Table::function(p, static_cast<std::size_t>(runEnd - p), opCode);
+                tokens.push_back({isFunction ? Common::AlgebraicTokenKind::Function : Common::AlgebraicTokenKind::Identifier,
+                                  opCode, offset, static_cast<unsigned int>(runEnd - p), 0.});
+                p = runEnd;
+                break;
+            }
+        }
+    }
+}
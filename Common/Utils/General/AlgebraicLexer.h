@@ -0,0 +1,98 @@
+#ifndef WILDCATSTKCORE_ALGEBRAICLEXER_H
+#define WILDCATSTKCORE_ALGEBRAICLEXER_H
+
+#include <string>
+#include <vector>
+#include "AlgebraicBytecode.h"
+
+namespace Common
+{
+    class OperatorsGrammar;
+
+    //
+    // Character classes, precedence and associativity of an OperatorsGrammar, resolved once into tables indexed by
+    // character and by op code so that lexing and parsing do no string lookups. Operator and bracket symbols are the
+    // single characters listed by OperatorsGrammar::getCharOperators, operators are mapped to op codes through
+    // Global::AlgebraicExpressionFactoryMapping. Functions are called as name(arguments), arguments being separated by
+    // commas: log, exp, abs, diff take one expression, min and max two, lag(x, k) and ma(x, n) an expression and an
+    // integer number of rows.
+    //
+    class AlgebraicOperatorTable
+    {
+    public:
+        enum CharClass : unsigned char
+        {
+            Identifier,
+            Whitespace,
+            Operator,
+            LeftBracket,
+            RightBracket,
+            Comma
+        };
+
+        explicit AlgebraicOperatorTable(const Common::OperatorsGrammar& grammar);
+
+        unsigned int lowestPriority() const { return m_lowestPriority; }
+        unsigned int priority(Common::AlgebraicOpCode opCode) const { return m_priorities[static_cast<std::size_t>(opCode)]; }
+        bool isRightAssociative(Common::AlgebraicOpCode opCode) const { return m_isRightAssociative[static_cast<std::size_t>(opCode)]; }
+
+        CharClass charClass(char c) const { return m_classes[static_cast<unsigned char>(c)]; }
+        Common::AlgebraicOpCode opCode(char c) const { return m_opCodes[static_cast<unsigned char>(c)]; }  // Operator class only
+
+        static constexpr unsigned int functionArity(Common::AlgebraicOpCode opCode)
+        {
+            return opCode == Common::AlgebraicOpCode::Min or opCode == Common::AlgebraicOpCode::Max or
+                   opCode == Common::AlgebraicOpCode::Lag or opCode == Common::AlgebraicOpCode::MovingAverage ? 2 : 1;
+        }
+
+        static bool function(const char* name, std::size_t length, Common::AlgebraicOpCode& opCode);
+
+    private:
+        static constexpr std::size_t opCodeCount = static_cast<std::size_t>(Common::AlgebraicOpCode::MovingAverage) + 1;
+
+        CharClass m_classes[256];
+        Common::AlgebraicOpCode m_opCodes[256];
+        unsigned int m_priorities[opCodeCount];
+        bool m_isRightAssociative[opCodeCount];
+        unsigned int m_lowestPriority;
+    };
+
+
+    enum class AlgebraicTokenKind : unsigned char
+    {
+        Number,
+        Identifier,
+        Operator,
+        LeftBracket,
+        RightBracket,
+        Comma,
+        Function
+    };
+
+    // Token referring back into the lexed source by offset and length (the project is C++14, there is no string_view),
+    // numbers carry their parsed value and functions their code
+    struct AlgebraicToken
+    {
+        Common::AlgebraicTokenKind kind;
+        Common::AlgebraicOpCode opCode;
+        unsigned int offset, length;
+        double value;
+
+        std::string str(const std::string& source) const { return source.substr(offset, length); }
+    };
+
+    //
+    // Single pass lexer driven by a 256 entry character class table. Runs of identifier characters starting with a
+    // digit or a point are numbers when strtod consumes the whole run (or the run plus a signed exponent), and
+    // identifiers otherwise. Known function names directly followed by a bracket are function tokens. Tokens are
+    // appended to a caller owned vector, so lexing into a reused vector does not allocate.
+    //
+    class AlgebraicLexer
+    {
+    public:
+        static void tokenize(const std::string& source, const Common::AlgebraicOperatorTable& table,
+                             std::vector<Common::AlgebraicToken>& tokens);
+    };
+}
+
+#endif //WILDCATSTKCORE_ALGEBRAICLEXER_H
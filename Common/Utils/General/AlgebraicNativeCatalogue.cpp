@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <iterator>
+#include <map>
+#include <cerrno>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "AlgebraicNativeCatalogue.h"
+#include "Tools.h"
+#include "../../Types/DataSet.h"
+#include "../../Types/AlignedColumns.h"
+
+namespace
+{
+    const char* const compileFlags[] = {"-O3", "-std=c++11", "-shared", "-fPIC"};
+    const char* const symbolPrefix = "wildcat_formula_";
+
+    std::string formatConstant(double value)
+    {
+        if (std::isnan(value))
+            return "std::numeric_limits<double>::quiet_NaN()";
+        if (std::isinf(value))
+            return value > 0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        return buffer;
+    }
+
+    // Cached objects are only trusted in a cache nobody else can write to: the entry must be a regular file, or the
+    // directory, owned by this user and not writable by group or others. Symbolic links are not followed.
+    bool isPrivate(const std::string& path, bool isDirectory)
+    {
+        struct stat info;
+        if (::lstat(path.c_str(), &info) != 0)
+            return false;
+
+        return (isDirectory ? S_ISDIR(info.st_mode) : S_ISREG(info.st_mode)) and info.st_uid == ::geteuid() and
+               (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+    }
+
+    std::string keyPath(const std::string& library)
+    {
+        return library.substr(0, library.size() - 3) + ".key";
+    }
+}
+
+Common::AlgebraicNativeCatalogue::AlgebraicNativeCatalogue(const std::string &cacheDirectory, const std::string &compiler) :
+        m_cacheDirectory(cacheDirectory), m_compiler(compiler)
+{
+
+}
+
+std::size_t Common::AlgebraicNativeCatalogue::addFormula(const std::string &name, const std::string &expression,
+                                                         const Common::OperatorsGrammar &grammar)
+{
+    Common::AlgebraicExpressionParser parser(expression, grammar);
+    return addFormula(name, parser.getCompiled());
+}
+
+std::size_t Common::AlgebraicNativeCatalogue::addFormula(const std::string &name,
+                                                         const std::shared_ptr<const Common::AlgebraicExpressionArena> &formula)
+{
+    if (!formula or formula -> size() == 0)
+        throw std::runtime_error("E: AlgebraicNativeCatalogue::addFormula : empty expression given for " + name + ".");
+
+    // The interpreter program is always kept, it is the fallback whenever the native build is not available
+    Formula entry{name, formula, Common::AlgebraicBytecode(), {}};
+    formula -> emit(entry.bytecode);
+    for (const auto& it: entry.bytecode.getVariables())
+    {
+        const auto column = m_columns.emplace(it, m_variables.size()).first;
+        if (column -> second == m_variables.size())
+            m_variables.push_back(it);
+        entry.columns.push_back(column -> second);
+    }
+
+    m_formulas.push_back(std::move(entry));
+    m_isBuilt = false;
+    m_native.clear();
+    m_library.reset();
+
+    return m_formulas.size() - 1;
+}
+
+bool Common::AlgebraicNativeCatalogue::build()
+{
+    m_isBuilt = true;
+    m_native.clear();
+    m_library.reset();
+    if (std::all_of(m_formulas.begin(), m_formulas.end(), [](const Formula& formula) { return formula.bytecode.hasHistory(); }))
+        return false;
+
+    const std::string library = getLibraryPath(), key = _key();
+    ::mkdir(m_cacheDirectory.c_str(), 0700);
+    if (!isPrivate(m_cacheDirectory, true))
+        return false;
+    if (_load(library, key))
+        return true;
+
+    // Built under process unique names and renamed into place, so concurrent builds never load a partial object. The
+    // key goes in first, an object found in the cache always has the key it was built from next to it.
+    const std::string stem = library.substr(0, library.size() - 3) + "." + std::to_string(::getpid());
+    const std::string source = stem + ".cpp", partial = stem + ".so", partialKey = stem + ".key";
+    for (const auto& it: {std::make_pair(source, generateSource()), std::make_pair(partialKey, key)})
+    {
+        std::ofstream file(it.first, std::ios::out | std::ios::trunc);
+        file << it.second;
+        if (!file)
+            return false;
+    }
+
+    const bool isCompiled = _compile(source, partial) and std::rename(partialKey.c_str(), keyPath(library).c_str()) == 0 and
+                            std::rename(partial.c_str(), library.c_str()) == 0;
+    std::remove(source.c_str());
+    if (!isCompiled)
+    {
+        std::remove(partial.c_str());
+        std::remove(partialKey.c_str());
+        return false;
+    }
+
+    return _load(library, key);
+}
+
+bool Common::AlgebraicNativeCatalogue::isNative() const
+{
+    return std::any_of(m_native.begin(), m_native.end(), [](NativeFormula formula) { return formula != nullptr; });
+}
+
+std::string Common::AlgebraicNativeCatalogue::generateSource() const
+{
+    // The generated unit is built without the project headers, its minimum and maximum spell out the rule of
+    // Math::VectorKernels::minimum and maximum
+    std::string out = "// Generated by Common::AlgebraicNativeCatalogue, do not edit\n"
+                      "#include <cmath>\n#include <cstddef>\n#include <limits>\n\n"
+                      "static inline double minimum(double a, double b) { return a != a || b != b ? a + b : (b < a ? b : a); }\n"
+                      "static inline double maximum(double a, double b) { return a != a || b != b ? a + b : (b > a ? b : a); }\n";
+
+    for (std::size_t f = 0; f < m_formulas.size(); ++f)
+    {
+        const Formula& formula = m_formulas[f];
+        const Common::AlgebraicExpressionArena& arena = *formula.arena;
+        if (formula.bytecode.hasHistory())
+        {
+            out += "\n// formula " + std::to_string(f) + " reads earlier rows, it runs on the interpreter\n";
+            continue;
+        }
+
+        out += "\nextern \"C\" void " + std::string(symbolPrefix) + std::to_string(f) +
+               "(const double* const* columns, std::size_t length, double* out)\n{\n";
+        for (std::size_t i = 0; i < formula.columns.size(); ++i)
+            out += "    const double* const c" + std::to_string(i) + " = columns[" + std::to_string(formula.columns[i]) + "];\n";
+
+        // One local per arena node, operands always precede the nodes using them
+        out += "    for (std::size_t i = 0; i < length; ++i)\n    {\n";
+        for (Common::AlgebraicExpressionArena::NodeIndex n = 0; n < arena.size(); ++n)
+        {
+            const Common::AlgebraicExpressionArena::Node& node = arena.getNode(n);
+            const std::string lhs = "n" + std::to_string(node.lhs), rhs = "n" + std::to_string(node.rhs);
+            out += "        const double n" + std::to_string(n) + " = ";
+            switch (node.opCode)
+            {
+                case Common::AlgebraicOpCode::PushConstant: out += formatConstant(arena.getConstant(node)); break;
+                case Common::AlgebraicOpCode::PushVariable:
+                    out += "c" + std::to_string(formula.bytecode.getSlot(arena.getVariable(node))) + "[i]";
+                    break;
+                case Common::AlgebraicOpCode::Add: out += lhs + " + " + rhs; break;
+                case Common::AlgebraicOpCode::Substract: out += lhs + " - " + rhs; break;
+                case Common::AlgebraicOpCode::Multiply: out += lhs + " * " + rhs; break;
+                case Common::AlgebraicOpCode::Divide: out += lhs + " / " + rhs; break;
+                case Common::AlgebraicOpCode::Power: out += "std::pow(" + lhs + ", " + rhs + ")"; break;
+                case Common::AlgebraicOpCode::Log: out += "std::log(" + lhs + ")"; break;
+                case Common::AlgebraicOpCode::Exp: out += "std::exp(" + lhs + ")"; break;
+                case Common::AlgebraicOpCode::Abs: out += "std::fabs(" + lhs + ")"; break;
+                case Common::AlgebraicOpCode::Min: out += "minimum(" + lhs + ", " + rhs + ")"; break;
+                case Common::AlgebraicOpCode::Max: out += "maximum(" + lhs + ", " + rhs + ")"; break;
+                default: break;
+            }
+            out += ";\n";
+        }
+        out += "        out[i] = n" + std::to_string(arena.getRoot()) + ";\n    }\n}\n";
+    }
+
+    return out;
+}
+
+std::string Common::AlgebraicNativeCatalogue::getLibraryPath() const
+{
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash(_key())));
+
+    return m_cacheDirectory + "/wildcat_formulas_" + key + ".so";
+}
+
+std::size_t Common::AlgebraicNativeCatalogue::getFormulaCount() const
+{
+    return m_formulas.size();
+}
+
+const std::vector<std::string>& Common::AlgebraicNativeCatalogue::getVariables() const
+{
+    return m_variables;
+}
+
+std::vector<Common::TimeSeries> Common::AlgebraicNativeCatalogue::evaluateSeries(const Common::DataSet &ds)
+{
+    if (!m_isBuilt)
+        build();
+
+    // Formulas reading the same inputs share one alignment, on the dates those inputs have in common, so that
+    // every formula gets the rows it would get alone
+    std::map<std::vector<std::size_t>, std::vector<std::size_t>> groups;
+    for (std::size_t f = 0; f < m_formulas.size(); ++f)
+    {
+        std::vector<std::size_t> group = m_formulas[f].columns;
+        std::sort(group.begin(), group.end());
+        if (group.empty())
+            throw std::runtime_error("E: AlgebraicNativeCatalogue::evaluateSeries : formula " + m_formulas[f].name +
+                                     " has no input variable to take dates from.");
+        groups[group].push_back(f);
+    }
+
+    std::vector<std::vector<double>> results(m_formulas.size());
+    std::vector<std::shared_ptr<const Common::Calendar>> calendars(m_formulas.size());
+    std::vector<const Common::TimeSeries*> inputs;
+    std::vector<const double*> columns(m_variables.size()), slots;
+    for (const auto& group: groups)
+    {
+        inputs.clear();
+        for (const auto& it: group.first)
+            inputs.push_back(&ds.getTimeSeriesRef(m_variables[it]));
+        const Common::AlignedColumns aligned(inputs);
+        const std::size_t length = aligned.getRowCount();
+        for (std::size_t i = 0; i < group.first.size(); ++i)
+            columns[group.first[i]] = aligned.getColumn(i);
+
+        for (const auto& f: group.second)
+        {
+            const Formula& formula = m_formulas[f];
+            results[f].resize(length);
+            if (!m_native.empty() and m_native[f])
+                m_native[f](columns.data(), length, results[f].data());
+            else
+            {
+                slots.clear();
+                for (const auto& it: formula.columns)
+                    slots.push_back(columns[it]);
+                formula.bytecode.evaluateColumns(slots.data(), length, results[f].data());
+            }
+            calendars[f] = aligned.getCalendar();
+        }
+    }
+
+    std::vector<Common::TimeSeries> series;
+    series.reserve(m_formulas.size());
+    for (std::size_t f = 0; f < m_formulas.size(); ++f)
+        series.emplace_back(m_formulas[f].name, std::move(results[f]), calendars[f]);
+
+    return series;
+}
+
+std::uint64_t Common::AlgebraicNativeCatalogue::hash(const std::string &text)
+{
+    // FNV-1a, stable across processes and platforms unlike std::hash, which matters for an on-disk cache
+    std::uint64_t rv = 14695981039346656037ull;
+    for (const char c: text)
+    {
+        rv ^= static_cast<unsigned char>(c);
+        rv *= 1099511628211ull;
+    }
+    return rv;
+}
+
+std::string Common::AlgebraicNativeCatalogue::_key() const
+{
+    std::string rv = generateSource() + '\n';
+    for (const auto& it: _compileArguments("", ""))
+        rv += it + ' ';
+    return rv;
+}
+
+std::vector<std::string> Common::AlgebraicNativeCatalogue::_compileArguments(const std::string &source, const std::string &library) const
+{
+    std::vector<std::string> rv = {m_compiler};
+    rv.insert(rv.end(), std::begin(compileFlags), std::end(compileFlags));
+    rv.insert(rv.end(), {"-o", library, source});
+    return rv;
+}
+
+bool Common::AlgebraicNativeCatalogue::_compile(const std::string &source, const std::string &library) const
+{
+    // The compiler is run directly, without a shell, so no part of the command is ever interpreted
+    const std::vector<std::string> arguments = _compileArguments(source, library);
+    std::vector<char*> argv;
+    for (const auto& it: arguments)
+        argv.push_back(const_cast<char*>(it.c_str()));
+    argv.push_back(nullptr);
+
+    const pid_t pid = ::fork();
+    if (pid < 0)
+        return false;
+    if (pid == 0)
+    {
+        const int null = ::open("/dev/null", O_WRONLY);
+        if (null >= 0)
+            ::dup2(null, STDOUT_FILENO), ::dup2(null, STDERR_FILENO);
+        ::execvp(argv[0], argv.data());
+        ::_exit(127);
+    }
+
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0)
+        if (errno != EINTR)
+            return false;
+
+    return WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+
+bool Common::AlgebraicNativeCatalogue::_load(const std::string &library, const std::string &key)
+{
+    // The object is only loaded from a private file, and after checking that it was built from this very catalogue
+    // rather than from another one whose key hashes the same
+    if (!isPrivate(library, false) or !isPrivate(keyPath(library), false))
+        return false;
+    {
+        std::ifstream file(keyPath(library), std::ios::in | std::ios::binary);
+        const std::string stored((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!file.good() and !file.eof())
+            return false;
+        if (stored != key)
+            return false;
+    }
+
+    void* handle = ::dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle)
+        return false;
+    m_library = std::shared_ptr<void>(handle, [](void* h) { ::dlclose(h); });
+
+    std::vector<NativeFormula> native;
+    for (std::size_t f = 0; f < m_formulas.size(); ++f)
+    {
+        if (m_formulas[f].bytecode.hasHistory())
+        {
+            native.push_back(nullptr);
+            continue;
+        }
+
+        void* symbol = ::dlsym(handle, (symbolPrefix + std::to_string(f)).c_str());
+        if (!symbol)
+        {
+            m_library.reset();
+            return false;
+        }
+        native.push_back(reinterpret_cast<NativeFormula>(symbol));
+    }
+
+    m_native = std::move(native);
+    return true;
+}
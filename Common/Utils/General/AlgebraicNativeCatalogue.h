@@ -0,0 +1,75 @@
+#ifndef WILDCATSTKCORE_ALGEBRAICNATIVECATALOGUE_H
+#define WILDCATSTKCORE_ALGEBRAICNATIVECATALOGUE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "AlgebraicBytecode.h"
+#include "AlgebraicExpressionArena.h"
+
+namespace Common
+{
+    class DataSet;
+    class TimeSeries;
+    class OperatorsGrammar;
+
+    //
+    // Optional native backend for large formula catalogues. build() emits C++ source with one loop per formula over
+    // contiguous input columns, compiles it with the local compiler into a shared object and loads it with dlopen.
+    // Shared objects are cached on disk under a hash of the generated source and the compile command, so a catalogue
+    // already seen, by this or an earlier process, is only loaded. The hashed text is kept next to each object and
+    // compared before loading, and objects are only loaded from a cache directory private to the user. The compiler
+    // is one executable, found on the PATH, run without a shell. When no compiler is available, or compiling or
+    // loading fails, formulas run on the bytecode interpreter instead: results are the same, only slower. Formulas
+    // reading earlier rows (lag, diff, ma) always run on the interpreter. Each formula is aligned on the dates its own
+    // inputs have in common, as a single FormulaVariableAlgebraic would be.
+    //
+    class AlgebraicNativeCatalogue
+    {
+    public:
+        typedef void (*NativeFormula)(const double* const* columns, std::size_t length, double* out);
+
+        explicit AlgebraicNativeCatalogue(const std::string& cacheDirectory, const std::string& compiler = "c++");
+
+        std::size_t addFormula(const std::string& name, const std::string& expression, const Common::OperatorsGrammar& grammar);
+        std::size_t addFormula(const std::string& name, const std::shared_ptr<const Common::AlgebraicExpressionArena>& formula);
+
+        bool build();
+        bool isNative() const;
+        std::string generateSource() const;
+        std::string getLibraryPath() const;
+
+        std::size_t getFormulaCount() const;
+        const std::vector<std::string>& getVariables() const;
+        std::vector<Common::TimeSeries> evaluateSeries(const Common::DataSet& ds);
+
+        static std::uint64_t hash(const std::string& text);
+
+    private:
+        struct Formula
+        {
+            std::string name;
+            std::shared_ptr<const Common::AlgebraicExpressionArena> arena;
+            Common::AlgebraicBytecode bytecode;
+            std::vector<std::size_t> columns;      // catalogue column of each bytecode slot
+        };
+
+        std::string m_cacheDirectory, m_compiler;
+        std::vector<Formula> m_formulas;
+        std::vector<std::string> m_variables;
+        std::unordered_map<std::string, std::size_t> m_columns;
+
+        std::shared_ptr<void> m_library;
+        std::vector<NativeFormula> m_native;
+        bool m_isBuilt = false;
+
+        std::string _key() const;
+        std::vector<std::string> _compileArguments(const std::string& source, const std::string& library) const;
+        bool _compile(const std::string& source, const std::string& library) const;
+        bool _load(const std::string& library, const std::string& key);
+    };
+}
+
+#endif //WILDCATSTKCORE_ALGEBRAICNATIVECATALOGUE_H
@@ -2,6 +2,7 @@
 // Created by Alberto Campi on 24/07/2019.
 //
 
+#include <cmath>
 #include "Tools.h"
 #include "AlgebraicExpressionInterpreter.h"
 #include "../../../Global/Mappings/FactoryMappings.h"
@@ -68,35 +69,40 @@ StringSplitAlgebraicDecorator::StringSplitAlgebraicDecorator(const Common::Opera
 
 void StringSplitAlgebraicDecorator::split(const std::string &string, const std::string &pattern)
 {
-    const std::string cleanString = boost::algorithm::erase_all_copy(string, " ");
+    // Separators are looked up in a byte table, blanks are dropped as before
+    bool isSeparator[256] = {};
+    for (const char c: pattern)
+        isSeparator[static_cast<unsigned char>(c)] = true;
 
     std::vector<std::string> comp, tok;
     std::string token;
-    for (unsigned int i = 0; i < cleanString.length(); ++i)
+    for (const char c: string)
     {
-        const std::string thisToken = std::string(1, cleanString.at(i));
-        if (pattern.find(thisToken) != std::string::npos)
+        if (c == ' ')
+            continue;
+
+        if (isSeparator[static_cast<unsigned char>(c)])
         {
             if (!token.empty())
             {
                 comp.push_back(token);
                 tok.push_back(token);
+                token.clear();
             }
-            tok.push_back(thisToken);
-            token.clear();
+            tok.emplace_back(1, c);
         }
         else
-            token += thisToken;
+            token += c;
+    }
 
-        if (!token.empty() and i == cleanString.size() - 1)
-        {
-            comp.push_back(token);
-            tok.push_back(token);
-        }
+    if (!token.empty())
+    {
+        comp.push_back(token);
+        tok.push_back(token);
     }
 
-    m_components = comp;
-    m_tokenized = tok;
+    m_components = std::move(comp);
+    m_tokenized = std::move(tok);
 }
 
 void StringSplitAlgebraicDecorator::splitExpression(const std::string &string)
@@ -118,32 +124,44 @@ void StringSplitAlgebraicDecorator::setOperatorsGrammar(const Common::OperatorsG
 
 //AlgebraicExpressionParser implementation
 AlgebraicExpressionParser::AlgebraicExpressionParser(const std::string &expression, const Common::OperatorsGrammar &opGrammar) :
-    m_opGrammar(opGrammar.clone())
+    m_opGrammar(opGrammar.clone()), m_table(*m_opGrammar), m_token(0)
+{
+    _tokenize(expression);
+}
+
+AlgebraicExpressionParser::AlgebraicExpressionParser(const AlgebraicExpressionParser &other) :
+    m_opGrammar(other.m_opGrammar -> clone()), m_table(other.m_table), m_expression(other.m_expression), m_tokens(other.m_tokens),
+    m_variables(other.m_variables), m_compiled(other.m_compiled), m_token(0)
+{}
+
+AlgebraicExpressionParser& AlgebraicExpressionParser::operator=(const AlgebraicExpressionParser &other)
 {
-    Common::StringSplitAlgebraicDecorator strspl(*m_opGrammar);
-    strspl.splitExpression(expression);
-    m_tokenized = strspl.getTokenized();
+    if (&other != this)
+    {
+        m_opGrammar = other.m_opGrammar -> clone();
+        m_table = other.m_table;
+        m_expression = other.m_expression;
+        m_tokens = other.m_tokens;
+        m_variables = other.m_variables;
+        m_compiled = other.m_compiled;
+    }
 
-    for (const auto& it: strspl.get())
-        if (!Common::isNumeric(it))
-            m_variables.push_back(it);
+    return *this;
 }
 
 void AlgebraicExpressionParser::setExpression(const std::string &other)
 {
-    Common::StringSplitAlgebraicDecorator strspl(*m_opGrammar);
-    strspl.splitExpression(other);
-    m_tokenized = strspl.getTokenized();
-
-    m_variables.clear();
-    for (const auto& it: strspl.get())
-        if (!Common::isNumeric(it))
-            m_variables.push_back(it);
+    _tokenize(other);
+    m_compiled.reset();
 }
 
 void AlgebraicExpressionParser::setOperatorGrammar(const Common::OperatorsGrammar &other)
 {
+    //Symbols may lex differently under the new grammar, the expression is lexed again
     m_opGrammar = other.clone();
+    m_table = Common::AlgebraicOperatorTable(*m_opGrammar);
+    _tokenize(std::string(m_expression));
+    m_compiled.reset();
 }
 
 std::vector<std::string> AlgebraicExpressionParser::getExpressionVariables() const
@@ -151,69 +169,169 @@ std::vector<std::string> AlgebraicExpressionParser::getExpressionVariables() con
     return m_variables;
 }
 
+void AlgebraicExpressionParser::compile()
+{
+    m_token = 0;
+
+    //Using precedence climbing algorithm, nodes are appended to the arena as they are reduced
+    auto arena = std::make_shared<Common::AlgebraicExpressionArena>();
+    arena -> setRoot(_parseExpression(*arena, 0));
+    if (m_token != m_tokens.size())
+        throw std::runtime_error("Common::AlgebraicExpressionParser::compile : parsing error. Unexpected token " +
+                                 m_tokens[m_token].str(m_expression) + ".");
+
+    m_compiled = std::move(arena);
+}
+
+bool AlgebraicExpressionParser::isCompiled() const
+{
+    return static_cast<bool>(m_compiled);
+}
+
 double AlgebraicExpressionParser::evaluate(const Common::AlgebraicExpressionContext &context)
 {
-    m_itToken = m_tokenized.begin();
-    m_itExprEnd = m_tokenized.end();
+    // The tree is built on first use only, evaluation is then a walk of the compiled tree
+    if (!m_compiled)
+        compile();
+
+    return m_compiled -> evaluate(context);
+}
+
+Common::AlgebraicBytecode AlgebraicExpressionParser::compileBytecode()
+{
+    if (!m_compiled)
+        compile();
+
+    Common::AlgebraicBytecode code;
+    m_compiled -> emit(code);
+    return code;
+}
+
+std::shared_ptr<const Common::AlgebraicExpressionArena> AlgebraicExpressionParser::getCompiled()
+{
+    if (!m_compiled)
+        compile();
 
-    //Using precedence climbing algorithm
-    return _parseExpression(0) -> evaluate(context);
+    return m_compiled;
+}
+
+void AlgebraicExpressionParser::_tokenize(const std::string &expression)
+{
+    // Token buffer is reused across expressions, variables are kept in order of appearance as before
+    m_expression = expression;
+    m_tokens.clear();
+    Common::AlgebraicLexer::tokenize(m_expression, m_table, m_tokens);
+
+    m_variables.clear();
+    for (const auto& it: m_tokens)
+        if (it.kind == Common::AlgebraicTokenKind::Identifier)
+            m_variables.push_back(it.str(m_expression));
 }
 
 //Recursive-descent atomic element parsers i.e. variables, constants and parenthesised expressions
-std::unique_ptr<Common::AlgebraicExpression> AlgebraicExpressionParser::_parsePrimary()
+Common::AlgebraicExpressionArena::NodeIndex AlgebraicExpressionParser::_parsePrimary(Common::AlgebraicExpressionArena &arena)
 {
-    const std::string token = *m_itToken;
-    const unsigned int lowestPrecedenceValue = m_opGrammar -> lowestPriority();
-    if (m_opGrammar -> isLeftBracket(token))
-    {
-        ++m_itToken;
-        std::unique_ptr<Common::AlgebraicExpression> expr = _parseExpression(lowestPrecedenceValue);
+    if (m_token == m_tokens.size())
+        throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : "
+                                 "parsing error. Unexpected end of expression");
 
-        if (m_opGrammar -> isRightBracket(*m_itToken))
-            throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : parsing error. Mismatched brackets.");
+    const Common::AlgebraicToken& token = m_tokens[m_token];
+    switch (token.kind)
+    {
+        case Common::AlgebraicTokenKind::LeftBracket:
+        {
+            ++m_token;
+            const Common::AlgebraicExpressionArena::NodeIndex expr =
+                    _parseExpression(arena, m_table.lowestPriority());
 
-        ++m_itToken;
+            if (m_token == m_tokens.size() or m_tokens[m_token].kind != Common::AlgebraicTokenKind::RightBracket)
+                throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : parsing error. Mismatched brackets.");
 
-        return expr;
+            ++m_token;
+            return expr;
+        }
+        case Common::AlgebraicTokenKind::Number:
+            ++m_token;
+            return arena.addConstant(token.value);
+        case Common::AlgebraicTokenKind::Function:
+            return _parseFunction(arena);
+        case Common::AlgebraicTokenKind::Identifier:
+            ++m_token;
+            if (m_token != m_tokens.size() and m_tokens[m_token].kind == Common::AlgebraicTokenKind::LeftBracket)
+                throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : parsing error. Unknown function " +
+                                         token.str(m_expression) + ".");
+            return arena.addVariable(token.str(m_expression));
+        default:
+            throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : "
+                                     "parsing error. Operator found where value was expected");
     }
-    else if (!m_opGrammar -> isOperator(token))
+
+}
+
+//Function calls, the lexer only emits function tokens directly followed by a left bracket
+Common::AlgebraicExpressionArena::NodeIndex AlgebraicExpressionParser::_parseFunction(Common::AlgebraicExpressionArena &arena)
+{
+    const std::string name = m_tokens[m_token].str(m_expression);
+    const Common::AlgebraicOpCode opCode = m_tokens[m_token].opCode;
+    const unsigned int arity = Common::AlgebraicOperatorTable::functionArity(opCode);
+    const std::string arityError = "Common::AlgebraicExpressionParser::_parseFunction : parsing error. Function " + name +
+                                   " takes " + std::to_string(arity) + (arity == 1 ? " argument." : " arguments.");
+    m_token += 2;
+
+    Common::AlgebraicExpressionArena::NodeIndex node = _parseExpression(arena, m_table.lowestPriority());
+    if (arity == 2)
     {
-        ++m_itToken;
-        char* pEnd;
-        if (Common::isNumeric(token))
+        if (m_token == m_tokens.size() or m_tokens[m_token].kind != Common::AlgebraicTokenKind::Comma)
+            throw std::runtime_error(arityError);
+        ++m_token;
+
+        if (Common::AlgebraicBytecode::isHistory(opCode))
         {
-            const double constant = std::strtod(token.c_str(), &pEnd);
-            return std::make_unique<Common::ConstantExpression>(Common::ConstantExpression(constant));
+            // Row counts are literals, they fix the offset of the column views when the formula is compiled
+            const unsigned int minRows = opCode == Common::AlgebraicOpCode::MovingAverage ? 1 : 0;
+            if (m_token == m_tokens.size() or m_tokens[m_token].kind != Common::AlgebraicTokenKind::Number or
+                m_tokens[m_token].value != std::floor(m_tokens[m_token].value) or m_tokens[m_token].value < minRows or
+                m_tokens[m_token].value > 1e6)
+                throw std::runtime_error("Common::AlgebraicExpressionParser::_parseFunction : parsing error. Function " + name +
+                                         " takes a whole number of rows" + (minRows ? " greater than zero." : "."));
+
+            node = arena.addFunction(opCode, node, static_cast<unsigned int>(m_tokens[m_token++].value));
         }
         else
-            return std::make_unique<Common::VariableExpression>(Common::VariableExpression(token));
+            node = arena.addOperator(opCode, node, _parseExpression(arena, m_table.lowestPriority()));
     }
     else
-        throw std::runtime_error("Common::AlgebraicExpressionParser::_parsePrimary : "
-                                 "parsing error. Operator found where value was expected");
+        node = arena.addFunction(opCode, node);
+
+    if (m_token != m_tokens.size() and m_tokens[m_token].kind == Common::AlgebraicTokenKind::Comma)
+        throw std::runtime_error(arityError);
+    if (m_token == m_tokens.size() or m_tokens[m_token].kind != Common::AlgebraicTokenKind::RightBracket)
+        throw std::runtime_error("Common::AlgebraicExpressionParser::_parseFunction : parsing error. Mismatched brackets.");
+    ++m_token;
 
-    //Only binary operators currently supported. Extend here for functions.
+    return node;
 }
 
 //Expression parser with precedence climbing logic
-std::unique_ptr<Common::AlgebraicExpression> AlgebraicExpressionParser::_parseExpression(unsigned int lowestPrecedenceValue)
+Common::AlgebraicExpressionArena::NodeIndex AlgebraicExpressionParser::_parseExpression(Common::AlgebraicExpressionArena &arena,
+                                                                                      unsigned int lowestPrecedenceValue)
 {
-    std::unique_ptr<Common::AlgebraicExpression> lhsExpr = _parsePrimary();
-    while (true)
+    Common::AlgebraicExpressionArena::NodeIndex lhsExpr = _parsePrimary(arena);
+    while (m_token != m_tokens.size())
     {
-        if (m_itToken == m_itExprEnd or
-            !m_opGrammar -> isOperator(*m_itToken) or
-            m_opGrammar -> priority(*m_itToken) < lowestPrecedenceValue)
+        const Common::AlgebraicToken& token = m_tokens[m_token];
+        if (token.kind != Common::AlgebraicTokenKind::Operator or
+            m_table.priority(token.opCode) < lowestPrecedenceValue)
             break;
 
-        const std::string opSymbol = *m_itToken;
-        const unsigned int opPrecedence = m_opGrammar -> priority(opSymbol);
-        const unsigned int nextLowestPrecedenceValue = m_opGrammar -> isLeftAssociative(opSymbol) ? opPrecedence + 1 : opPrecedence;
+        const Common::AlgebraicOpCode opCode = token.opCode;
+        const unsigned int opPrecedence = m_table.priority(opCode);
+        const unsigned int nextLowestPrecedenceValue =
+                m_table.isRightAssociative(opCode) ? opPrecedence : opPrecedence + 1;
 
-        ++m_itToken;
-        std::unique_ptr<Common::AlgebraicExpression> rhsExpr = _parseExpression(nextLowestPrecedenceValue);
-        lhsExpr = Global::AlgebraicExpressionFactoryMapping::instance() -> getFactory(opSymbol) -> create(*lhsExpr, *rhsExpr);
+        ++m_token;
+        const Common::AlgebraicExpressionArena::NodeIndex rhsExpr = _parseExpression(arena, nextLowestPrecedenceValue);
+        lhsExpr = arena.addOperator(opCode, lhsExpr, rhsExpr);
     }
 
     return lhsExpr;
@@ -11,6 +11,9 @@
 #include <queue>
 #include <boost/numeric/ublas/vector.hpp>
 #include "AlgebraicExpressionInterpreter.h"
+#include "AlgebraicBytecode.h"
+#include "AlgebraicExpressionArena.h"
+#include "AlgebraicLexer.h"
 
 namespace Common
 {
@@ -67,27 +70,49 @@ namespace Common
     };
 
 
+    //
+    // Parses an algebraic expression once into an expression tree, which is then kept and evaluated against any number
+    // of contexts. Parsing is deferred to the first compile() or evaluate() call, so syntax errors surface there, and
+    // is redone only after the expression or grammar change. The tree is built in place in an arena and is immutable
+    // once compiled: copies of a parser share it. Expressions are lexed once by AlgebraicLexer when they are set, and
+    // symbols, precedence and associativity come from the operator grammar, through the AlgebraicOperatorTable built
+    // from it whenever the grammar is set.
+    //
     class AlgebraicExpressionParser
     {
     public:
         AlgebraicExpressionParser(const std::string& expression, const Common::OperatorsGrammar& opGrammar);
+        AlgebraicExpressionParser(const AlgebraicExpressionParser& other);
+        AlgebraicExpressionParser& operator=(const AlgebraicExpressionParser& other);
 
         void setExpression(const std::string& other);
         void setOperatorGrammar(const Common::OperatorsGrammar& other);
 
         std::vector<std::string> getExpressionVariables() const;
 
+        void compile();
+        bool isCompiled() const;
         double evaluate(const Common::AlgebraicExpressionContext& context);
 
+        Common::AlgebraicBytecode compileBytecode();
+        std::shared_ptr<const Common::AlgebraicExpressionArena> getCompiled();
+
     private:
         std::unique_ptr<Common::OperatorsGrammar> m_opGrammar;
-        std::vector<std::string> m_tokenized, m_variables;
+        Common::AlgebraicOperatorTable m_table;
+        std::string m_expression;
+        std::vector<Common::AlgebraicToken> m_tokens;
+        std::vector<std::string> m_variables;
+        std::shared_ptr<const Common::AlgebraicExpressionArena> m_compiled;
+
+        std::size_t m_token;
 
-        std::vector<std::string>::const_iterator m_itToken;
-        std::vector<std::string>::const_iterator m_itExprEnd;
+        void _tokenize(const std::string& expression);
 
-        std::unique_ptr<Common::AlgebraicExpression> _parsePrimary(void);
-        std::unique_ptr<Common::AlgebraicExpression> _parseExpression(unsigned int lowestPrecedenceValue);
+        Common::AlgebraicExpressionArena::NodeIndex _parsePrimary(Common::AlgebraicExpressionArena& arena);
+        Common::AlgebraicExpressionArena::NodeIndex _parseFunction(Common::AlgebraicExpressionArena& arena);
+        Common::AlgebraicExpressionArena::NodeIndex _parseExpression(Common::AlgebraicExpressionArena& arena,
+                                                                     unsigned int lowestPrecedenceValue);
     };
 
 
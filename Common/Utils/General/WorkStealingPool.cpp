@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <stdexcept>
+#include "WorkStealingPool.h"
+
+namespace
+{
+    // Pool whose worker is the current thread, if any
+    thread_local const Common::WorkStealingPool* workerPool = nullptr;
+}
+
+Common::WorkStealingPool::WorkStealingPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&Common::WorkStealingPool::_work, this, i);
+}
+
+Common::WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& it: m_threads)
+        it.join();
+}
+
+void Common::WorkStealingPool::parallelFor(std::size_t count, const std::function<void(std::size_t)> &task)
+{
+    if (count == 0)
+        return;
+    if (workerPool == this)
+        throw std::runtime_error("E: WorkStealingPool::parallelFor : called from a task of the same pool, the nested job "
+                                 "would wait forever on the one running it.");
+
+    std::lock_guard<std::mutex> job(m_jobMutex);
+    const std::size_t workers = m_queues.size();
+    for (std::size_t w = 0; w < workers; ++w)
+    {
+        std::lock_guard<std::mutex> lock(m_queues[w] -> mutex);
+        for (std::size_t i = w * count / workers; i < (w + 1) * count / workers; ++i)
+            m_queues[w] -> indices.push_back(i);
+    }
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = &task, m_pending = count, m_error = nullptr;
+        ++m_generation;
+        m_wake.notify_all();
+
+        // Workers still inside the job hold the task pointer, the next job must not start before they leave
+        m_done.wait(lock, [this]() { return m_pending == 0 and m_busy == 0; });
+        m_task = nullptr;
+        std::swap(error, m_error);
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+unsigned int Common::WorkStealingPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+void Common::WorkStealingPool::_work(unsigned int worker)
+{
+    workerPool = this;
+    unsigned long generation = 0;
+    while (true)
+    {
+        const std::function<void(std::size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_isStopping or (m_task and m_generation != generation); });
+            if (m_isStopping)
+                return;
+
+            generation = m_generation, task = m_task;
+            ++m_busy;
+        }
+
+        std::size_t index, done = 0;
+        while (_take(worker, index))
+        {
+            try
+            {
+                (*task)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+            ++done;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending -= done;
+            --m_busy;
+            if (m_pending == 0 and m_busy == 0)
+                m_done.notify_all();
+        }
+    }
+}
+
+bool Common::WorkStealingPool::_take(unsigned int worker, std::size_t &index)
+{
+    {
+        Queue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.indices.empty())
+        {
+            index = own.indices.back();
+            own.indices.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < m_queues.size(); ++i)
+    {
+        Queue& victim = *m_queues[(worker + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.indices.empty())
+        {
+            index = victim.indices.front();
+            victim.indices.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#ifndef WILDCATSTKCORE_WORKSTEALINGPOOL_H
+#define WILDCATSTKCORE_WORKSTEALINGPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Common
+{
+    //
+    // Fixed set of worker threads running parallelFor jobs. The indices of a job are dealt to the workers in
+    // contiguous chunks; each worker takes from the back of its own queue and, once it runs dry, steals from the front
+    // of the others', so uneven task costs still keep every thread busy. One job runs at a time, parallelFor returns
+    // when every index is done and rethrows the first exception a task raised. Jobs do not nest: parallelFor called from
+    // a task of the same pool throws instead of deadlocking, a task may still run a job on another pool.
+    //
+    class WorkStealingPool
+    {
+    public:
+        explicit WorkStealingPool(unsigned int threadCount = 0);        // 0 = one thread per hardware core
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+        unsigned int getThreadCount() const;
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::size_t> indices;
+        };
+
+        std::vector<std::thread> m_threads;
+        std::vector<std::unique_ptr<Queue>> m_queues;
+
+        std::mutex m_jobMutex;
+        std::mutex m_mutex;
+        std::condition_variable m_wake, m_done;
+        const std::function<void(std::size_t)>* m_task = nullptr;
+        std::size_t m_pending = 0;
+        unsigned int m_busy = 0;
+        unsigned long m_generation = 0;
+        bool m_isStopping = false;
+        std::exception_ptr m_error;
+
+        void _work(unsigned int worker);
+        bool _take(unsigned int worker, std::size_t& index);
+    };
+}
+
+#endif //WILDCATSTKCORE_WORKSTEALINGPOOL_H
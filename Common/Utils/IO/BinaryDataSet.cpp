@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BinaryDataSet.h"
+#include "JSONParser.h"
+#include "JSONStreamReader.h"
+#include "../../Types/Calendar.h"
+#include "../../Types/TimeSeries.h"
+
+namespace
+{
+    typedef Common::BinaryDataSetFormat Format;
+
+    std::uint64_t alignUp(std::uint64_t offset, std::uint64_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    void writePadding(std::ofstream& file, std::uint64_t& offset, std::uint64_t alignedOffset)
+    {
+        static const char zeros[64] = {};
+        while (offset < alignedOffset)
+        {
+            const std::uint64_t n = std::min<std::uint64_t>(alignedOffset - offset, sizeof(zeros));
+            file.write(zeros, static_cast<std::streamsize>(n));
+            offset += n;
+        }
+    }
+
+    template <typename T>
+    void writeRaw(std::ofstream& file, std::uint64_t& offset, const T* data, std::size_t count)
+    {
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        offset += count * sizeof(T);
+    }
+}
+
+//
+// Read-only private mapping of a whole file, unmapped when the last series pointing into it goes away.
+//
+class Common::BinaryDataSetReader::MappedFile
+{
+public:
+    explicit MappedFile(const std::string& fileName) : m_data(nullptr), m_size(0)
+    {
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("E: BinaryDataSetReader::BinaryDataSetReader : cannot open file " + fileName + ".");
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("E: BinaryDataSetReader::BinaryDataSetReader : cannot stat file " + fileName + ".");
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size > 0)
+        {
+            void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("E: BinaryDataSetReader::BinaryDataSetReader : cannot map file " + fileName + ".");
+            }
+            m_data = static_cast<const char*>(p);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (m_data)
+            ::munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+    bool contains(std::uint64_t offset, std::uint64_t bytes) const
+    {
+        return offset <= m_size and bytes <= m_size - offset;
+    }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+};
+
+
+void Common::BinaryDataSetWriter::write(const std::string &fileName, const Common::DataSet &ds) const
+{
+    // Variables are written in name order so the same data set always produces the same file
+    std::vector<const std::pair<const std::string, Common::TimeSeries>*> variables;
+    for (const auto& it: ds.getData())
+        variables.push_back(&it);
+    std::sort(variables.begin(), variables.end(), [](const std::pair<const std::string, Common::TimeSeries>* a,
+                                                     const std::pair<const std::string, Common::TimeSeries>* b)
+    { return a -> first < b -> first; });
+
+    // Each distinct calendar is stored once
+    std::vector<std::shared_ptr<const Common::Calendar>> calendars;
+    std::vector<std::uint32_t> calendarIndex;
+    for (const auto it: variables)
+    {
+        const std::shared_ptr<const Common::Calendar> calendar = it -> second.getCalendar();
+        auto jt = std::find_if(calendars.begin(), calendars.end(),
+                               [&calendar](const std::shared_ptr<const Common::Calendar>& c) { return *c == *calendar; });
+        if (jt == calendars.end())
+            jt = calendars.insert(calendars.end(), calendar);
+        calendarIndex.push_back(static_cast<std::uint32_t>(jt - calendars.begin()));
+    }
+
+    // Layout
+    Format::Header header{};
+    std::memcpy(header.magic, Format::magic(), std::strlen(Format::magic()) + 1);
+    header.version = Format::version();
+    header.headerSize = sizeof(Format::Header);
+    header.variableCount = variables.size();
+    header.calendarCount = calendars.size();
+    header.calendarDirectoryOffset = sizeof(Format::Header);
+
+    std::vector<Format::CalendarEntry> calendarEntries(calendars.size());
+    std::uint64_t offset = header.calendarDirectoryOffset + calendars.size() * sizeof(Format::CalendarEntry);
+    for (std::size_t i = 0; i < calendars.size(); ++i)
+    {
+        calendarEntries[i].offset = offset;
+        calendarEntries[i].length = calendars[i] -> size();
+        offset += calendars[i] -> size() * sizeof(std::uint32_t);
+    }
+
+    header.variableDirectoryOffset = alignUp(offset, sizeof(std::uint64_t));
+    header.namesOffset = header.variableDirectoryOffset + variables.size() * sizeof(Format::VariableEntry);
+
+    std::vector<Format::VariableEntry> variableEntries(variables.size());
+    offset = header.namesOffset;
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        variableEntries[i].nameOffset = offset;
+        variableEntries[i].nameLength = static_cast<std::uint32_t>(variables[i] -> first.size());
+        variableEntries[i].calendarIndex = calendarIndex[i];
+        offset += variables[i] -> first.size();
+    }
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        offset = alignUp(offset, Format::columnAlignment());
+        variableEntries[i].valuesOffset = offset;
+        variableEntries[i].length = variables[i] -> second.length();
+        offset += variables[i] -> second.length() * sizeof(double);
+    }
+    header.fileSize = offset;
+
+    // Contents
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("E: BinaryDataSetWriter::write : cannot open file " + fileName + ".");
+
+    offset = 0;
+    writeRaw(file, offset, &header, 1);
+    writeRaw(file, offset, calendarEntries.data(), calendarEntries.size());
+
+    std::vector<std::uint32_t> dayNumbers;
+    for (const auto& it: calendars)
+    {
+        dayNumbers.clear();
+        for (const auto& jt: it -> getDatesView())
+        {
+            if (jt.is_special())
+                throw std::runtime_error("E: BinaryDataSetWriter::write : special dates cannot be stored.");
+            dayNumbers.push_back(static_cast<std::uint32_t>(jt.day_number()));
+        }
+        writeRaw(file, offset, dayNumbers.data(), dayNumbers.size());
+    }
+
+    writePadding(file, offset, header.variableDirectoryOffset);
+    writeRaw(file, offset, variableEntries.data(), variableEntries.size());
+    for (const auto it: variables)
+        writeRaw(file, offset, it -> first.data(), it -> first.size());
+
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        writePadding(file, offset, variableEntries[i].valuesOffset);
+        const Common::ValuesView values = variables[i] -> second.getValuesView();
+        writeRaw(file, offset, values.begin(), values.size());
+    }
+
+    if (!file)
+        throw std::runtime_error("E: BinaryDataSetWriter::write : error while writing file " + fileName + ".");
+}
+
+
+Common::BinaryDataSetReader::BinaryDataSetReader(const std::string &fileName) :
+        m_file(std::make_shared<const MappedFile>(fileName))
+{
+    _readDirectory(fileName);
+}
+
+std::vector<std::string> Common::BinaryDataSetReader::getVariableNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(m_variables.size());
+    for (const auto& it: m_variables)
+        names.push_back(it.first);
+    std::sort(names.begin(), names.end());
+
+    return names;
+}
+
+bool Common::BinaryDataSetReader::hasVariable(const std::string &variableName) const
+{
+    return m_variables.find(variableName) != m_variables.end();
+}
+
+Common::TimeSeries Common::BinaryDataSetReader::getTimeSeries(const std::string &variableName) const
+{
+    const auto it = m_variables.find(variableName);
+    if (it == m_variables.end())
+        throw std::runtime_error("E: BinaryDataSetReader::getTimeSeries : variable " + variableName +
+                                 " is not in the data set.");
+
+    // No copy: the series values are the column in the mapping, which the series keeps alive
+    const Format::VariableEntry& entry = it -> second;
+    const double* values = reinterpret_cast<const double*>(m_file -> data() + entry.valuesOffset);
+    return Common::TimeSeries(variableName, m_file, values, static_cast<std::size_t>(entry.length),
+                              m_calendars[entry.calendarIndex]);
+}
+
+Common::DataSet Common::BinaryDataSetReader::getDataSet() const
+{
+    Common::DataSet ds;
+    for (const auto& it: getVariableNames())
+        ds.addData(getTimeSeries(it));
+
+    return ds;
+}
+
+void Common::BinaryDataSetReader::_readDirectory(const std::string &fileName)
+{
+    const auto fail = [&fileName](const std::string& what)
+    {
+        throw std::runtime_error("E: BinaryDataSetReader::BinaryDataSetReader : " + fileName + " " + what + ".");
+    };
+
+    const MappedFile& file = *m_file;
+    Format::Header header{};
+    if (!file.contains(0, sizeof(header)))
+        fail("is not a binary data set");
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, Format::magic(), std::strlen(Format::magic()) + 1) != 0)
+        fail("is not a binary data set");
+    if (header.version != Format::version())
+        fail("has unsupported version " + std::to_string(header.version));
+    if (header.headerSize < sizeof(Format::Header) or header.fileSize != file.size())
+        fail("is truncated or corrupted");
+
+    if (header.calendarCount > file.size() / sizeof(Format::CalendarEntry) or
+        !file.contains(header.calendarDirectoryOffset, header.calendarCount * sizeof(Format::CalendarEntry)))
+        fail("has a corrupted calendar directory");
+
+    m_calendars.reserve(static_cast<std::size_t>(header.calendarCount));
+    std::vector<boost::gregorian::date> dates;
+    for (std::uint64_t i = 0; i < header.calendarCount; ++i)
+    {
+        Format::CalendarEntry entry{};
+        std::memcpy(&entry, file.data() + header.calendarDirectoryOffset + i * sizeof(entry), sizeof(entry));
+        if (entry.length > file.size() / sizeof(std::uint32_t) or
+            !file.contains(entry.offset, entry.length * sizeof(std::uint32_t)))
+            fail("has a corrupted calendar");
+
+        dates.clear();
+        dates.reserve(static_cast<std::size_t>(entry.length));
+        for (std::uint64_t j = 0; j < entry.length; ++j)
+        {
+            std::uint32_t dayNumber;
+            std::memcpy(&dayNumber, file.data() + entry.offset + j * sizeof(dayNumber), sizeof(dayNumber));
+            dates.emplace_back(boost::gregorian::gregorian_calendar::from_day_number(dayNumber));
+        }
+        m_calendars.push_back(std::make_shared<const Common::Calendar>(dates));
+    }
+
+    if (header.variableCount > file.size() / sizeof(Format::VariableEntry) or
+        !file.contains(header.variableDirectoryOffset, header.variableCount * sizeof(Format::VariableEntry)))
+        fail("has a corrupted variable directory");
+
+    m_variables.reserve(static_cast<std::size_t>(header.variableCount));
+    for (std::uint64_t i = 0; i < header.variableCount; ++i)
+    {
+        Format::VariableEntry entry{};
+        std::memcpy(&entry, file.data() + header.variableDirectoryOffset + i * sizeof(entry), sizeof(entry));
+        if (!file.contains(entry.nameOffset, entry.nameLength) or entry.calendarIndex >= m_calendars.size() or
+            entry.length != m_calendars[entry.calendarIndex] -> size() or
+            entry.valuesOffset % sizeof(double) != 0 or entry.length > file.size() / sizeof(double) or
+            !file.contains(entry.valuesOffset, entry.length * sizeof(double)))
+            fail("has a corrupted variable entry");
+
+        m_variables.emplace(std::string(file.data() + entry.nameOffset, entry.nameLength), entry);
+    }
+}
+
+
+void Common::BinaryDataSetConverter::jsonToBinary(const std::string &jsonFileName, const std::string &binaryFileName)
+{
+    Common::BinaryDataSetWriter().write(binaryFileName, Common::JSONStreamReaderDataSet().read(jsonFileName));
+}
+
+void Common::BinaryDataSetConverter::binaryToJSON(const std::string &binaryFileName, const std::string &jsonFileName)
+{
+    Common::JSONParserDecoratorDataSet().writeJSON(jsonFileName, Common::BinaryDataSetReader(binaryFileName).getDataSet());
+}
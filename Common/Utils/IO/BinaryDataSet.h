@@ -0,0 +1,100 @@
+#ifndef WILDCATSTKCORE_BINARYDATASET_H
+#define WILDCATSTKCORE_BINARYDATASET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "../../Types/DataSet.h"
+
+namespace Common
+{
+    class Calendar;
+
+    //
+    // Binary data set file (all integers little endian, as written by the host):
+    //
+    //   header     magic "WCSTKDS\0", version, header size, variable count, calendar count, offsets of the calendar
+    //              directory, variable directory and names block, total file size (64 bytes)
+    //   calendars  directory of {offset, length}, then each distinct calendar once as uint32 day numbers
+    //   variables  directory of {name offset, name length, calendar index, values offset, length}, sorted by name
+    //   names      variable names, not terminated
+    //   values     one column of doubles per variable, each aligned on a 64 byte boundary
+    //
+    // Series read from a mapped file point straight into the mapping, which stays alive as long as any of them does.
+    //
+    class BinaryDataSetFormat
+    {
+    public:
+        static const char* magic() { return "WCSTKDS"; }
+        static std::uint32_t version() { return 1; }
+        static std::size_t columnAlignment() { return 64; }
+
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t headerSize;
+            std::uint64_t variableCount;
+            std::uint64_t calendarCount;
+            std::uint64_t calendarDirectoryOffset;
+            std::uint64_t variableDirectoryOffset;
+            std::uint64_t namesOffset;
+            std::uint64_t fileSize;
+        };
+
+        struct CalendarEntry
+        {
+            std::uint64_t offset;
+            std::uint64_t length;
+        };
+
+        struct VariableEntry
+        {
+            std::uint64_t nameOffset;
+            std::uint32_t nameLength;
+            std::uint32_t calendarIndex;
+            std::uint64_t valuesOffset;
+            std::uint64_t length;
+        };
+    };
+
+
+    class BinaryDataSetWriter
+    {
+    public:
+        void write(const std::string& fileName, const Common::DataSet& ds) const;
+    };
+
+
+    class BinaryDataSetReader
+    {
+    public:
+        explicit BinaryDataSetReader(const std::string& fileName);
+
+        std::vector<std::string> getVariableNames() const;
+        bool hasVariable(const std::string& variableName) const;
+        Common::TimeSeries getTimeSeries(const std::string& variableName) const;
+        Common::DataSet getDataSet() const;
+
+    private:
+        class MappedFile;
+
+        std::shared_ptr<const MappedFile> m_file;
+        std::vector<std::shared_ptr<const Common::Calendar>> m_calendars;
+        std::unordered_map<std::string, BinaryDataSetFormat::VariableEntry> m_variables;
+
+        void _readDirectory(const std::string& fileName);
+    };
+
+
+    class BinaryDataSetConverter
+    {
+    public:
+        static void jsonToBinary(const std::string& jsonFileName, const std::string& binaryFileName);
+        static void binaryToJSON(const std::string& binaryFileName, const std::string& jsonFileName);
+    };
+}
+
+#endif //WILDCATSTKCORE_BINARYDATASET_H
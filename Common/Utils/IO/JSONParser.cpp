@@ -3,6 +3,8 @@
 //
 
 #include "JSONParser.h"
+#include "JSONStreamReader.h"
+#include "JSONStreamWriter.h"
 #include "../../Types/TimeSeries.h"
 
 void Common::JSONParser::readJSON(const std::string& fileName, boost::property_tree::ptree& tree) const
@@ -22,65 +24,14 @@ Common::DataSet Common::JSONParserDecoratorDataSet::getDataSet() const
 
 void Common::JSONParserDecoratorDataSet::readJSON(const std::string& fileName)
 {
-    using namespace boost::property_tree;
+    // Data sets are loaded by the streaming reader, going through a ptree costs several times the final memory
     m_ds.clearAllData();
-    ptree root;
-    m_parser.readJSON(fileName, root);
-
-    ptree::const_iterator it;
-    for (it = root.begin(); it != root.end(); ++it)
-    {
-        const std::string variableName = it -> first;
-        ptree childDates = it -> second.get_child("Dates");
-        ptree childValues = it -> second.get_child("Values");
-
-        std::vector<boost::gregorian::date> dates;
-        for (const auto& jt: childDates)
-        {
-            const auto date = jt.second.get_value<std::string>();
-            dates.push_back(boost::gregorian::from_string(date));
-        }
-
-        std::vector<double> values;
-        for (const auto& jt: childValues)
-        {
-            values.push_back(jt.second.get_value<double>());
-        }
-
-        Common::TimeSeries ts(variableName, values, dates);
-        m_ds.addData(ts);
-    }
+    m_ds = Common::JSONStreamReaderDataSet().read(fileName);
 }
 
 void Common::JSONParserDecoratorDataSet::writeJSON(const std::string &fileName, const Common::DataSet &ds) const
 {
-    using namespace boost::property_tree;
-    ptree root;
-    std::vector<boost::property_tree::ptree> v;
-
-    for (const auto& it: ds.getData())
-    {
-        ptree child;
-
-        ptree dates;
-        for (const auto& jt: it.second.getDates())
-        {
-            ptree node;
-            node.put_value(boost::gregorian::to_iso_extended_string(jt)); //change formatting
-            dates.push_back(std::make_pair("", node));
-        }
-        child.add_child("Dates", dates);
-
-        ptree values;
-        for (const auto& jt: it.second.getValues())
-        {
-            ptree node;
-            node.put_value(jt);
-            values.push_back(std::make_pair("", node));
-        }
-        child.add_child("Values", values);
-        root.add_child(it.first, child);
-    }
-
-    m_parser.writeJSON(fileName, root);
+    // Written directly rather than through a ptree, callers writing many data sets can keep a JSONStreamWriterDataSet
+    // of their own to reuse its buffers
+    Common::JSONStreamWriterDataSet().write(fileName, ds);
 }
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include "JSONStreamReader.h"
+#include "../../Types/Calendar.h"
+#include "../../Types/TimeSeries.h"
+
+namespace
+{
+    inline bool isDigit(char c)
+    {
+        return c >= '0' and c <= '9';
+    }
+
+    inline int toDigit(char c)
+    {
+        return c - '0';
+    }
+
+    void appendUtf8(std::string& out, unsigned long codePoint)
+    {
+        if (codePoint < 0x80)
+            out += static_cast<char>(codePoint);
+        else if (codePoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+}
+
+//
+// Forward-only cursor over the JSON text. The text must be null terminated so that numbers can be parsed in place.
+//
+class Common::JSONStreamReaderDataSet::Cursor
+{
+public:
+    Cursor(const char* begin, const char* end) : m_begin(begin), m_pos(begin), m_end(end) {}
+
+    void skipWhitespace()
+    {
+        while (m_pos != m_end and (*m_pos == ' ' or *m_pos == '\n' or *m_pos == '\r' or *m_pos == '\t'))
+            ++m_pos;
+    }
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+    char peek()
+    {
+        skipWhitespace();
+        return m_pos == m_end ? '\0' : *m_pos;
+    }
+
+    bool consume(char c)
+    {
+        if (peek() != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    void expect(char c)
+    {
+        if (!consume(c))
+            fail(std::string("expected '") + c + "'");
+    }
+
+    // Returns the raw characters of a string without escape sequences, false if the string has to be decoded
+    bool parseRawString(const char*& begin, const char*& end)
+    {
+        expect('"');
+        const char* const start = m_pos;
+        while (m_pos != m_end and *m_pos != '"' and *m_pos != '\\')
+            ++m_pos;
+        if (m_pos == m_end)
+            fail("unterminated string");
+        if (*m_pos == '\\')
+        {
+            m_pos = start - 1;
+            return false;
+        }
+
+        begin = start, end = m_pos++;
+        return true;
+    }
+
+    std::string parseString()
+    {
+        const char* begin;
+        const char* end;
+        if (parseRawString(begin, end))
+            return std::string(begin, end);
+
+        std::string out;
+        expect('"');
+        while (m_pos != m_end and *m_pos != '"')
+        {
+            if (*m_pos != '\\')
+            {
+                out += *m_pos++;
+                continue;
+            }
+
+            if (++m_pos == m_end)
+                break;
+            switch (*m_pos++)
+            {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    if (m_end - m_pos < 4)
+                        fail("truncated unicode escape");
+                    appendUtf8(out, std::strtoul(std::string(m_pos, m_pos + 4).c_str(), nullptr, 16));
+                    m_pos += 4;
+                    break;
+                }
+                default:
+                    fail("invalid escape sequence");
+            }
+        }
+
+        if (m_pos == m_end)
+            fail("unterminated string");
+        ++m_pos;
+        return out;
+    }
+
+    double parseNumber()
+    {
+        const bool isQuoted = consume('"');
+        skipWhitespace();
+        if (!isQuoted and m_end - m_pos >= 4 and std::strncmp(m_pos, "null", 4) == 0)
+        {
+            m_pos += 4;
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        char* numberEnd = nullptr;
+        const double value = std::strtod(m_pos, &numberEnd);
+        if (numberEnd == m_pos or numberEnd > m_end)
+            fail("invalid number");
+        m_pos = numberEnd;
+
+        if (isQuoted)
+            expect('"');
+        return value;
+    }
+
+    void skipValue()
+    {
+        switch (peek())
+        {
+            case '{':
+                ++m_pos;
+                if (!consume('}'))
+                {
+                    do
+                    {
+                        parseString();
+                        expect(':');
+                        skipValue();
+                    } while (consume(','));
+                    expect('}');
+                }
+                break;
+            case '[':
+                ++m_pos;
+                if (!consume(']'))
+                {
+                    do
+                        skipValue();
+                    while (consume(','));
+                    expect(']');
+                }
+                break;
+            case '"':
+                parseString();
+                break;
+            default:
+                while (m_pos != m_end and *m_pos != ',' and *m_pos != '}' and *m_pos != ']' and
+                       *m_pos != ' ' and *m_pos != '\n' and *m_pos != '\r' and *m_pos != '\t')
+                    ++m_pos;
+        }
+    }
+
+    [[noreturn]] void fail(const std::string& what) const
+    {
+        throw std::runtime_error("E: JSONStreamReaderDataSet::parse : " + what + " at offset " +
+                                 std::to_string(m_pos - m_begin) + ".");
+    }
+
+private:
+    const char* const m_begin;
+    const char* m_pos;
+    const char* const m_end;
+};
+
+
+Common::DataSet Common::JSONStreamReaderDataSet::read(const std::string &fileName) const
+{
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    if (!file)
+        throw std::runtime_error("E: JSONStreamReaderDataSet::read : cannot open file " + fileName + ".");
+
+    file.seekg(0, std::ios::end);
+    std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&text[0], static_cast<std::streamsize>(text.size()));
+
+    return parse(text);
+}
+
+Common::DataSet Common::JSONStreamReaderDataSet::parse(const std::string &text) const
+{
+    Common::DataSet ds;
+    Cursor cursor(text.c_str(), text.c_str() + text.size());
+
+    // Scratch dates buffer is reused across variables, its capacity sizes the next variable's buffers
+    std::vector<boost::gregorian::date> dates;
+    std::shared_ptr<const Common::Calendar> lastCalendar;
+
+    cursor.expect('{');
+    if (!cursor.consume('}'))
+    {
+        do
+        {
+            const std::string variableName = cursor.parseString();
+            cursor.expect(':');
+            _parseVariable(cursor, variableName, ds, dates, lastCalendar);
+        } while (cursor.consume(','));
+        cursor.expect('}');
+    }
+
+    if (!cursor.atEnd())
+        cursor.fail("unexpected trailing characters");
+
+    return ds;
+}
+
+boost::gregorian::date Common::JSONStreamReaderDataSet::parseDate(const char *begin, const char *end)
+{
+    // Fixed-format fast path for YYYY-MM-DD (or YYYY/MM/DD), anything else goes through boost
+    if (end - begin == 10 and (begin[4] == '-' or begin[4] == '/') and begin[7] == begin[4] and
+        isDigit(begin[0]) and isDigit(begin[1]) and isDigit(begin[2]) and isDigit(begin[3]) and
+        isDigit(begin[5]) and isDigit(begin[6]) and isDigit(begin[8]) and isDigit(begin[9]))
+    {
+        const int year = toDigit(begin[0]) * 1000 + toDigit(begin[1]) * 100 + toDigit(begin[2]) * 10 + toDigit(begin[3]);
+        const int month = toDigit(begin[5]) * 10 + toDigit(begin[6]);
+        const int day = toDigit(begin[8]) * 10 + toDigit(begin[9]);
+        return boost::gregorian::date(static_cast<unsigned short>(year), static_cast<unsigned short>(month),
+                                      static_cast<unsigned short>(day));
+    }
+
+    return boost::gregorian::from_string(std::string(begin, end));
+}
+
+void Common::JSONStreamReaderDataSet::_parseVariable(Cursor &cursor, const std::string &variableName, Common::DataSet &ds,
+                                                     std::vector<boost::gregorian::date> &dates,
+                                                     std::shared_ptr<const Common::Calendar> &lastCalendar) const
+{
+    bool hasDates = false, hasValues = false;
+    std::vector<double> values;
+    dates.clear();
+
+    cursor.expect('{');
+    if (!cursor.consume('}'))
+    {
+        do
+        {
+            const std::string key = cursor.parseString();
+            cursor.expect(':');
+            if (key == "Dates")
+            {
+                _parseDates(cursor, dates);
+                hasDates = true;
+            }
+            else if (key == "Values")
+            {
+                values.reserve(hasDates ? dates.size() : (lastCalendar ? lastCalendar -> size() : 0));
+                _parseValues(cursor, values);
+                hasValues = true;
+            }
+            else
+                cursor.skipValue();
+        } while (cursor.consume(','));
+        cursor.expect('}');
+    }
+
+    if (!hasDates or !hasValues)
+        throw std::runtime_error("E: JSONStreamReaderDataSet::parse : variable " + variableName + " has no " +
+                                 (hasDates ? "Values" : "Dates") + " array.");
+
+    const Common::DatesView lastDates = lastCalendar ? lastCalendar -> getDatesView() : Common::DatesView();
+    if (!lastCalendar or lastDates.size() != dates.size() or !std::equal(dates.begin(), dates.end(), lastDates.begin()))
+        lastCalendar = std::make_shared<Common::Calendar>(dates);
+
+    ds.addData(Common::TimeSeries(variableName, std::move(values), lastCalendar));
+}
+
+void Common::JSONStreamReaderDataSet::_parseDates(Cursor &cursor, std::vector<boost::gregorian::date> &dates)
+{
+    cursor.expect('[');
+    if (cursor.consume(']'))
+        return;
+
+    do
+    {
+        const char* begin;
+        const char* end;
+        if (cursor.parseRawString(begin, end))
+            dates.push_back(parseDate(begin, end));
+        else
+        {
+            const std::string date = cursor.parseString();
+            dates.push_back(parseDate(date.data(), date.data() + date.size()));
+        }
+    } while (cursor.consume(','));
+    cursor.expect(']');
+}
+
+void Common::JSONStreamReaderDataSet::_parseValues(Cursor &cursor, std::vector<double> &values)
+{
+    cursor.expect('[');
+    if (cursor.consume(']'))
+        return;
+
+    do
+        values.push_back(cursor.parseNumber());
+    while (cursor.consume(','));
+    cursor.expect(']');
+}
@@ -0,0 +1,39 @@
+#ifndef WILDCATSTKCORE_JSONSTREAMREADER_H
+#define WILDCATSTKCORE_JSONSTREAMREADER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "../../Types/DataSet.h"
+
+namespace Common
+{
+    class Calendar;
+
+    //
+    // Single pass reader for data sets stored as {"VAR": {"Dates": [...], "Values": [...]}, ...}. The text is scanned
+    // once, numbers (bare or quoted, as written by boost::property_tree) are parsed in place, ISO dates go through a
+    // fixed-format parser, and values are written straight into the series buffers, reserved from the size of the
+    // previous array. Consecutive variables observed on the same dates share one calendar.
+    //
+    class JSONStreamReaderDataSet
+    {
+    public:
+        Common::DataSet read(const std::string& fileName) const;
+        Common::DataSet parse(const std::string& text) const;
+
+        static boost::gregorian::date parseDate(const char* begin, const char* end);
+
+    private:
+        class Cursor;
+
+        void _parseVariable(Cursor& cursor, const std::string& variableName, Common::DataSet& ds,
+                            std::vector<boost::gregorian::date>& dates,
+                            std::shared_ptr<const Common::Calendar>& lastCalendar) const;
+        static void _parseDates(Cursor& cursor, std::vector<boost::gregorian::date>& dates);
+        static void _parseValues(Cursor& cursor, std::vector<double>& values);
+    };
+}
+
+#endif //WILDCATSTKCORE_JSONSTREAMREADER_H
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include "JSONStreamWriter.h"
+#include "../General/WorkStealingPool.h"
+
+Common::JSONStreamWriterDataSet::JSONStreamWriterDataSet(Common::WorkStealingPool* pool) :
+        m_pool(pool)
+{
+
+}
+
+void Common::JSONStreamWriterDataSet::write(const std::string &fileName, const Common::DataSet &ds)
+{
+    const std::string& text = format(ds);
+
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("E: JSONStreamWriterDataSet::write : cannot open file " + fileName + ".");
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!file)
+        throw std::runtime_error("E: JSONStreamWriterDataSet::write : error while writing file " + fileName + ".");
+}
+
+const std::string& Common::JSONStreamWriterDataSet::format(const Common::DataSet &ds)
+{
+    m_variables.clear();
+    for (const auto& it: ds.getData())
+        m_variables.push_back(&it);
+    std::sort(m_variables.begin(), m_variables.end(),
+              [](const Variable* a, const Variable* b) { return a -> first < b -> first; });
+
+    const std::size_t threadCount = m_pool ? m_pool -> getThreadCount() : 1;
+    const std::size_t blockCount = std::max<std::size_t>(1, std::min<std::size_t>(threadCount, m_variables.size()));
+    if (m_buffers.size() < blockCount)
+        m_buffers.resize(blockCount);
+
+    const std::size_t blockSize = (m_variables.size() + blockCount - 1) / blockCount;
+    if (blockCount == 1)
+        _formatVariables(0, m_variables.size(), m_buffers[0]);
+    else
+        m_pool -> parallelFor(blockCount, [this, blockSize](std::size_t i)
+        {
+            _formatVariables(std::min(i * blockSize, m_variables.size()), std::min((i + 1) * blockSize, m_variables.size()),
+                             m_buffers[i]);
+        });
+
+    m_output.clear();
+    m_output += '{';
+    for (std::size_t i = 0; i < blockCount; ++i)
+    {
+        if (m_buffers[i].empty())
+            continue;
+        if (m_output.size() > 1)
+            m_output += ',';
+        m_output += m_buffers[i];
+    }
+    m_output += "\n}\n";
+
+    return m_output;
+}
+
+void Common::JSONStreamWriterDataSet::setPool(Common::WorkStealingPool* pool)
+{
+    m_pool = pool;
+}
+
+void Common::JSONStreamWriterDataSet::appendDouble(std::string &out, double value)
+{
+    if (std::isnan(value))
+    {
+        out += "\"nan\"";
+        return;
+    }
+    if (std::isinf(value))
+    {
+        out += value > 0 ? "\"inf\"" : "\"-inf\"";
+        return;
+    }
+
+    // Quoted like every property tree value, readers of the original files expect strings
+    char buffer[32];
+    int n = 0;
+    for (const char* format: {"%.15g", "%.16g", "%.17g"})
+    {
+        n = std::snprintf(buffer + 1, sizeof(buffer) - 2, format, value);
+        if (std::strtod(buffer + 1, nullptr) == value)
+            break;
+    }
+    buffer[0] = buffer[n + 1] = '"';
+    out.append(buffer, static_cast<std::size_t>(n + 2));
+}
+
+void Common::JSONStreamWriterDataSet::appendDate(std::string &out, const boost::gregorian::date &date)
+{
+    if (date.is_special())
+    {
+        out += '"';
+        out += boost::gregorian::to_iso_extended_string(date);
+        out += '"';
+        return;
+    }
+
+    const boost::gregorian::date::ymd_type ymd = date.year_month_day();
+    const unsigned int year = ymd.year, month = ymd.month, day = ymd.day;
+    const char buffer[12] = {'"',
+                             static_cast<char>('0' + year / 1000), static_cast<char>('0' + year / 100 % 10),
+                             static_cast<char>('0' + year / 10 % 10), static_cast<char>('0' + year % 10), '-',
+                             static_cast<char>('0' + month / 10), static_cast<char>('0' + month % 10), '-',
+                             static_cast<char>('0' + day / 10), static_cast<char>('0' + day % 10), '"'};
+    out.append(buffer, sizeof(buffer));
+}
+
+void Common::JSONStreamWriterDataSet::appendString(std::string &out, const std::string &value)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (const char c: value)
+    {
+        if (c == '"' or c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            out += "\\u00";
+            out += hex[(c >> 4) & 0xF];
+            out += hex[c & 0xF];
+        }
+        else
+            out += c;
+    }
+    out += '"';
+}
+
+void Common::JSONStreamWriterDataSet::_formatVariables(std::size_t first, std::size_t last, std::string &out) const
+{
+    out.clear();
+    for (std::size_t i = first; i < last; ++i)
+    {
+        const Variable& variable = *m_variables[i];
+        if (i != first)
+            out += ',';
+
+        out += "\n    ";
+        appendString(out, variable.first);
+        out += ": {\n        \"Dates\": [";
+        bool isFirst = true;
+        for (const auto& it: variable.second.getDatesView())
+        {
+            out += isFirst ? "\n            " : ",\n            ";
+            appendDate(out, it);
+            isFirst = false;
+        }
+
+        out += isFirst ? "],\n        \"Values\": [" : "\n        ],\n        \"Values\": [";
+        isFirst = true;
+        for (const auto& it: variable.second.getValuesView())
+        {
+            out += isFirst ? "\n            " : ",\n            ";
+            appendDouble(out, it);
+            isFirst = false;
+        }
+        out += isFirst ? "]\n    }" : "\n        ]\n    }";
+    }
+}
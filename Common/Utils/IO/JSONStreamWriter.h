@@ -0,0 +1,49 @@
+#ifndef WILDCATSTKCORE_JSONSTREAMWRITER_H
+#define WILDCATSTKCORE_JSONSTREAMWRITER_H
+
+#include <string>
+#include <vector>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include "../../Types/DataSet.h"
+
+namespace Common
+{
+    class WorkStealingPool;
+
+    //
+    // Direct writer for data sets in the layout written by boost::property_tree::write_json and read back by
+    // JSONStreamReaderDataSet: {"VAR": {"Dates": ["...", ...], "Values": ["...", ...]}, ...}, one array element per line
+    // and every value a string. Variables are written in name order into output buffers owned by the writer, which keep
+    // their capacity across calls, so a writer reused over many data sets stops allocating after the first one. Dates
+    // and doubles are formatted on the stack, doubles with the first of %.15g / %.16g / %.17g that round trips, NaN and
+    // infinities as "nan", "inf" and "-inf". Given a pool, variables are split into one contiguous block per pool
+    // thread, formatted concurrently into separate buffers and concatenated in order: the output does not depend on the
+    // pool. The pool is the caller's and must outlive the writer, or be reset before it goes.
+    //
+    class JSONStreamWriterDataSet
+    {
+    public:
+        explicit JSONStreamWriterDataSet(Common::WorkStealingPool* pool = nullptr);
+
+        void write(const std::string& fileName, const Common::DataSet& ds);
+        const std::string& format(const Common::DataSet& ds);
+
+        void setPool(Common::WorkStealingPool* pool);
+
+        static void appendDouble(std::string& out, double value);
+        static void appendDate(std::string& out, const boost::gregorian::date& date);
+        static void appendString(std::string& out, const std::string& value);
+
+    private:
+        typedef std::pair<const std::string, Common::TimeSeries> Variable;
+
+        Common::WorkStealingPool* m_pool;
+        std::vector<const Variable*> m_variables;
+        std::vector<std::string> m_buffers;
+        std::string m_output;
+
+        void _formatVariables(std::size_t first, std::size_t last, std::string& out) const;
+    };
+}
+
+#endif //WILDCATSTKCORE_JSONSTREAMWRITER_H
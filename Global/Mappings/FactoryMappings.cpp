@@ -8,13 +8,12 @@
 #include "../../Common/Math/Relative/RelativeModel.h"
 #include "../../Common/Math/Interpolation/Interpolator.h"
 #include "../../Common/Utils/General/AlgebraicExpressionInterpreter.h"
+#include "../../Common/Utils/General/AlgebraicBytecode.h"
 #include "../../Common/Seasonality/SeasonalDecompose.h"
 #include "../../Common/Auxiliary/FormulaVariable.h"
 
 using namespace Global;
 
-TransformationTypeCodeFactoryMapping* TransformationTypeCodeFactoryMapping::m_instance = nullptr;
-
 TransformationTypeCodeFactoryMapping::TransformationTypeCodeFactoryMapping()
 {
     const std::vector<std::string> allowedTransformationCodes = {"D", "R", "L", "LR"};
@@ -26,10 +25,9 @@ TransformationTypeCodeFactoryMapping::TransformationTypeCodeFactoryMapping()
 
 TransformationTypeCodeFactoryMapping* TransformationTypeCodeFactoryMapping::instance()
 {
-    if (!m_instance)
-        m_instance = new TransformationTypeCodeFactoryMapping();
-
-    return m_instance;
+    // Function-local static, initialised exactly once even when the first calls come from several threads
+    static TransformationTypeCodeFactoryMapping* const instance = new TransformationTypeCodeFactoryMapping();
+    return instance;
 }
 
 const Common::TransformationTypeFactory* TransformationTypeCodeFactoryMapping::getFactory(const std::string &transformationTypeCode) const
@@ -42,8 +40,6 @@ const Common::TransformationTypeFactory* TransformationTypeCodeFactoryMapping::g
 }
 
 
-RelativeModelFactoryMapping* RelativeModelFactoryMapping::m_instance = nullptr;
-
 RelativeModelFactoryMapping::RelativeModelFactoryMapping()
 {
     const std::vector<std::string> allowedRelativeSubTypeNames = {"growth", "volatility"};
@@ -53,10 +49,8 @@ RelativeModelFactoryMapping::RelativeModelFactoryMapping()
 
 RelativeModelFactoryMapping* RelativeModelFactoryMapping::instance()
 {
-    if (!m_instance)
-        m_instance = new RelativeModelFactoryMapping();
-
-    return m_instance;
+    static RelativeModelFactoryMapping* const instance = new RelativeModelFactoryMapping();
+    return instance;
 }
 
 const Math::RelativeModelFactory* RelativeModelFactoryMapping::getFactory(const std::string &relativeModelSubTypeName) const
@@ -69,8 +63,6 @@ const Math::RelativeModelFactory* RelativeModelFactoryMapping::getFactory(const
 }
 
 
-InterpolatorFactoryMapping* InterpolatorFactoryMapping::m_instance = nullptr;
-
 InterpolatorFactoryMapping::InterpolatorFactoryMapping()
 {
     const std::vector<std::string> allowedInterpolationMethods = {"linear", "cubic"};
@@ -80,10 +72,8 @@ InterpolatorFactoryMapping::InterpolatorFactoryMapping()
 
 InterpolatorFactoryMapping* InterpolatorFactoryMapping::instance()
 {
-    if (!m_instance)
-        m_instance = new InterpolatorFactoryMapping();
-
-    return m_instance;
+    static InterpolatorFactoryMapping* const instance = new InterpolatorFactoryMapping();
+    return instance;
 }
 
 const Math::InterpolatorFactory* InterpolatorFactoryMapping::getFactory(const std::string &interpolationMethodName) const
@@ -96,8 +86,6 @@ const Math::InterpolatorFactory* InterpolatorFactoryMapping::getFactory(const st
 }
 
 
-AlgebraicExpressionFactoryMapping* AlgebraicExpressionFactoryMapping::m_instance = nullptr;
-
 AlgebraicExpressionFactoryMapping::AlgebraicExpressionFactoryMapping()
 {
     AlgebraicOperatorSymbols* ptr = AlgebraicOperatorSymbols::instance();
@@ -106,14 +94,18 @@ AlgebraicExpressionFactoryMapping::AlgebraicExpressionFactoryMapping()
     m_mapping.emplace(ptr -> getMultiplicationSymbol(), new Common::MultiplicationExpressionFactory());
     m_mapping.emplace(ptr -> getDivisionSymbol(), new Common::DivisionExpressionFactory());
     m_mapping.emplace(ptr -> getExponentiationSymbol(), new Common::ExponentiationExpressionFactory());
+
+    m_opCodes.emplace(ptr -> getAdditionSymbol(), Common::AlgebraicOpCode::Add);
+    m_opCodes.emplace(ptr -> getSubstractionSymbol(), Common::AlgebraicOpCode::Substract);
+    m_opCodes.emplace(ptr -> getMultiplicationSymbol(), Common::AlgebraicOpCode::Multiply);
+    m_opCodes.emplace(ptr -> getDivisionSymbol(), Common::AlgebraicOpCode::Divide);
+    m_opCodes.emplace(ptr -> getExponentiationSymbol(), Common::AlgebraicOpCode::Power);
 }
 
 AlgebraicExpressionFactoryMapping* AlgebraicExpressionFactoryMapping::instance()
 {
-    if (!m_instance)
-        m_instance = new AlgebraicExpressionFactoryMapping();
-
-    return m_instance;
+    static AlgebraicExpressionFactoryMapping* const instance = new AlgebraicExpressionFactoryMapping();
+    return instance;
 }
 
 const Common::BinaryOperatorExpressionFactory* AlgebraicExpressionFactoryMapping::getFactory(const std::string &symbol) const
@@ -125,7 +117,15 @@ const Common::BinaryOperatorExpressionFactory* AlgebraicExpressionFactoryMapping
                                         symbol);
 }
 
-SeasonalDecomposeFactoryMapping* SeasonalDecomposeFactoryMapping::g_instance = nullptr;
+Common::AlgebraicOpCode AlgebraicExpressionFactoryMapping::getOpCode(const std::string &symbol) const
+{
+    const auto it = m_opCodes.find(symbol);
+    if (it != m_opCodes.end())
+        return it -> second;
+    else
+        throw std::out_of_range("E: Global::AlgebraicExpressionFactoryMapping::getOpCode : unknown algebraic symbol " +
+                                symbol);
+}
 
 SeasonalDecomposeFactoryMapping::SeasonalDecomposeFactoryMapping()
 {
@@ -136,10 +136,8 @@ SeasonalDecomposeFactoryMapping::SeasonalDecomposeFactoryMapping()
 
 SeasonalDecomposeFactoryMapping* SeasonalDecomposeFactoryMapping::instance()
 {
-    if (!g_instance)
-        g_instance = new SeasonalDecomposeFactoryMapping();
-
-    return g_instance;
+    static SeasonalDecomposeFactoryMapping* const instance = new SeasonalDecomposeFactoryMapping();
+    return instance;
 }
 
 const Common::SeasonalDecomposeFactory* SeasonalDecomposeFactoryMapping::getFactory(const std::string &decompositionType) const
@@ -151,8 +149,6 @@ const Common::SeasonalDecomposeFactory* SeasonalDecomposeFactoryMapping::getFact
         decompositionType);
 }
 
-RestoreSeasonFactoryMapping* RestoreSeasonFactoryMapping::g_instance = nullptr;
-
 RestoreSeasonFactoryMapping::RestoreSeasonFactoryMapping()
 {
     const std::vector<std::string> allowedDecompositionTypes = {"additive", "multiplicative"};
@@ -162,10 +158,8 @@ RestoreSeasonFactoryMapping::RestoreSeasonFactoryMapping()
 
 RestoreSeasonFactoryMapping* RestoreSeasonFactoryMapping::instance()
 {
-    if (!g_instance)
-        g_instance = new RestoreSeasonFactoryMapping();
-
-    return g_instance;
+    static RestoreSeasonFactoryMapping* const instance = new RestoreSeasonFactoryMapping();
+    return instance;
 }
 
 const Common::RestoreSeasonFactory* RestoreSeasonFactoryMapping::getFactory(const std::string &decompositionType) const
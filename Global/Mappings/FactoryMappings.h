@@ -22,6 +22,7 @@ namespace Common
     class BinaryOperatorExpressionFactory;
     class SeasonalDecomposeFactory;
     class RestoreSeasonFactory;
+    enum class AlgebraicOpCode : unsigned char;
 }
 
 namespace Global
@@ -35,7 +36,6 @@ namespace Global
     private:
         TransformationTypeCodeFactoryMapping();
 
-        static TransformationTypeCodeFactoryMapping *m_instance;
         std::map<std::string, const Common::TransformationTypeFactory *> m_mapping;
     };
 
@@ -49,7 +49,6 @@ namespace Global
     private:
         RelativeModelFactoryMapping();
 
-        static RelativeModelFactoryMapping *m_instance;
         std::map<std::string, const Math::RelativeModelFactory *> m_mapping;
     };
 
@@ -63,7 +62,6 @@ namespace Global
     private:
         InterpolatorFactoryMapping();
 
-        static InterpolatorFactoryMapping* m_instance;
         std::map<std::string, const Math::InterpolatorFactory *> m_mapping;
     };
 
@@ -73,12 +71,13 @@ namespace Global
     public:
         static AlgebraicExpressionFactoryMapping* instance();
         const Common::BinaryOperatorExpressionFactory* getFactory(const std::string& symbol) const;
+        Common::AlgebraicOpCode getOpCode(const std::string& symbol) const;
 
     private:
         AlgebraicExpressionFactoryMapping();
 
-        static AlgebraicExpressionFactoryMapping* m_instance;
         std::map<std::string, const Common::BinaryOperatorExpressionFactory *> m_mapping;
+        std::map<std::string, Common::AlgebraicOpCode> m_opCodes;
     };
 
 
@@ -91,7 +90,6 @@ namespace Global
     private:
         SeasonalDecomposeFactoryMapping();
 
-        static SeasonalDecomposeFactoryMapping* g_instance;
         std::map<std::string, const Common::SeasonalDecomposeFactory *> m_mapping;
     };
 
@@ -105,7 +103,6 @@ namespace Global
     private:
         RestoreSeasonFactoryMapping();
 
-        static RestoreSeasonFactoryMapping* g_instance;
         std::map<std::string, const Common::RestoreSeasonFactory *> m_mapping;
     };
 }
@@ -4,8 +4,6 @@
 
 #include "AlgebraicOperatorSymbols.h"
 
-Global::AlgebraicOperatorSymbols* Global::AlgebraicOperatorSymbols::m_instance = nullptr;
-
 Global::AlgebraicOperatorSymbols::AlgebraicOperatorSymbols() :
     m_additionSymbol("+"),
     m_substractionSymbol("-"),
@@ -13,15 +11,15 @@ Global::AlgebraicOperatorSymbols::AlgebraicOperatorSymbols() :
     m_divisionSymbol("/"),
     m_exponentiationSymbol("^"),
     m_leftBracketSymbol("("),
-    m_rightBracketSymbol(")")
+    m_rightBracketSymbol(")"),
+    m_argumentSeparatorSymbol(",")
 {}
 
 Global::AlgebraicOperatorSymbols* Global::AlgebraicOperatorSymbols::instance()
 {
-    if (!m_instance)
-        m_instance = new AlgebraicOperatorSymbols();
-
-    return m_instance;
+    // Function-local static, initialised exactly once even when the first calls come from several threads
+    static AlgebraicOperatorSymbols* const instance = new AlgebraicOperatorSymbols();
+    return instance;
 }
 
 std::string Global::AlgebraicOperatorSymbols::getAdditionSymbol() const
@@ -59,3 +57,7 @@ std::string Global::AlgebraicOperatorSymbols::getRightBracketSymbol() const
     return m_rightBracketSymbol;
 }
 
+std::string Global::AlgebraicOperatorSymbols::getArgumentSeparatorSymbol() const
+{
+    return m_argumentSeparatorSymbol;
+}
@@ -21,11 +21,11 @@ namespace Global
         std::string getExponentiationSymbol() const;
         std::string getLeftBracketSymbol() const;
         std::string getRightBracketSymbol() const;
+        std::string getArgumentSeparatorSymbol() const;
 
     private:
         AlgebraicOperatorSymbols();
 
-        static AlgebraicOperatorSymbols* m_instance;
         const std::string m_additionSymbol;
         const std::string m_substractionSymbol;
         const std::string m_multiplicationSymbol;
@@ -33,6 +33,7 @@ namespace Global
         const std::string m_exponentiationSymbol;
         const std::string m_leftBracketSymbol;
         const std::string m_rightBracketSymbol;
+        const std::string m_argumentSeparatorSymbol;
     };
 }
 
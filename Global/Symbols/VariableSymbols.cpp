@@ -0,0 +1,47 @@
+#include <limits>
+#include <stdexcept>
+#include "VariableSymbols.h"
+
+const Global::VariableId Global::VariableSymbols::invalidId = std::numeric_limits<Global::VariableId>::max();
+
+Global::VariableSymbols* Global::VariableSymbols::instance()
+{
+    // Function-local static, initialised exactly once even when the first calls come from several threads
+    static VariableSymbols* const instance = new VariableSymbols();
+    return instance;
+}
+
+Global::VariableId Global::VariableSymbols::intern(const std::string &variableName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_ids.find(variableName);
+    if (it != m_ids.end())
+        return it -> second;
+
+    const auto id = static_cast<Global::VariableId>(m_names.size());
+    m_names.push_back(variableName);
+    m_ids.emplace(variableName, id);
+    return id;
+}
+
+Global::VariableId Global::VariableSymbols::find(const std::string &variableName) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_ids.find(variableName);
+    return it != m_ids.end() ? it -> second : invalidId;
+}
+
+std::string Global::VariableSymbols::getName(Global::VariableId id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id < m_names.size())
+        return m_names[id];
+
+    throw std::out_of_range("E: Global::VariableSymbols::getName : unknown variable id " + std::to_string(id));
+}
+
+std::size_t Global::VariableSymbols::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_names.size();
+}
@@ -0,0 +1,40 @@
+#ifndef WILDCATSTKCORE_VARIABLESYMBOLS_H
+#define WILDCATSTKCORE_VARIABLESYMBOLS_H
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace Global
+{
+    typedef unsigned int VariableId;
+
+    //
+    // Process-wide table interning variable names into dense integer ids. Ids are assigned in order of first use and
+    // never released, so they can be cached by configuration objects and used to index per-variable arrays.
+    //
+    class VariableSymbols
+    {
+    public:
+        static const VariableId invalidId;
+
+        static VariableSymbols* instance();
+
+        VariableId intern(const std::string& variableName);
+        VariableId find(const std::string& variableName) const;
+        std::string getName(VariableId id) const;
+        std::size_t size() const;
+
+    private:
+        VariableSymbols() = default;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, VariableId> m_ids;
+        std::deque<std::string> m_names;
+    };
+}
+
+
+#endif //WILDCATSTKCORE_VARIABLESYMBOLS_H
@@ -13,6 +13,7 @@
 #include "Utils.h"
 #include "../Common/Config/ConfigVariable.h"
 #include "../Common/Config/ConfigModelSpec.h"
+#include "../Common/Config/ConfigModelSpecBatch.h"
 #include "../Common/Config/CurveModelDef.h"
 #include "../Common/Types/TimeSeries.h"
 #include "../Common/Types/DataSet.h"
@@ -171,6 +172,160 @@ BOOST_AUTO_TEST_SUITE(ConfigVariable)
         BOOST_CHECK_THROW(fx.getTimeSeries().getValue(outRangeDate), std::out_of_range);
     }
 
+    BOOST_AUTO_TEST_CASE(TimeSeries_views)
+    {
+        const Fixture fx = Fixture();
+        const Common::TimeSeries ts = fx.getTimeSeries();
+
+        const Common::ValuesView values = ts.getValuesView();
+        const Common::DatesView dates = ts.getDatesView();
+        BOOST_CHECK_EQUAL(values.size(), ts.length());
+        BOOST_CHECK_EQUAL(dates.size(), ts.length());
+        BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), fx.f_values.begin(), fx.f_values.end());
+        BOOST_CHECK(dates.toVector() == fx.f_dates);
+        BOOST_CHECK_EQUAL(dates.back(), fx.f_dates.back());
+        BOOST_CHECK_EQUAL(values.subView(1, 2).front(), fx.f_values.at(1));
+        BOOST_CHECK_THROW(values.at(ts.length()), std::out_of_range);
+        BOOST_CHECK_THROW(values.subView(3, 2), std::out_of_range);
+    }
+
+    BOOST_AUTO_TEST_CASE(TimeSeries_dateIndex_regular)
+    {
+        const Fixture fx = Fixture();
+        Common::TimeSeries ts = fx.getTimeSeries();
+        BOOST_CHECK(ts.getFrequency() == Common::DateIndex::Frequency::QuarterEnd);
+
+        ts.pushBack(boost::gregorian::date(2018, 3, 31), 600.);
+        BOOST_CHECK(ts.getFrequency() == Common::DateIndex::Frequency::QuarterEnd);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2018, 3, 31)), 4);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2017, 9, 30)), 2);
+        BOOST_CHECK(!ts.hasDate(boost::gregorian::date(2017, 8, 31)));
+        BOOST_CHECK(!ts.hasDate(boost::gregorian::date(2016, 12, 31)));
+        BOOST_CHECK(!ts.hasDate(boost::gregorian::date(2018, 6, 30)));
+
+        const std::vector<boost::gregorian::date> monthEnds = {boost::gregorian::date(2019, 1, 31), boost::gregorian::date(2019, 2, 28),
+                                                               boost::gregorian::date(2019, 3, 31)};
+        const Common::TimeSeries monthly("M", {1., 2., 3.}, monthEnds);
+        BOOST_CHECK(monthly.getFrequency() == Common::DateIndex::Frequency::MonthEnd);
+        BOOST_CHECK_EQUAL(monthly.getIndex(boost::gregorian::date(2019, 2, 28)), 1);
+
+        const std::vector<boost::gregorian::date> yearEnds = {boost::gregorian::date(2017, 12, 31), boost::gregorian::date(2018, 12, 31)};
+        const Common::TimeSeries yearly("Y", {1., 2.}, yearEnds);
+        BOOST_CHECK(yearly.getFrequency() == Common::DateIndex::Frequency::YearEnd);
+
+        // 2019-10-04 is a Friday, 2019-10-07 the following Monday
+        const std::vector<boost::gregorian::date> businessDays = {boost::gregorian::date(2019, 10, 3), boost::gregorian::date(2019, 10, 4),
+                                                                  boost::gregorian::date(2019, 10, 7), boost::gregorian::date(2019, 10, 8)};
+        Common::TimeSeries daily("D", {1., 2., 3., 4.}, businessDays);
+        BOOST_CHECK(daily.getFrequency() == Common::DateIndex::Frequency::BusinessDaily);
+        BOOST_CHECK_EQUAL(daily.getIndex(boost::gregorian::date(2019, 10, 7)), 2);
+        BOOST_CHECK(!daily.hasDate(boost::gregorian::date(2019, 10, 5)));
+        daily.pushBack(boost::gregorian::date(2019, 10, 9), 5.);
+        BOOST_CHECK(daily.getFrequency() == Common::DateIndex::Frequency::BusinessDaily);
+        BOOST_CHECK_EQUAL(daily.getIndex(boost::gregorian::date(2019, 10, 9)), 4);
+    }
+
+    BOOST_AUTO_TEST_CASE(TimeSeries_dateIndex_irregular)
+    {
+        const Fixture fx = Fixture();
+        Common::TimeSeries ts = fx.getTimeSeries();
+
+        // Gap in the calendar: falls back to binary search
+        ts.pushBack(boost::gregorian::date(2018, 6, 30), 600.);
+        BOOST_CHECK(ts.getFrequency() == Common::DateIndex::Frequency::Irregular);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2018, 6, 30)), 4);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2017, 6, 30)), 1);
+        BOOST_CHECK_THROW(ts.getIndex(boost::gregorian::date(2018, 3, 31)), std::out_of_range);
+
+        // Unsorted calendar: falls back to linear scan
+        ts.pushBack(boost::gregorian::date(2000, 6, 30), 234.);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2000, 6, 30)), 5);
+        BOOST_CHECK_EQUAL(ts.getIndex(boost::gregorian::date(2017, 12, 31)), 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(TimeSeries_calendar_sharing)
+    {
+        const Fixture fx = Fixture();
+        const Common::TimeSeries ts = fx.getTimeSeries();
+        Common::TimeSeries copy = ts;
+        BOOST_CHECK(copy.getCalendar() == ts.getCalendar());
+
+        const Common::TimeSeries sum = ts + copy;
+        BOOST_CHECK(sum.getCalendar() == ts.getCalendar());
+
+        // Extending a series detaches its calendar, other series keep the original dates
+        copy.pushBack(boost::gregorian::date(2018, 3, 31), 600.);
+        BOOST_CHECK(copy.getCalendar() != ts.getCalendar());
+        BOOST_CHECK_EQUAL(copy.length(), 5);
+        BOOST_CHECK_EQUAL(ts.getDatesView().size(), 4);
+        BOOST_CHECK_EQUAL(sum.getDatesView().size(), 4);
+
+        const Common::TimeSeries other("UK_GDP", {1., 2., 3., 4.}, ts.getCalendar());
+        BOOST_CHECK(other.getCalendar() == ts.getCalendar());
+        BOOST_CHECK_EQUAL(other.getValue(boost::gregorian::date(2017, 9, 30)), 3.);
+        BOOST_CHECK_THROW(Common::TimeSeries("UK_GDP", {1., 2.}, ts.getCalendar()), std::runtime_error);
+        BOOST_CHECK_THROW(copy.shareCalendar(ts.getCalendar()), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(TimeSeries_copyOnWrite)
+    {
+        const Fixture fx = Fixture();
+        const Common::TimeSeries ts = fx.getTimeSeries();
+        Common::TimeSeries copy = ts;
+        BOOST_CHECK(copy.getValuesView().data() == ts.getValuesView().data());
+
+        const Common::TimeSeries renamed("US_GDP_COPY", ts);
+        BOOST_CHECK(renamed.getValuesView().data() == ts.getValuesView().data());
+        BOOST_CHECK_EQUAL(renamed.getName(), "US_GDP_COPY");
+        BOOST_CHECK(renamed != ts);
+
+        copy.pushBack(boost::gregorian::date(2018, 3, 31), 600.);
+        BOOST_CHECK(copy.getValuesView().data() != ts.getValuesView().data());
+        BOOST_CHECK_EQUAL(copy.getValue(4), 600.);
+        BOOST_CHECK_EQUAL(ts.length(), 4);
+        BOOST_CHECK(ts == fx.getTimeSeries());
+
+        // Data set accessors share the stored buffers
+        const Common::DataSet ds(std::vector<Common::TimeSeries>{ts});
+        BOOST_CHECK(ds.getTimeSeries("US_GDP").getValuesView().data() == ts.getValuesView().data());
+        BOOST_CHECK(ds.getData().at("US_GDP").getValuesView().data() == ts.getValuesView().data());
+    }
+
+    BOOST_AUTO_TEST_CASE(TimeSeries_expressions, *utf::tolerance(tol))
+    {
+        const Fixture fx = Fixture();
+        const Common::TimeSeries ts = fx.getTimeSeries();
+        const Common::TimeSeries other("US_CPI", {1., 2., 4., 8.}, fx.f_dates);
+
+        // Chained operators are evaluated in one pass on the leftmost operand calendar
+        const Common::TimeSeries res = ts / other / other + ts * other - other;
+        BOOST_CHECK(res.getCalendar() == ts.getCalendar());
+        BOOST_CHECK_EQUAL(res.getName(), "US_GDP/US_CPI/US_CPI+US_GDP*US_CPI-US_CPI");
+        for (unsigned int i = 0; i < res.length(); ++i)
+        {
+            const double x = fx.f_values.at(i), y = other.getValue(i);
+            BOOST_TEST(res.getValue(i) == x / y / y + x * y - y);
+        }
+
+        BOOST_TEST((ts + other).getValues() == (other + ts).getValues(), tt::per_element());
+        BOOST_CHECK((ts - other).getDates() == fx.f_dates);
+
+        Common::TimeSeries assigned;
+        assigned = ts * ts;
+        BOOST_CHECK_EQUAL(assigned.getName(), "US_GDP*US_GDP");
+        BOOST_CHECK_EQUAL(assigned.getValue(1), 346. * 346.);
+
+        // Operands are held by value, an expression built from temporaries can be kept and evaluated later
+        const auto deferred = ts * Common::TimeSeries("US_CPI", other.getValues(), fx.f_dates) + fx.getTimeSeries();
+        const Common::TimeSeries evaluated = deferred;
+        BOOST_TEST(evaluated.getValue(2) == fx.f_values.at(2) * 4. + fx.f_values.at(2));
+        BOOST_CHECK(evaluated != Common::TimeSeries("RENAMED", evaluated));
+
+        const Common::TimeSeries shifted("US_CPI", {1., 2., 4., 8.}, {boost::gregorian::date(2017, 3, 31), boost::gregorian::date(2017, 6, 30),
+                                                                       boost::gregorian::date(2017, 9, 30), boost::gregorian::date(2018, 3, 31)});
+        BOOST_CHECK_THROW(ts / other / shifted, std::runtime_error);
+    }
+
     BOOST_AUTO_TEST_CASE(TimeSeries_excep)
     {
         Common::TimeSeries ts;
@@ -226,7 +381,83 @@ BOOST_AUTO_TEST_SUITE(DataSet)
         BOOST_CHECK(ds != otherDs);
         BOOST_CHECK(ds.getData().at(variableName) == ts);
         BOOST_CHECK(ds.getTimeSeries(variableName) == ts);
+        BOOST_CHECK(ds.getTimeSeriesRef(variableName) == ts);
         BOOST_CHECK_THROW(ds.getTimeSeries("US_CPI"), std::runtime_error);
+        BOOST_CHECK_THROW(ds.getTimeSeriesRef("US_CPI"), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(DataSet_variableIds)
+    {
+        const std::vector<boost::gregorian::date> dates = {boost::gregorian::date(2017, 3, 31), boost::gregorian::date(2017, 6, 30)};
+        Common::DataSet ds(std::vector<Common::TimeSeries>{Common::TimeSeries("US_GDP", {1., 2.}, dates),
+                                                           Common::TimeSeries("US_CPI", {3., 4.}, dates)});
+
+        Global::VariableSymbols* symbols = Global::VariableSymbols::instance();
+        const Global::VariableId gdp = symbols -> intern("US_GDP");
+        BOOST_CHECK_EQUAL(symbols -> intern("US_GDP"), gdp);
+        BOOST_CHECK_EQUAL(symbols -> find("US_GDP"), gdp);
+        BOOST_CHECK_EQUAL(symbols -> getName(gdp), "US_GDP");
+        BOOST_CHECK_EQUAL(symbols -> find("NOT_INTERNED_VARIABLE"), Global::VariableSymbols::invalidId);
+        BOOST_CHECK_EQUAL(Common::ConfigVariable("US_GDP|D|1").getBasenameId(), gdp);
+
+        BOOST_CHECK(ds.hasVariable(gdp));
+        BOOST_CHECK(&ds.getTimeSeriesRef(gdp) == &ds.getTimeSeriesRef("US_GDP"));
+        BOOST_CHECK_EQUAL(ds.getValue(gdp, boost::gregorian::date(2017, 6, 30)), 2.);
+        BOOST_CHECK_EQUAL(ds.getValue(symbols -> intern("US_CPI"), 0), 3.);
+
+        // Copies index their own series
+        const Common::DataSet copy = ds;
+        BOOST_CHECK(&copy.getTimeSeriesRef(gdp) == &copy.getTimeSeriesRef("US_GDP"));
+
+        ds.removeData("US_GDP");
+        BOOST_CHECK(!ds.hasVariable(gdp));
+        BOOST_CHECK_THROW(ds.getTimeSeriesRef(gdp), std::runtime_error);
+        BOOST_CHECK(copy.hasVariable(gdp));
+        BOOST_CHECK(!ds.hasVariable(Global::VariableSymbols::invalidId));
+    }
+
+    BOOST_AUTO_TEST_CASE(DataSet_panel)
+    {
+        const std::vector<boost::gregorian::date> dates = {boost::gregorian::date(2017, 3, 31), boost::gregorian::date(2017, 6, 30),
+                                                           boost::gregorian::date(2017, 9, 30)};
+        const std::vector<boost::gregorian::date> otherDates = {boost::gregorian::date(2017, 6, 30), boost::gregorian::date(2017, 9, 30),
+                                                                boost::gregorian::date(2017, 12, 31)};
+
+        const Common::DataSet ds(std::vector<Common::TimeSeries>{Common::TimeSeries("US_GDP", {1., 2., 3.}, dates),
+                                                                 Common::TimeSeries("US_CPI", {4., 5., 6.}, dates),
+                                                                 Common::TimeSeries("UK_CPI", {7., 8., 9.}, otherDates)});
+
+        // Series observed on the same dates share one calendar in the data set
+        BOOST_CHECK(ds.getTimeSeriesRef("US_GDP").getCalendar() == ds.getTimeSeriesRef("US_CPI").getCalendar());
+        BOOST_CHECK(ds.getTimeSeriesRef("US_GDP").getCalendar() != ds.getTimeSeriesRef("UK_CPI").getCalendar());
+        BOOST_CHECK_EQUAL(Common::Calendar(dates).hash(), ds.getTimeSeriesRef("US_CPI").getCalendar() -> hash());
+        BOOST_CHECK_NE(Common::Calendar(dates).hash(), Common::Calendar(otherDates).hash());
+
+        const Common::DataPanel panel = ds.getPanel({"US_GDP", "US_CPI"});
+        BOOST_CHECK(panel.getCalendar() == ds.getTimeSeriesRef("US_GDP").getCalendar());
+        BOOST_CHECK_EQUAL(panel.getRowCount(), 3);
+        BOOST_CHECK_EQUAL(panel.getColumnCount(), 2);
+        const Common::DataPanel::ColumnHandle cpi = panel.getColumnHandle("US_CPI");
+        BOOST_CHECK_EQUAL(panel.getValue(cpi, panel.getRow(boost::gregorian::date(2017, 6, 30))), 5.);
+        BOOST_CHECK_EQUAL(panel.data()[cpi * panel.getRowCount()], 4.);
+        BOOST_CHECK(panel.getTimeSeries(cpi) == ds.getTimeSeriesRef("US_CPI"));
+
+        // Mixed calendars are aligned on the union of dates, gaps are NaN
+        const Common::DataPanel mixedPanel = ds.getPanel({"US_GDP", "UK_CPI"});
+        BOOST_CHECK_EQUAL(mixedPanel.getRowCount(), 4);
+        const Common::ValuesView ukCpi = mixedPanel.getColumn(mixedPanel.getColumnHandle("UK_CPI"));
+        BOOST_CHECK(std::isnan(ukCpi[0]));
+        BOOST_CHECK_EQUAL(ukCpi[3], 9.);
+        BOOST_CHECK(std::isnan(mixedPanel.getValue(mixedPanel.getColumnHandle("US_GDP"), 3)));
+
+        BOOST_CHECK_THROW(mixedPanel.getColumnHandle("JP_CPI"), std::runtime_error);
+        BOOST_CHECK_THROW(mixedPanel.getRow(boost::gregorian::date(2019, 3, 31)), std::out_of_range);
+        BOOST_CHECK_THROW(mixedPanel.getColumn(2), std::out_of_range);
+
+        Common::DataPanel otherPanel(ds.getTimeSeriesRef("US_GDP").getCalendar());
+        BOOST_CHECK_THROW(otherPanel.addColumn("US_GDP", Common::ValuesView(std::vector<double>{1.})), std::runtime_error);
+        otherPanel.addColumn(ds.getTimeSeriesRef("US_GDP"));
+        BOOST_CHECK_THROW(otherPanel.addColumn(ds.getTimeSeriesRef("US_GDP")), std::runtime_error);
     }
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -391,6 +622,169 @@ BOOST_AUTO_TEST_SUITE(ConfigModelSpec)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(ConfigModelSpec_regression_calibrate_sufficientStatistics, *utf::tolerance(1e-4))
+    {
+        const Common::ConfigVariable dVar("HANG_SENG|R|0");
+        const std::vector<Common::ConfigVariable> idVars = {Common::ConfigVariable("DOW_JONES|R|0"),
+                                                           Common::ConfigVariable("US_GDP_SAAR|R|0")};
+
+        Fixture fx(dVar, idVars);
+        fx.f_modelSubType = "ols_lm";
+        fx.f_startDate = boost::gregorian::date(1970, 3, 31);
+
+        const std::string inputDataSetFileName = "sample_dataSet_clean.json";
+        Common::DataSet ds;
+        loadDataSet(inputRelativePath + inputDataSetFileName, ds);
+
+        Common::ConfigModelSpecRegression full(fx.f_dv, fx.f_ivs, fx.f_modelSubType, fx.f_startDate);
+        full.calibrate(ds);
+        Common::ConfigModelSpecRegression compact(fx.f_dv, fx.f_ivs, fx.f_modelSubType, fx.f_startDate, true, false);
+        compact.calibrate(ds);
+
+        BOOST_TEST(compact.getCalibratedCoefficients() == full.getCalibratedCoefficients(), tt::per_element());
+
+        const Math::ANOVASummary expected = full.getANOVASummary();
+        const Math::ANOVASummary summary = compact.getANOVASummary();
+        BOOST_CHECK_EQUAL(summary.fittedValues.size(), 0);
+        BOOST_CHECK_EQUAL(summary.residuals.size(), 0);
+
+        BOOST_TEST(summary.sampleSize == expected.sampleSize);
+        BOOST_TEST(summary.totalMSEVariance == expected.totalMSEVariance);
+        BOOST_TEST(summary.modelMSEVariance == expected.modelMSEVariance);
+        BOOST_TEST(summary.residualMSEVariance == expected.residualMSEVariance);
+        BOOST_TEST(summary.RSquared == expected.RSquared);
+        BOOST_TEST(summary.adjRSquared == expected.adjRSquared);
+        for (unsigned long i = 0; i < fx.f_ivs.size() + 1; ++i)
+        {
+            BOOST_TEST(summary.coefficientSummaryStat.at(i).stdErr == expected.coefficientSummaryStat.at(i).stdErr);
+            BOOST_TEST(summary.coefficientSummaryStat.at(i).pValue == expected.coefficientSummaryStat.at(i).pValue);
+        }
+
+        const Math::ANOVASummary withResiduals = compact.getANOVASummary(ds);
+        BOOST_TEST(withResiduals.fittedValues == expected.fittedValues, tt::per_element());
+        BOOST_TEST(withResiduals.residuals == expected.residuals, tt::per_element());
+    }
+
+    BOOST_AUTO_TEST_CASE(ConfigModelSpec_regression_calibrateRolling, *utf::tolerance(1e-6))
+    {
+        const Common::ConfigVariable dVar("HANG_SENG|R|0");
+        const std::vector<Common::ConfigVariable> idVars = {Common::ConfigVariable("DOW_JONES|R|0"),
+                                                           Common::ConfigVariable("US_GDP_SAAR|R|0")};
+
+        Fixture fx(dVar, idVars);
+        fx.f_modelSubType = "ols_lm";
+        fx.f_startDate = boost::gregorian::date(1970, 3, 31);
+
+        const std::string inputDataSetFileName = "sample_dataSet_clean.json";
+        Common::DataSet ds;
+        loadDataSet(inputRelativePath + inputDataSetFileName, ds);
+
+        Common::ConfigModelSpecRegression cms(fx.f_dv, fx.f_ivs, fx.f_modelSubType, fx.f_startDate);
+        cms.calibrate(ds);
+
+        const Math::RollingRegressionPath path = cms.calibrateRolling(ds, 20, true);
+        const std::vector<boost::gregorian::date> dates = cms.getRegressionDates(ds);
+        BOOST_CHECK_EQUAL(path.lastObservations.front(), 19);
+        BOOST_CHECK_EQUAL(path.lastObservations.back() + 1, dates.size());
+
+        const std::vector<double> coefficients = cms.getCalibratedCoefficients();
+        for (unsigned long j = 0; j < coefficients.size(); ++j)
+            BOOST_TEST(path.coefficients(path.coefficients.size1() - 1, j) == coefficients.at(j));
+    }
+
+    BOOST_AUTO_TEST_CASE(ConfigModelSpec_regression_batchCalibration, *utf::tolerance(1e-10))
+    {
+        const std::string inputDataSetFileName = "sample_dataSet_clean.json";
+        Common::DataSet ds;
+        loadDataSet(inputRelativePath + inputDataSetFileName, ds);
+
+        const boost::gregorian::date startDate(1970, 3, 31);
+        const std::vector<std::string> dependentVariables = {"HANG_SENG", "US_TSY_10Y", "US_TSY_1Y", "VIX", "US_TBILL_3M"};
+        Common::ConfigMap<Common::ConfigModelSpec> specs;
+        for (const auto& it: dependentVariables)
+            specs.addConfigItem(it, Common::ConfigModelSpecRegression(Common::ConfigVariable(it + "|R|0"),
+                                                                      {Common::ConfigVariable("DOW_JONES|R|0"),
+                                                                       Common::ConfigVariable("US_GDP_SAAR|R|0")},
+                                                                      "ols_lm", startDate));
+        specs.addConfigItem("BROKEN", Common::ConfigModelSpecRegression(Common::ConfigVariable("HANG_SENG|R|0"),
+                                                                        {Common::ConfigVariable("NOT_IN_DATASET|R|0")},
+                                                                        "ols_lm", startDate));
+
+        Common::ConfigModelSpecBatchCalibrator batch(3);
+        BOOST_CHECK_EQUAL(batch.getThreadCount(), 3);
+        const std::vector<Common::ConfigModelSpecCalibration> results = batch.calibrate(specs, ds);
+
+        BOOST_REQUIRE_EQUAL(results.size(), dependentVariables.size() + 1);
+        for (unsigned long i = 1; i < results.size(); ++i)
+            BOOST_CHECK(results.at(i - 1).key < results.at(i).key);
+
+        for (const auto& it: results)
+        {
+            if (it.key == "BROKEN")
+            {
+                BOOST_CHECK(!it.spec);
+                BOOST_CHECK(!it.error.empty());
+                continue;
+            }
+
+            BOOST_REQUIRE(it.spec);
+            BOOST_CHECK(it.error.empty());
+
+            std::unique_ptr<Common::ConfigModelSpec> sequential = specs.getValue(it.key);
+            sequential -> calibrate(ds);
+            BOOST_TEST(dynamic_cast<const Common::ConfigModelSpecRegression&>(*it.spec).getCalibratedCoefficients() ==
+                       dynamic_cast<const Common::ConfigModelSpecRegression&>(*sequential).getCalibratedCoefficients(),
+                       tt::per_element());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ConfigModelSpec_regression_calibrateShared, *utf::tolerance(1e-10))
+    {
+        const std::string inputDataSetFileName = "sample_dataSet_clean.json";
+        Common::DataSet ds;
+        loadDataSet(inputRelativePath + inputDataSetFileName, ds);
+
+        const boost::gregorian::date startDate(1970, 3, 31);
+        const std::vector<Common::ConfigVariable> idVars = {Common::ConfigVariable("DOW_JONES|R|0"),
+                                                            Common::ConfigVariable("US_GDP_SAAR|R|0")};
+        std::vector<Common::ConfigModelSpecRegression> shared, sequential;
+        for (const auto& it: {"US_TSY_10Y", "US_TSY_1Y", "US_TBILL_3M"})
+        {
+            shared.emplace_back(Common::ConfigVariable(std::string(it) + "|R|0"), idVars, "ols_lm", startDate, true,
+                                shared.size() != 1);
+            sequential.push_back(shared.back());
+        }
+
+        std::vector<Common::ConfigModelSpecRegression*> group;
+        for (auto& it: shared)
+            group.push_back(&it);
+        Common::ConfigModelSpecRegression::calibrateShared(group, ds);
+
+        for (unsigned long i = 0; i < shared.size(); ++i)
+        {
+            BOOST_CHECK(shared.at(i).hasSameDesign(shared.front()));
+            sequential.at(i).calibrate(ds);
+            BOOST_TEST(shared.at(i).getCalibratedCoefficients() == sequential.at(i).getCalibratedCoefficients(), tt::per_element());
+
+            const Math::ANOVASummary anova = shared.at(i).getANOVASummary();
+            const Math::ANOVASummary expected = sequential.at(i).getANOVASummary();
+            BOOST_TEST(anova.residualMSEVariance == expected.residualMSEVariance);
+            BOOST_TEST(anova.RSquared == expected.RSquared);
+            for (unsigned long j = 0; j < expected.coefficientSummaryStat.size(); ++j)
+                BOOST_TEST(anova.coefficientSummaryStat.at(j).stdErr == expected.coefficientSummaryStat.at(j).stdErr);
+        }
+
+        // Neither a different driver set nor the same drivers over a shorter sample share the design matrix
+        const Common::ConfigModelSpecRegression otherDrivers(Common::ConfigVariable("US_TSY_1Y|R|0"),
+                                                             {Common::ConfigVariable("DOW_JONES|R|0")}, "ols_lm", startDate);
+        BOOST_CHECK(!otherDrivers.hasSameDesign(shared.front()));
+
+        Common::ConfigModelSpecRegression otherSample(Common::ConfigVariable("HANG_SENG|R|0"), idVars, "ols_lm", startDate);
+        BOOST_CHECK(otherSample.hasSameDesign(shared.front()));
+        group.push_back(&otherSample);
+        BOOST_CHECK_THROW(Common::ConfigModelSpecRegression::calibrateShared(group, ds), std::runtime_error);
+    }
+
     BOOST_AUTO_TEST_CASE(ConfigModelSpec_regression_uncalibrated)
     {
         const Common::ConfigVariable dVar("HANG_SENG|R|0");
@@ -8,6 +8,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/unit_test_suite.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include "Utils.h"
 #include <cmath>
 #include <random>
@@ -17,6 +18,7 @@
 #include "../Common/Math/Statistics/Stat.h"
 #include "../Common/Math/Relative/RelativeModel.h"
 #include "../Common/Math/MLRegression/RegressionModel.h"
+#include "../Common/Math/MLRegression/RollingRegression.h"
 #include "../Common/Math/Interpolation/Interpolator.h"
 #include "../Common/Math/Interpolation/LinearInterpolator.h"
 #include "../Common/Math/Interpolation/NaturalCubicSplineInterpolator.h"
@@ -450,6 +452,79 @@ BOOST_AUTO_TEST_SUITE(MLRegression)
                        tt::per_element());
     }
 
+    BOOST_AUTO_TEST_CASE(CholeskyDecomposition_blockedDefiniteness, *utf::tolerance(1e-8))
+    {
+        // 150 columns span three panels, so trailing updates across panels are exercised
+        const unsigned long dim = 150;
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+        boost::numeric::ublas::matrix<double> X(2 * dim, dim);
+        for (unsigned long i = 0; i < X.size1(); ++i)
+            for (unsigned long j = 0; j < dim; ++j)
+                X(i, j) = uniform(generator);
+
+        const boost::numeric::ublas::matrix<double> XtX = prod(trans(X), X);
+        Math::CholeskyDecompose ch;
+        ch.decompose(XtX);
+        BOOST_CHECK(ch.getDefiniteness() == Math::CholeskyDecompose::Definiteness::PositiveDefinite);
+        BOOST_CHECK_EQUAL(ch.hasFailed(), false);
+        BOOST_CHECK_EQUAL(ch.getDimension(), dim);
+
+        const std::vector<double>& factor = ch.getFactor();
+        const boost::numeric::ublas::matrix<double> L = ch.getCholeskyFactor();
+        for (unsigned long j = 0; j < dim; ++j)
+            for (unsigned long i = 0; i < dim; ++i)
+                BOOST_TEST(factor[i + j * dim] == L(i, j));
+
+        const boost::numeric::ublas::matrix<double> LLt = prod(L, trans(L));
+        for (unsigned long i = 0; i < dim; ++i)
+            BOOST_TEST(boost::numeric::ublas::row(LLt, i) == boost::numeric::ublas::row(XtX, i), tt::per_element());
+
+        // Repeated column makes XtX semi-definite, flipping the sign of one of its entries makes it indefinite
+        boost::numeric::ublas::matrix<double> Y(4, 3);
+        Y(0, 0) = 2, Y(0, 1) = 1; Y(1, 0) = 3, Y(1, 1) = 2; Y(2, 0) = 7, Y(2, 1) = 1; Y(3, 0) = -1, Y(3, 1) = 4;
+        boost::numeric::ublas::column(Y, 2) = boost::numeric::ublas::column(Y, 0);
+
+        boost::numeric::ublas::matrix<double> YtY = prod(trans(Y), Y);
+        ch.decompose(YtY);
+        BOOST_CHECK(ch.getDefiniteness() == Math::CholeskyDecompose::Definiteness::PositiveSemiDefinite);
+        BOOST_CHECK_EQUAL(ch.hasFailed(), true);
+
+        YtY(2, 0) = YtY(0, 2) = -YtY(0, 2);
+        ch.decompose(YtY);
+        BOOST_CHECK(ch.getDefiniteness() == Math::CholeskyDecompose::Definiteness::Indefinite);
+        BOOST_CHECK_EQUAL(ch.hasFailed(), true);
+    }
+
+    BOOST_AUTO_TEST_CASE(CholeskyDecomposition_updateDowndate, *utf::tolerance(1e-8))
+    {
+        boost::numeric::ublas::matrix<double> M(4, 4);
+        M(0, 0) = 18.; M(0, 1) = 22.; M(0, 2) = 54.; M(0, 3) = 42.;
+        M(1, 0) = 22.; M(1, 1) = 70.; M(1, 2) = 86.; M(1, 3) = 62.;
+        M(2, 0) = 54.; M(2, 1) = 86.; M(2, 2) = 174.; M(2, 3) = 134.;
+        M(3, 0) = 42.; M(3, 1) = 62.; M(3, 2) = 134.; M(3, 3) = 106.;
+        const std::vector<double> x = {1., -2., 0.5, 3.};
+
+        boost::numeric::ublas::matrix<double> updated = M;
+        for (unsigned long i = 0; i < 4; ++i)
+            for (unsigned long j = 0; j < 4; ++j)
+                updated(i, j) += x[i] * x[j];
+
+        Math::CholeskyDecompose ch, expected;
+        ch.decompose(M);
+        ch.update(x);
+        expected.decompose(updated);
+        BOOST_TEST(ch.getFactor() == expected.getFactor(), tt::per_element());
+
+        BOOST_CHECK_EQUAL(ch.downdate(x), true);
+        expected.decompose(M);
+        BOOST_TEST(ch.getFactor() == expected.getFactor(), tt::per_element());
+
+        // Removing a row that was never there leaves a matrix that is not positive definite
+        BOOST_CHECK_EQUAL(ch.downdate({10., 0., 0., 0.}), false);
+        BOOST_CHECK_EQUAL(ch.hasFailed(), true);
+    }
+
     BOOST_AUTO_TEST_CASE(MoorePenroseRegressionTest, *utf::tolerance(1e-4))
     {
         const std::string fileName = "sample_dataSet_clean.json";
@@ -540,6 +615,155 @@ BOOST_AUTO_TEST_SUITE(MLRegression)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(QRDecompositionTest, *utf::tolerance(1e-8))
+    {
+        // 40 columns so that the trailing matrix update of the first panel is exercised
+        const unsigned long rows = 120, cols = 40;
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+        boost::numeric::ublas::matrix<double> X(rows, cols);
+        for (unsigned long i = 0; i < rows; ++i)
+            for (unsigned long j = 0; j < cols; ++j)
+                X(i, j) = uniform(generator);
+
+        Math::QRDecompose qr;
+        qr.decompose(X);
+        BOOST_CHECK_EQUAL(qr.hasFailed(), false);
+        BOOST_CHECK_EQUAL(qr.getRank(), cols);
+
+        const boost::numeric::ublas::matrix<double> R = qr.getR();
+        const boost::numeric::ublas::matrix<double> XtX = prod(trans(X), X);
+        const boost::numeric::ublas::matrix<double> RtR = prod(trans(R), R);
+        for (unsigned long i = 0; i < cols; ++i)
+            BOOST_TEST(boost::numeric::ublas::row(RtR, i) == boost::numeric::ublas::row(XtX, i), tt::per_element());
+
+        const boost::numeric::ublas::matrix<double> identity = prod(qr.computeInverseRtR(), XtX);
+        for (unsigned long i = 0; i < cols; ++i)
+            for (unsigned long j = 0; j < cols; ++j)
+                BOOST_CHECK_SMALL(identity(i, j) - (i == j ? 1. : 0.), 1e-8);
+    }
+
+    BOOST_AUTO_TEST_CASE(QRRegressionTest, *utf::tolerance(1e-4))
+    {
+        const std::string fileName = "sample_dataSet_clean.json";
+        const std::string dVarName = "HANG_SENG";
+        const std::vector<std::string> idVarNames = {"DOW_JONES", "US_GDP_SAAR"};
+        FxInputData fx(dVarName, idVarNames, fileName);
+        boost::numeric::ublas::vector<double> coefficients(fx.m_idVars.size2());
+
+        Math::RegressionModelAlgorithmQR qrRegression;
+        qrRegression.calibrate(coefficients, fx.m_dVar, fx.m_idVars);
+        BOOST_CHECK_EQUAL(qrRegression.hasFailed(), false);
+
+        const std::vector<double> targetCoefficients = {1.0957, 1.9296, -0.021125};
+        BOOST_TEST(coefficients == targetCoefficients, tt::per_element());
+
+        const double residualMSE = 0.008797539080674183;
+        const boost::numeric::ublas::matrix<double> covMatrix = qrRegression.computeCoefficientCovarianceMatrix(residualMSE);
+
+        const std::vector<double> expectedStdErrs = {0.13136823, 1.29721688, 0.01689724};
+        for (unsigned int i = 0; i < covMatrix.size1(); ++i)
+            BOOST_TEST(sqrt(covMatrix(i, i)) == expectedStdErrs[i]);
+    }
+
+    BOOST_AUTO_TEST_CASE(RollingRegressionTest, *utf::tolerance(1e-6))
+    {
+        const std::string fileName = "sample_dataSet_clean.json";
+        const std::string dVarName = "HANG_SENG";
+        const std::vector<std::string> idVarNames = {"DOW_JONES", "US_GDP_SAAR"};
+        FxInputData fx(dVarName, idVarNames, fileName);
+        const unsigned long window = 40, nRows = fx.m_idVars.size1(), nCols = fx.m_idVars.size2();
+
+        const Math::RollingRegressionPath rolling = Math::RollingRegression(window).calibrate(fx.m_dVar, fx.m_idVars);
+        BOOST_CHECK_EQUAL(rolling.coefficients.size1(), nRows - window + 1);
+        BOOST_CHECK_EQUAL(rolling.lastObservations.back(), nRows - 1);
+
+        // Every window against a full calibration of the same rows
+        for (unsigned long w = 0; w < rolling.coefficients.size1(); w += 7)
+        {
+            const boost::numeric::ublas::range rows(w, w + window), columns(0, nCols);
+            const boost::numeric::ublas::matrix<double> X = boost::numeric::ublas::project(fx.m_idVars, rows, columns);
+            const boost::numeric::ublas::vector<double> Y = boost::numeric::ublas::project(fx.m_dVar, rows);
+
+            Math::RegressionModelAlgorithmQR qr;
+            boost::numeric::ublas::vector<double> coefficients(nCols);
+            qr.calibrate(coefficients, Y, X);
+            const Math::ANOVASummary summary = qr.getANOVA();
+
+            BOOST_TEST(rolling.residualMSEVariance.at(w) == summary.residualMSEVariance);
+            for (unsigned long j = 0; j < nCols; ++j)
+            {
+                BOOST_TEST(rolling.coefficients(w, j) == coefficients(j));
+                BOOST_TEST(rolling.stdErrs(w, j) == summary.coefficientSummaryStat.at(j).stdErr);
+            }
+        }
+
+        // The last expanding window is the whole sample
+        const Math::RollingRegressionPath expanding = Math::RollingRegression(window, true).calibrate(fx.m_dVar, fx.m_idVars);
+        const std::vector<double> targetCoefficients = {1.0957, 1.9296, -0.021125};
+        const std::vector<double> expectedStdErrs = {0.13136823, 1.29721688, 0.01689724};
+        for (unsigned long j = 0; j < nCols; ++j)
+        {
+            BOOST_TEST(expanding.coefficients(expanding.coefficients.size1() - 1, j) == targetCoefficients.at(j), tt::tolerance(1e-4));
+            BOOST_TEST(expanding.stdErrs(expanding.stdErrs.size1() - 1, j) == expectedStdErrs.at(j), tt::tolerance(1e-4));
+        }
+
+        // Refactorising every window gives the same path as carrying the factor
+        const Math::RollingRegressionPath refactorised = Math::RollingRegression(window, false, 1).calibrate(fx.m_dVar, fx.m_idVars);
+        for (unsigned long w = 0; w < rolling.coefficients.size1(); ++w)
+        {
+            BOOST_TEST(refactorised.residualMSEVariance.at(w) == rolling.residualMSEVariance.at(w));
+            for (unsigned long j = 0; j < nCols; ++j)
+                BOOST_TEST(refactorised.coefficients(w, j) == rolling.coefficients(w, j));
+        }
+
+        // A NaN row only blanks the windows holding it
+        boost::numeric::ublas::vector<double> Y(fx.m_dVar);
+        const unsigned long nanRow = window + 10;
+        Y(nanRow) = std::numeric_limits<double>::quiet_NaN();
+        const Math::RollingRegressionPath withNaN = Math::RollingRegression(window).calibrate(Y, fx.m_idVars);
+        for (unsigned long w = 0; w < withNaN.coefficients.size1(); ++w)
+        {
+            const bool holdsNaN = w <= nanRow and nanRow < w + window;
+            BOOST_CHECK_EQUAL(std::isnan(withNaN.residualMSEVariance.at(w)), holdsNaN);
+            if (!holdsNaN)
+                BOOST_TEST(withNaN.coefficients(w, 1) == rolling.coefficients(w, 1));
+        }
+        const Math::RollingRegressionPath expandingWithNaN = Math::RollingRegression(window, true).calibrate(Y, fx.m_idVars);
+        BOOST_CHECK(std::isnan(expandingWithNaN.coefficients(expandingWithNaN.coefficients.size1() - 1, 0)));
+        BOOST_CHECK(!std::isnan(expandingWithNaN.coefficients(nanRow - window, 0)));
+
+        BOOST_CHECK_THROW(Math::RollingRegression(nCols).calibrate(fx.m_dVar, fx.m_idVars), std::runtime_error);
+        BOOST_CHECK_THROW(Math::RollingRegression(window, false, 0).calibrate(fx.m_dVar, fx.m_idVars), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(RollingRegression_largeMean)
+    {
+        // R^2 close to one on a mean of 1e8, the residual sum of squares must still match a QR fit of each window. The
+        // downdates lose a few digits of the slope between refactorisations, well within its standard error.
+        boost::numeric::ublas::vector<double> Y(300);
+        boost::numeric::ublas::matrix<double> X(300, 2);
+        for (unsigned long i = 0; i < X.size1(); ++i)
+        {
+            X(i, 0) = 1, X(i, 1) = i / 10.;
+            Y(i) = 1e8 + 2 * X(i, 1) + 1e-3 * std::sin(7. * i);
+        }
+
+        const unsigned long window = 50;
+        const Math::RollingRegressionPath rolling = Math::RollingRegression(window).calibrate(Y, X);
+        for (unsigned long w = 0; w < rolling.coefficients.size1(); w += 11)
+        {
+            const boost::numeric::ublas::range rows(w, w + window), columns(0, 2);
+            Math::RegressionModelAlgorithmQR qr;
+            boost::numeric::ublas::vector<double> coefficients(2);
+            qr.calibrate(coefficients, boost::numeric::ublas::vector<double>(boost::numeric::ublas::project(Y, rows)),
+                         boost::numeric::ublas::matrix<double>(boost::numeric::ublas::project(X, rows, columns)));
+
+            BOOST_CHECK_CLOSE(rolling.residualMSEVariance.at(w), qr.getANOVA().residualMSEVariance, 1e-2);
+            BOOST_CHECK_CLOSE(rolling.coefficients(w, 1), coefficients(1), 1e-4);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(RegressionModelOLS_badData)
     {
         boost::numeric::ublas::vector<double> betaHat(2);
@@ -571,8 +795,166 @@ BOOST_AUTO_TEST_SUITE(MLRegression)
         ch.calibrate(betaHat, Y, X);
         BOOST_CHECK_EQUAL(ch.hasFailed(), true);
 
+        Math::RegressionModelAlgorithmQR qr;
+        qr.calibrate(betaHat, Y, X);
+        BOOST_CHECK_EQUAL(qr.isRankDeficient(), true);
+        BOOST_CHECK_EQUAL(qr.getR().size1(), 3);
+
         Math::RegressionModelOLS reg;
         BOOST_CHECK_THROW(reg.calibrate(betaHat, Y, X), std::runtime_error);
     }
 
+    BOOST_AUTO_TEST_CASE(RegressionWorkspace_sharedNormalEquations)
+    {
+        boost::numeric::ublas::vector<double> Y(5);
+        Y(0) = 1.2, Y(1) = 1.9, Y(2) = 3.2, Y(3) = 3.8, Y(4) = 5.1;
+
+        boost::numeric::ublas::matrix<double> X(5, 2);
+        for (unsigned long i = 0; i < X.size1(); ++i)
+            X(i, 0) = 1, X(i, 1) = i + 1;
+
+        const Math::RegressionWorkspace workspace(Y, X);
+        boost::numeric::ublas::vector<double> qrBetaHat(2), chBetaHat(2), mpBetaHat(2);
+
+        Math::RegressionModelAlgorithmQR qr;
+        qr.calibrate(qrBetaHat, workspace);
+        BOOST_CHECK_EQUAL(workspace.hasStatistics(), false);
+
+        Math::RegressionModelAlgorithmCholesky ch;
+        ch.calibrate(chBetaHat, workspace);
+        BOOST_CHECK_EQUAL(workspace.hasStatistics(), true);
+
+        const boost::numeric::ublas::matrix<double>* XtX = &workspace.getStatistics().XtX;
+        Math::RegressionModelAlgorithmMoorePenrose mp;
+        mp.calibrate(mpBetaHat, workspace);
+        BOOST_CHECK_EQUAL(&workspace.getStatistics().XtX, XtX);
+
+        BOOST_CHECK_CLOSE(workspace.getStatistics().XtX(0, 1), 15., 1e-10);
+        BOOST_CHECK_CLOSE(workspace.getStatistics().XtY(1), 55.3, 1e-10);
+        for (unsigned long i = 0; i < 2; ++i)
+        {
+            BOOST_CHECK_CLOSE(chBetaHat(i), qrBetaHat(i), 1e-8);
+            BOOST_CHECK_CLOSE(mpBetaHat(i), qrBetaHat(i), 1e-8);
+        }
+
+        // The chain is built with the model and shared by its copies
+        Math::RegressionModelOLS reg;
+        const Math::RegressionModelOLS copy(reg);
+        boost::numeric::ublas::vector<double> regBetaHat(2), copyBetaHat(2);
+        reg.calibrate(regBetaHat, Y, X);
+        copy.calibrate(copyBetaHat, Y, X);
+        BOOST_CHECK_CLOSE(regBetaHat(1), qrBetaHat(1), 1e-10);
+        BOOST_CHECK_CLOSE(copyBetaHat(1), qrBetaHat(1), 1e-10);
+    }
+
+    BOOST_AUTO_TEST_CASE(RegressionModelOLS_multipleDependentVariables)
+    {
+        boost::numeric::ublas::matrix<double> Y(6, 3);
+        boost::numeric::ublas::matrix<double> X(6, 3);
+        for (unsigned long i = 0; i < X.size1(); ++i)
+        {
+            X(i, 0) = i + 1, X(i, 1) = std::sin(i + 1.), X(i, 2) = 1;
+            Y(i, 0) = 2 * X(i, 0) - X(i, 1) + 0.1 * std::cos(3. * i);
+            Y(i, 1) = -X(i, 0) + 3 * X(i, 1) + 0.2 * std::cos(5. * i);
+            Y(i, 2) = 0.5 + 0.3 * std::cos(7. * i);
+        }
+
+        Math::QRDecompose qr;
+        qr.decompose(X);
+        const boost::numeric::ublas::matrix<double> solution = qr.solve(Y);
+        for (unsigned long j = 0; j < Y.size2(); ++j)
+        {
+            const boost::numeric::ublas::vector<double> expected = qr.solve(boost::numeric::ublas::vector<double>(boost::numeric::ublas::column(Y, j)));
+            for (unsigned long i = 0; i < X.size2(); ++i)
+                BOOST_CHECK_CLOSE(solution(i, j), expected(i), 1e-10);
+        }
+
+        // One factorisation for every column, each model keeps its own ANOVA
+        std::vector<Math::RegressionModelOLS> models = {Math::RegressionModelOLS(), Math::RegressionModelOLS(false), Math::RegressionModelOLS()};
+        std::vector<Math::RegressionModel*> modelPtrs;
+        for (auto& it: models)
+            modelPtrs.push_back(&it);
+
+        boost::numeric::ublas::matrix<double> betaHat(3, 3);
+        models.front().calibrate(betaHat, Y, X, modelPtrs);
+        for (unsigned long j = 0; j < Y.size2(); ++j)
+        {
+            Math::RegressionModelOLS single;
+            boost::numeric::ublas::vector<double> expected(3);
+            single.calibrate(expected, boost::numeric::ublas::vector<double>(boost::numeric::ublas::column(Y, j)), X);
+
+            const Math::ANOVASummary anova = models.at(j).getANOVA();
+            const Math::ANOVASummary expectedAnova = single.getANOVA();
+            BOOST_CHECK_CLOSE(anova.residualMSEVariance, expectedAnova.residualMSEVariance, 1e-8);
+            BOOST_CHECK_CLOSE(anova.totalMSEVariance, expectedAnova.totalMSEVariance, 1e-8);
+            for (unsigned long i = 0; i < X.size2(); ++i)
+            {
+                BOOST_CHECK_CLOSE(betaHat(i, j), expected(i), 1e-10);
+                BOOST_CHECK_CLOSE(anova.coefficientSummaryStat.at(i).stdErr, expectedAnova.coefficientSummaryStat.at(i).stdErr, 1e-8);
+            }
+        }
+        BOOST_CHECK_EQUAL(models.at(1).getANOVA().residuals.size(), 0);
+        BOOST_CHECK_EQUAL(models.at(2).getANOVA().residuals.size(), 6);
+
+        // The factor is shared by the group, recalibrating one model leaves the others as they were
+        const Math::ANOVASummary before = models.at(1).getANOVA();
+        boost::numeric::ublas::vector<double> firstBetaHat(2);
+        models.at(0).calibrate(firstBetaHat, boost::numeric::ublas::vector<double>(boost::numeric::ublas::column(Y, 0)),
+                               boost::numeric::ublas::matrix<double>(boost::numeric::ublas::subrange(X, 0, 6, 0, 2)));
+        for (unsigned long i = 0; i < X.size2(); ++i)
+            BOOST_CHECK_EQUAL(models.at(1).getANOVA().coefficientSummaryStat.at(i).stdErr, before.coefficientSummaryStat.at(i).stdErr);
+
+        modelPtrs.pop_back();
+        BOOST_CHECK_THROW(models.front().calibrate(betaHat, Y, X, modelPtrs), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(RegressionModelOLS_sufficientStatistics_largeMean)
+    {
+        // R^2 close to one on a mean of 1e8: YtY is ~1e18 while the residual sum of squares is ~1e-4, any expansion
+        // around the raw moments would lose every digit of it
+        boost::numeric::ublas::vector<double> Y(200);
+        boost::numeric::ublas::matrix<double> X(200, 2), Ys(200, 2);
+        for (unsigned long i = 0; i < X.size1(); ++i)
+        {
+            X(i, 0) = 1, X(i, 1) = i / 10.;
+            Y(i) = Ys(i, 0) = 1e8 + 2 * X(i, 1) + 1e-3 * std::sin(7. * i);
+            Ys(i, 1) = -1e8 + 3 * X(i, 1) + 1e-3 * std::cos(5. * i);
+        }
+
+        // Same regression on the data shifted by the mean, where no cancellation is possible: the intercept absorbs the
+        // shift and every sum of squares is unchanged
+        boost::numeric::ublas::vector<double> shiftedY(Y - boost::numeric::ublas::scalar_vector<double>(Y.size(), 1e8));
+        Math::RegressionModelOLS full, compact(false), shifted;
+        boost::numeric::ublas::vector<double> fullBetaHat(2), compactBetaHat(2), shiftedBetaHat(2);
+        full.calibrate(fullBetaHat, Y, X);
+        compact.calibrate(compactBetaHat, Y, X);
+        shifted.calibrate(shiftedBetaHat, shiftedY, X);
+
+        const Math::ANOVASummary expected = shifted.getANOVA();
+        BOOST_CHECK(expected.RSquared > 1 - 1e-8);
+        for (const auto& anova: {full.getANOVA(), compact.getANOVA()})
+        {
+            BOOST_CHECK_CLOSE(anova.totalMean, expected.totalMean + 1e8, 1e-12);
+            BOOST_CHECK_CLOSE(anova.totalMSEVariance, expected.totalMSEVariance, 1e-8);
+            BOOST_CHECK_CLOSE(anova.modelMSEVariance, expected.modelMSEVariance, 1e-6);
+            BOOST_CHECK_CLOSE(anova.residualMSEVariance, expected.residualMSEVariance, 1e-4);
+            BOOST_CHECK_CLOSE(1 - anova.RSquared, 1 - expected.RSquared, 1e-4);
+            BOOST_CHECK_CLOSE(anova.coefficientSummaryStat.at(1).stdErr, expected.coefficientSummaryStat.at(1).stdErr, 1e-4);
+        }
+
+        // The compact factor keeps R only, further columns are solved on the semi-normal equations
+        std::vector<Math::RegressionModelOLS> models = {Math::RegressionModelOLS(false), Math::RegressionModelOLS(false)};
+        const std::vector<Math::RegressionModel*> modelPtrs = {&models.at(0), &models.at(1)};
+        boost::numeric::ublas::matrix<double> betaHat(2, 2);
+        models.front().calibrate(betaHat, Ys, X, modelPtrs);
+        for (unsigned long j = 0; j < Ys.size2(); ++j)
+        {
+            boost::numeric::ublas::vector<double> singleBetaHat(2);
+            full.calibrate(singleBetaHat, boost::numeric::ublas::vector<double>(boost::numeric::ublas::column(Ys, j)), X);
+            for (unsigned long i = 0; i < X.size2(); ++i)
+                BOOST_CHECK_CLOSE(betaHat(i, j), singleBetaHat(i), 1e-6);
+            BOOST_CHECK_CLOSE(models.at(j).getANOVA().residualMSEVariance, full.getANOVA().residualMSEVariance, 1e-4);
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
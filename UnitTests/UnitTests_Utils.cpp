@@ -13,8 +13,22 @@
 #include <iostream>
 #include <cmath>
 #include "../Common/Utils/IO/JSONParser.h"
+#include "../Common/Utils/IO/JSONStreamReader.h"
+#include "../Common/Utils/IO/BinaryDataSet.h"
+#include "../Common/Utils/IO/JSONStreamWriter.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <sys/stat.h>
 #include "../Common/Utils/General/Tools.h"
 #include "../Common/Utils/General/AlgebraicExpressionInterpreter.h"
+#include "../Common/Utils/General/AlgebraicFormulaSet.h"
+#include "../Common/Utils/General/AlgebraicNativeCatalogue.h"
+#include "../Common/Utils/General/WorkStealingPool.h"
+#include "../Common/Auxiliary/FormulaVariable.h"
 
 
 namespace utf = boost::unit_test;
@@ -45,6 +59,160 @@ BOOST_AUTO_TEST_SUITE(JSONParser)
         BOOST_CHECK(fromInputJSONds == fromOutputJSONds);
     }
 
+    BOOST_AUTO_TEST_CASE(streamReader_matches_ptree)
+    {
+        for (const std::string inFileName: {"readJSON_data_test.json", "sample_dataSet_clean.json"})
+        {
+            boost::property_tree::ptree root;
+            Common::JSONParser().readJSON(inputRelativePath + inFileName, root);
+
+            Common::DataSet expected;
+            for (const auto& it: root)
+            {
+                std::vector<boost::gregorian::date> dates;
+                for (const auto& jt: it.second.get_child("Dates"))
+                    dates.push_back(boost::gregorian::from_string(jt.second.get_value<std::string>()));
+                std::vector<double> values;
+                for (const auto& jt: it.second.get_child("Values"))
+                    values.push_back(jt.second.get_value<double>());
+                expected.addData(Common::TimeSeries(it.first, values, dates));
+            }
+
+            BOOST_CHECK(Common::JSONStreamReaderDataSet().read(inputRelativePath + inFileName) == expected);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(streamReader_format)
+    {
+        const Common::JSONStreamReaderDataSet reader;
+        const Common::DataSet ds = reader.parse(
+                "{\"US_GDP\": {\"Values\": [\"1.5\", 2e1, null], \"Unit\": {\"a\": [1, \"]\"]},"
+                " \"Dates\": [\"2017-03-31\", \"2017/06/30\", \"2017-Sep-30\"]},"
+                " \"US\\u005fCPI\": {\"Dates\": [\"2017-03-31\", \"2017-06-30\", \"2017-09-30\"], \"Values\": [1, 2, 3]},"
+                " \"EMPTY\": {\"Dates\": [], \"Values\": []}}");
+
+        BOOST_CHECK_EQUAL(ds.getData().size(), 3);
+        const Common::TimeSeries& gdp = ds.getTimeSeriesRef("US_GDP");
+        BOOST_CHECK_EQUAL(gdp.getValue(0), 1.5);
+        BOOST_CHECK_EQUAL(gdp.getValue(boost::gregorian::date(2017, 6, 30)), 20.);
+        BOOST_CHECK(std::isnan(gdp.getValue(2)));
+        BOOST_CHECK(ds.getTimeSeriesRef("US_CPI").getCalendar() == gdp.getCalendar());
+        BOOST_CHECK_EQUAL(ds.getTimeSeriesRef("EMPTY").length(), 0);
+
+        BOOST_CHECK(Common::JSONStreamReaderDataSet::parseDate("2019-12-31", "2019-12-31" + 10) == boost::gregorian::date(2019, 12, 31));
+        BOOST_CHECK_THROW(Common::JSONStreamReaderDataSet::parseDate("2019-02-30", "2019-02-30" + 10), std::out_of_range);
+
+        BOOST_CHECK_THROW(reader.parse("{\"A\": {\"Dates\": [\"2017-03-31\"]}}"), std::runtime_error);
+        BOOST_CHECK_THROW(reader.parse("{\"A\": {\"Dates\": [\"2017-03-31\"], \"Values\": [1, 2]}}"), std::runtime_error);
+        BOOST_CHECK_THROW(reader.parse("{\"A\": {\"Dates\": [\"2017-03-31\"], \"Values\": [x]}}"), std::runtime_error);
+        BOOST_CHECK_THROW(reader.parse("{\"A\": {\"Dates\": [], \"Values\": []}} {"), std::runtime_error);
+        BOOST_CHECK_THROW(reader.read(inputRelativePath + "missing_file.json"), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(streamWriter_roundTrip)
+    {
+        const Common::JSONStreamReaderDataSet reader;
+        Common::DataSet ds = reader.read(inputRelativePath + "sample_dataSet_clean.json");
+        ds.addData(Common::TimeSeries("GAPS", {0.1, std::nan(""), 1. / 3., -1e-300},
+                                      {boost::gregorian::date(2017, 3, 31), boost::gregorian::date(2017, 6, 30),
+                                       boost::gregorian::date(2017, 9, 30), boost::gregorian::date(2017, 12, 31)}));
+
+        Common::JSONStreamWriterDataSet writer;
+        const std::string serial = writer.format(ds);
+        const Common::DataSet fromSerial = reader.parse(serial);
+        BOOST_CHECK(fromSerial.getTimeSeriesRef("US_GDP_SAAR") == ds.getTimeSeriesRef("US_GDP_SAAR"));
+        BOOST_CHECK_EQUAL(fromSerial.getValue("GAPS", 2), 1. / 3.);
+        BOOST_CHECK(std::isnan(fromSerial.getValue("GAPS", 1)));
+
+        // Output does not depend on the pool, and buffers are reused between calls
+        Common::WorkStealingPool pool(3);
+        writer.setPool(&pool);
+        BOOST_CHECK_EQUAL(writer.format(ds), serial);
+        BOOST_CHECK_EQUAL(writer.format(ds), serial);
+        BOOST_CHECK_EQUAL(writer.format(Common::DataSet()), "{\n}\n");
+        writer.setPool(nullptr);
+
+        // Same text as the property tree writer wherever both pick the same digits
+        const Common::TimeSeries shortSeries("SHORT", {0.5, std::nan(""), 2., -1.25},
+                                        {boost::gregorian::date(2017, 3, 31), boost::gregorian::date(2017, 6, 30),
+                                         boost::gregorian::date(2017, 9, 30), boost::gregorian::date(2017, 12, 31)});
+        boost::property_tree::ptree root, child, dates, values;
+        for (std::size_t i = 0; i < shortSeries.length(); ++i)
+        {
+            boost::property_tree::ptree date, value;
+            date.put_value(boost::gregorian::to_iso_extended_string(shortSeries.getDates().at(i)));
+            value.put_value(shortSeries.getValue(i));
+            dates.push_back(std::make_pair("", date)), values.push_back(std::make_pair("", value));
+        }
+        child.add_child("Dates", dates), child.add_child("Values", values);
+        root.add_child(shortSeries.getName(), child);
+        std::ostringstream expected;
+        boost::property_tree::write_json(expected, root);
+        Common::DataSet shortDs;
+        shortDs.addData(shortSeries);
+        BOOST_CHECK_EQUAL(writer.format(shortDs), expected.str());
+
+        std::string out;
+        Common::JSONStreamWriterDataSet::appendDouble(out, 0.1);
+        Common::JSONStreamWriterDataSet::appendDate(out, boost::gregorian::date(1987, 1, 2));
+        Common::JSONStreamWriterDataSet::appendString(out, "A\"B");
+        BOOST_CHECK_EQUAL(out, "\"0.1\"\"1987-01-02\"\"A\\\"B\"");
+
+        // 16 significant digits are enough for 0.3 + 0.6, 17 only when needed
+        out.clear();
+        Common::JSONStreamWriterDataSet::appendDouble(out, 0.3 + 0.6);
+        Common::JSONStreamWriterDataSet::appendDouble(out, std::sqrt(2.));
+        BOOST_CHECK_EQUAL(out, "\"0.8999999999999999\"\"1.4142135623730951\"");
+    }
+
+    BOOST_AUTO_TEST_CASE(binaryDataSet_roundTrip)
+    {
+        const std::string binFileName = actualOutputRelativePath + "binaryDataSet_test.wcds";
+        const Common::DataSet expected = Common::JSONStreamReaderDataSet().read(inputRelativePath + "sample_dataSet_clean.json");
+        Common::BinaryDataSetWriter().write(binFileName, expected);
+
+        Common::TimeSeries ts;
+        {
+            const Common::BinaryDataSetReader reader(binFileName);
+            BOOST_CHECK_EQUAL(reader.getVariableNames().size(), expected.getData().size());
+            BOOST_CHECK(reader.getDataSet() == expected);
+            BOOST_CHECK_THROW(reader.getTimeSeries("NOT_A_VARIABLE"), std::runtime_error);
+
+            const std::string name = reader.getVariableNames().front();
+            ts = reader.getTimeSeries(name);
+            BOOST_CHECK(ts == expected.getTimeSeriesRef(name));
+            BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(ts.getValuesView().begin()) % 64, 0);
+            BOOST_CHECK(reader.getTimeSeries(name).getValuesView().begin() == ts.getValuesView().begin());
+        }
+
+        // The mapping outlives the reader, extending a mapped series copies it out
+        const Common::TimeSeries mapped = ts;
+        ts.pushBack(boost::gregorian::date(2100, 12, 31), 1.);
+        BOOST_CHECK_EQUAL(ts.length(), mapped.length() + 1);
+        BOOST_CHECK(ts.getValuesView().begin() != mapped.getValuesView().begin());
+        BOOST_CHECK_EQUAL(ts.getValue(mapped.length() - 1), mapped.getValue(mapped.length() - 1));
+
+        std::remove(binFileName.c_str());
+    }
+
+    BOOST_AUTO_TEST_CASE(binaryDataSet_converter)
+    {
+        const std::string binFileName = actualOutputRelativePath + "binaryDataSet_converter_test.wcds";
+        const std::string jsonFileName = actualOutputRelativePath + "binaryDataSet_converter_test.json";
+        Common::BinaryDataSetConverter::jsonToBinary(inputRelativePath + "readJSON_data_test.json", binFileName);
+        Common::BinaryDataSetConverter::binaryToJSON(binFileName, jsonFileName);
+
+        const Common::JSONStreamReaderDataSet reader;
+        BOOST_CHECK(reader.read(jsonFileName) == reader.read(inputRelativePath + "readJSON_data_test.json"));
+
+        std::ofstream(jsonFileName) << "not a binary data set";
+        BOOST_CHECK_THROW(Common::BinaryDataSetReader reader(jsonFileName), std::runtime_error);
+        BOOST_CHECK_THROW(Common::BinaryDataSetReader reader(actualOutputRelativePath + "missing_file.wcds"), std::runtime_error);
+
+        std::remove(binFileName.c_str());
+        std::remove(jsonFileName.c_str());
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(Tools)
@@ -130,6 +298,416 @@ BOOST_AUTO_TEST_SUITE(Tools)
         BOOST_CHECK_EQUAL(actual, expected);
     }
 
+    BOOST_AUTO_TEST_CASE(EvaluateStringExpression_compiled_brackets)
+    {
+        std::string expression = "(a + b) * (c - d) / (n ^ (a + 1))";
+        Common::AlgebraicOperatorsGrammar grammar;
+        Common::AlgebraicExpressionParser aep(expression, grammar);
+        BOOST_CHECK(!aep.isCompiled());
+
+        Common::AlgebraicExpressionContext ctx({{"a", 1}, {"b", 2}, {"c", 6}, {"d", 2}, {"n", 3}});
+        BOOST_CHECK_EQUAL(aep.evaluate(ctx), (1. + 2.) * (6. - 2.) / pow(3, 2));
+        BOOST_CHECK(aep.isCompiled());
+
+        ctx.setValue("c", 10);
+        BOOST_CHECK_EQUAL(aep.evaluate(ctx), (1. + 2.) * (10. - 2.) / pow(3, 2));
+
+        aep.setExpression("a - b");
+        BOOST_CHECK(!aep.isCompiled());
+        BOOST_CHECK_EQUAL(aep.evaluate(ctx), -1.);
+
+        aep.setExpression("a + b (c)");
+        BOOST_CHECK_THROW(aep.compile(), std::runtime_error);
+        aep.setExpression("a +");
+        BOOST_CHECK_THROW(aep.compile(), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(EvaluateStringExpression_arena)
+    {
+        // n terms give exactly 2n - 1 nodes, each appended once
+        std::string expression = "x0";
+        std::unordered_map<std::string, double> kvp = {{"x0", 0.}};
+        for (int i = 1; i < 500; ++i)
+        {
+            expression += (i % 2 ? " + x" : " * x") + std::to_string(i % 50);
+            kvp.emplace("x" + std::to_string(i % 50), 1. + i % 50);
+        }
+        Common::AlgebraicOperatorsGrammar grammar;
+        Common::AlgebraicExpressionParser aep(expression, grammar);
+        const std::shared_ptr<const Common::AlgebraicExpressionArena> arena = aep.getCompiled();
+        BOOST_CHECK_EQUAL(arena -> size(), 999);
+        BOOST_CHECK(arena -> getNode(arena -> getRoot()).opCode == Common::AlgebraicOpCode::Add);
+
+        // Copies share the compiled arena until they are given a new expression
+        Common::AlgebraicExpressionParser copy(aep);
+        BOOST_CHECK(copy.isCompiled());
+        BOOST_CHECK(copy.getCompiled() == arena);
+        const Common::AlgebraicExpressionContext ctx(kvp);
+        BOOST_CHECK_EQUAL(copy.evaluate(ctx), aep.evaluate(ctx));
+        BOOST_CHECK_EQUAL(aep.compileBytecode().getInstructions().size(), 999);
+
+        // Variables are stored once, in order of first appearance, and can be read from a slot array instead
+        BOOST_REQUIRE_EQUAL(arena -> getVariables().size(), 50);
+        std::vector<double> values;
+        for (const auto& it: arena -> getVariables())
+            values.push_back(kvp.at(it));
+        BOOST_CHECK_EQUAL(arena -> evaluate(values.data()), arena -> evaluate(ctx));
+
+        copy.setExpression("x1 - x2");
+        BOOST_CHECK(copy.getCompiled() != arena);
+        BOOST_CHECK_EQUAL(copy.evaluate(ctx), -1.);
+        BOOST_CHECK_EQUAL(aep.getCompiled() -> size(), 999);
+    }
+
+    BOOST_AUTO_TEST_CASE(AlgebraicLexer_tokens)
+    {
+        const std::string expression = "US_TSY_20Y*(1.5e-2 -x1)^ 2";
+        const Common::AlgebraicOperatorTable table{Common::AlgebraicOperatorsGrammar()};
+        std::vector<Common::AlgebraicToken> tokens;
+        Common::AlgebraicLexer::tokenize(expression, table, tokens);
+
+        const std::vector<Common::AlgebraicTokenKind> expectedKinds = {
+                Common::AlgebraicTokenKind::Identifier, Common::AlgebraicTokenKind::Operator,
+                Common::AlgebraicTokenKind::LeftBracket, Common::AlgebraicTokenKind::Number,
+                Common::AlgebraicTokenKind::Operator, Common::AlgebraicTokenKind::Identifier,
+                Common::AlgebraicTokenKind::RightBracket, Common::AlgebraicTokenKind::Operator,
+                Common::AlgebraicTokenKind::Number};
+        BOOST_REQUIRE_EQUAL(tokens.size(), expectedKinds.size());
+        for (std::size_t i = 0; i < tokens.size(); ++i)
+            BOOST_CHECK(tokens[i].kind == expectedKinds[i]);
+
+        BOOST_CHECK_EQUAL(tokens[0].str(expression), "US_TSY_20Y");
+        BOOST_CHECK(tokens[1].opCode == Common::AlgebraicOpCode::Multiply);
+        BOOST_CHECK_EQUAL(tokens[3].offset, 12);
+        BOOST_CHECK_EQUAL(tokens[3].value, 1.5e-2);
+        BOOST_CHECK(tokens[4].opCode == Common::AlgebraicOpCode::Substract);
+        BOOST_CHECK_EQUAL(tokens[5].str(expression), "x1");
+        BOOST_CHECK(tokens[7].opCode == Common::AlgebraicOpCode::Power);
+        BOOST_CHECK_EQUAL(tokens[8].value, 2.);
+
+        // A run starting with a digit that is not a full number stays an identifier
+        tokens.clear();
+        Common::AlgebraicLexer::tokenize("3M_RATE+1", table, tokens);
+        BOOST_REQUIRE_EQUAL(tokens.size(), 3);
+        BOOST_CHECK(tokens[0].kind == Common::AlgebraicTokenKind::Identifier);
+        BOOST_CHECK_EQUAL(tokens[0].length, 7);
+    }
+
+    // Default symbols, with + and - binding tighter than * and /, and ^ associating to the left
+    class InvertedOperatorsGrammar : public Common::OperatorsGrammar
+    {
+    public:
+        unsigned int priority(const std::string& symbol) const final
+        {
+            return symbol == "^" ? 3 : symbol == "+" or symbol == "-" ? 2 : 1;
+        }
+        unsigned int lowestPriority() const final { return 1; }
+        bool isLeftAssociative(const std::string& symbol) const final { return true; }
+        bool isRightAssociative(const std::string& symbol) const final { return false; }
+
+        bool isOperator(const std::string& symbol) const final { return m_default.isOperator(symbol); }
+        bool isFunction(const std::string& symbol) const final { return m_default.isFunction(symbol); }
+        bool isLeftBracket(const std::string& symbol) const final { return m_default.isLeftBracket(symbol); }
+        bool isRightBracket(const std::string& symbol) const final { return m_default.isRightBracket(symbol); }
+
+        std::string getCharOperators() const final { return m_default.getCharOperators(); }
+        std::unique_ptr<Common::OperatorsGrammar> clone() const final { return std::make_unique<InvertedOperatorsGrammar>(); }
+
+    private:
+        Common::AlgebraicOperatorsGrammar m_default;
+    };
+
+    BOOST_AUTO_TEST_CASE(AlgebraicExpressionParser_customGrammar)
+    {
+        const Common::AlgebraicOperatorsGrammar grammar;
+        const InvertedOperatorsGrammar inverted;
+        const Common::AlgebraicExpressionContext ctx({{"a", 2.}, {"b", 3.}, {"c", 4.}});
+
+        BOOST_CHECK_EQUAL(Common::AlgebraicExpressionParser("a * b + c", grammar).evaluate(ctx), 10.);
+        BOOST_CHECK_EQUAL(Common::AlgebraicExpressionParser("a * b + c", inverted).evaluate(ctx), 14.);
+        BOOST_CHECK_EQUAL(Common::AlgebraicExpressionParser("a ^ b ^ 2", grammar).evaluate(ctx), 512.);
+        BOOST_CHECK_EQUAL(Common::AlgebraicExpressionParser("a ^ b ^ 2", inverted).evaluate(ctx), 64.);
+
+        // Setting a grammar on a parser already holding an expression parses it again under the new rules
+        Common::AlgebraicExpressionParser aep("max(a, b) * b - c", grammar);
+        BOOST_CHECK_EQUAL(aep.evaluate(ctx), 5.);
+        aep.setOperatorGrammar(inverted);
+        BOOST_CHECK(!aep.isCompiled());
+        BOOST_CHECK_EQUAL(aep.evaluate(ctx), -3.);
+    }
+
+    BOOST_AUTO_TEST_CASE(EvaluateBytecode_happyPath)
+    {
+        Common::AlgebraicOperatorsGrammar grammar;
+        Common::AlgebraicExpressionParser aep("b * (a - 2.5) ^ n / (a + b) - b", grammar);
+        const Common::AlgebraicBytecode code = aep.compileBytecode();
+
+        const std::vector<std::string> expectedVariables = {"b", "a", "n"};
+        BOOST_TEST(code.getVariables() == expectedVariables, tt::per_element());
+        BOOST_CHECK_EQUAL(code.getSlot("n"), 2);
+        BOOST_CHECK_EQUAL(code.getInstructions().size(), 13);
+
+        const std::vector<double> slots = {2, 4.5, 3};
+        const Common::AlgebraicExpressionContext ctx({{"a", 4.5}, {"b", 2}, {"n", 3}});
+        BOOST_CHECK_EQUAL(code.evaluate(slots), aep.evaluate(ctx));
+        BOOST_CHECK_THROW(code.evaluate(std::vector<double>(2)), std::out_of_range);
+
+        // Column evaluation over several blocks matches row by row evaluation
+        const std::size_t length = 2 * Common::AlgebraicBytecode::columnBlockSize() + 3;
+        std::vector<double> b(length), a(length), n(length, 2.), out(length);
+        for (std::size_t i = 0; i < length; ++i)
+            b[i] = 0.5 * i - 7., a[i] = 1. + 0.01 * i;
+        const double* columns[] = {b.data(), a.data(), n.data()};
+        code.evaluateColumns(columns, length, out.data());
+        for (std::size_t i = 0; i < length; i += 37)
+            BOOST_CHECK_EQUAL(out[i], code.evaluate(std::vector<double>{b[i], a[i], n[i]}));
+
+        Common::AlgebraicBytecode unbalanced;
+        unbalanced.pushConstant(1.);
+        BOOST_CHECK_THROW(unbalanced.emit(Common::AlgebraicOpCode::Add), std::runtime_error);
+        unbalanced.pushConstant(2.);
+        BOOST_CHECK_THROW(unbalanced.evaluate(nullptr), std::runtime_error);
+        unbalanced.emit(Common::AlgebraicOpCode::Divide);
+        BOOST_CHECK_EQUAL(unbalanced.evaluate(nullptr), 0.5);
+    }
+
+    BOOST_AUTO_TEST_CASE(EvaluateFunctions_happyPath)
+    {
+        Common::AlgebraicOperatorsGrammar grammar;
+        BOOST_CHECK(grammar.isFunction("lag"));
+        BOOST_CHECK(!grammar.isFunction("lagged"));
+
+        Common::AlgebraicExpressionParser aep("max(abs(a - b), log(exp(c))) * min(a, 2) + log (b)", grammar);
+        const std::vector<std::string> expectedVariables = {"a", "b", "c", "a", "b"};
+        BOOST_TEST(aep.getExpressionVariables() == expectedVariables, tt::per_element());
+        const Common::AlgebraicExpressionContext ctx({{"a", 1.5}, {"b", 4.}, {"c", 2.}});
+        BOOST_TEST(aep.evaluate(ctx) == std::max(2.5, 2.) * 1.5 + std::log(4.), tt::tolerance(1e-14));
+
+        const std::vector<double> slots = {1.5, 4., 2.};
+        BOOST_TEST(aep.compileBytecode().evaluate(slots) == aep.evaluate(ctx), tt::tolerance(1e-14));
+        const Common::AlgebraicExpressionContext nan({{"a", std::nan("")}, {"b", 1.}});
+        BOOST_CHECK(std::isnan(Common::AlgebraicExpressionParser("min(b, a)", grammar).evaluate(nan)));
+
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("lag(a)", grammar).compile(), std::runtime_error);
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("lag(a, 1.5)", grammar).compile(), std::runtime_error);
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("ma(a, 0)", grammar).compile(), std::runtime_error);
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("min(a, b, c)", grammar).compile(), std::runtime_error);
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("foo(a)", grammar).compile(), std::runtime_error);
+        BOOST_CHECK_THROW(Common::AlgebraicExpressionParser("log(a", grammar).compile(), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(EvaluateFunctions_columns)
+    {
+        // Lagged operands are views of their column: rows reaching before the start are NaN
+        Common::AlgebraicOperatorsGrammar grammar;
+        Common::AlgebraicExpressionParser aep("diff(log(x)) + lag(x, 2) * y - ma(lag(x, 1) + y, 3)", grammar);
+        const Common::AlgebraicBytecode code = aep.compileBytecode();
+        BOOST_CHECK(code.hasHistory());
+        const std::vector<double> slots = {1., 2.};
+        BOOST_CHECK_THROW(code.evaluate(slots), std::runtime_error);
+        BOOST_CHECK_THROW(aep.evaluate(Common::AlgebraicExpressionContext({{"x", 1.}, {"y", 2.}})), std::runtime_error);
+
+        const std::size_t length = 600;
+        std::vector<double> x(length), y(length), out(length);
+        for (std::size_t i = 0; i < length; ++i)
+            x[i] = 1. + i, y[i] = 0.5 * (i % 7);
+        const double* columns[] = {x.data(), y.data()};
+        code.evaluateColumns(columns, length, out.data());
+
+        for (std::size_t i = 0; i < 3; ++i)
+            BOOST_CHECK(std::isnan(out[i]));
+        for (std::size_t i = 3; i < length; ++i)
+        {
+            const double ma = (x[i - 3] + y[i - 2] + x[i - 2] + y[i - 1] + x[i - 1] + y[i]) / 3.;
+            BOOST_TEST(out[i] == std::log(x[i]) - std::log(x[i - 1]) + x[i - 2] * y[i] - ma, tt::tolerance(1e-12));
+        }
+
+        Common::AlgebraicFormulaSet formulas(grammar);
+        BOOST_CHECK_THROW(formulas.addFormula("LAGGED", "lag(x, 1)"), std::runtime_error);
+    }
+
+    BOOST_AUTO_TEST_CASE(AlgebraicFormulaSet_optimisation)
+    {
+        Common::AlgebraicOperatorsGrammar grammar;
+        const std::vector<std::string> expressions = {"(a + b) / c", "(b + a) * 2 ^ 3 - c ^ 2", "a * 1 + 0 + (4 - 2) ^ 0.5",
+                                                      "c ^ 0.5 + c ^ 1 / 1 - 0", "(a + b) / c + b ^ 0"};
+        Common::AlgebraicFormulaSet formulas(grammar);
+        for (std::size_t i = 0; i < expressions.size(); ++i)
+            formulas.addFormula("F" + std::to_string(i), expressions[i]);
+
+        // Operators left: a+b, (a+b)/c, (a+b)*8, c*c, (a+b)*8-c*c, a+0, a+0+sqrt(2), c^0.5, c^0.5+c, (a+b)/c+1
+        BOOST_CHECK_EQUAL(formulas.getFormulaCount(), 5);
+        BOOST_CHECK_EQUAL(formulas.getNodeCount(), 21);
+        formulas.addFormula("F5", "2 ^ 3 * (b + a) - c * c");
+        BOOST_CHECK_EQUAL(formulas.getNodeCount(), 21);
+
+        const std::vector<double> slots = {1.5, 2., 3.};
+        const Common::AlgebraicExpressionContext ctx({{"a", 1.5}, {"b", 2.}, {"c", 3.}});
+        const std::vector<double> actual = formulas.evaluate(slots);
+        BOOST_CHECK_EQUAL(actual[5], actual[1]);
+        for (std::size_t i = 0; i < expressions.size(); ++i)
+            BOOST_TEST(actual[i] == Common::AlgebraicExpressionParser(expressions[i], grammar).evaluate(ctx), tt::tolerance(1e-14));
+
+        // x + 0 and x ^ 0.5 are kept, they differ from x and sqrt(x) for x = -0 and x = -inf
+        Common::AlgebraicFormulaSet signedZero(grammar);
+        signedZero.addFormula("PLUS_ZERO", "x + 0");
+        signedZero.addFormula("ROOT", "x ^ 0.5");
+        const std::vector<double> zero = signedZero.evaluate(std::vector<double>{-0.});
+        BOOST_CHECK(!std::signbit(zero[0]) and !std::signbit(zero[1]));
+        BOOST_CHECK_EQUAL(signedZero.evaluate(std::vector<double>{-INFINITY})[1], INFINITY);
+
+        const Common::DataSet ds = Common::JSONStreamReaderDataSet().read(inputRelativePath + "sample_dataSet_clean.json");
+        Common::AlgebraicFormulaSet series(grammar);
+        series.addFormula("SPREAD", "US_TSY_20Y - US_TBILL_3M");
+        series.addFormula("SPREAD_SQ", "(US_TSY_20Y - US_TBILL_3M) ^ 2");
+        const std::vector<Common::TimeSeries> result = series.evaluateSeries(ds);
+        BOOST_CHECK_EQUAL(result.size(), 2);
+        BOOST_CHECK_EQUAL(result[1].getName(), "SPREAD_SQ");
+        for (std::size_t i = 0; i < result[0].length(); ++i)
+            if (!std::isnan(result[0].getValue(i)))
+                BOOST_CHECK_EQUAL(result[1].getValue(i), result[0].getValue(i) * result[0].getValue(i));
+
+        // Inputs are aligned on the dates they all have, as for a single formula
+        const Common::TimeSeries single = Common::FormulaVariableAlgebraic("US_TSY_20Y - US_TBILL_3M", grammar).evaluateSeries(ds, "SPREAD");
+        BOOST_REQUIRE(*result[0].getCalendar() == *single.getCalendar());
+        for (std::size_t i = 0; i < single.length(); ++i)
+            BOOST_CHECK(result[0].getValue(i) == single.getValue(i) or (std::isnan(result[0].getValue(i)) and std::isnan(single.getValue(i))));
+
+        // Formulas reading inputs with different histories are each aligned on their own inputs only. The third
+        // formula reads the root of the first, whose rows must survive until both are copied out.
+        const std::vector<std::string> coverageExpressions = {"US_TSY_10Y - US_TBILL_3M", "(US_TSY_10Y - US_TBILL_3M) * US_TSY_20Y",
+                                                              "exp(0 - abs(US_TSY_10Y - US_TBILL_3M)) / (US_TBILL_3M + 1) + log(US_TSY_10Y * 2)"};
+        Common::AlgebraicFormulaSet coverage(grammar);
+        for (std::size_t f = 0; f < coverageExpressions.size(); ++f)
+            coverage.addFormula("F" + std::to_string(f), coverageExpressions[f]);
+        const std::vector<Common::TimeSeries> covered = coverage.evaluateSeries(ds);
+        BOOST_REQUIRE_EQUAL(covered.size(), coverageExpressions.size());
+        for (std::size_t f = 0; f < covered.size(); ++f)
+        {
+            const Common::TimeSeries alone = Common::FormulaVariableAlgebraic(coverageExpressions[f], grammar).evaluateSeries(ds, covered[f].getName());
+            BOOST_REQUIRE(*covered[f].getCalendar() == *alone.getCalendar());
+            for (std::size_t i = 0; i < alone.length(); ++i)
+                BOOST_CHECK(covered[f].getValue(i) == alone.getValue(i) or (std::isnan(covered[f].getValue(i)) and std::isnan(alone.getValue(i))));
+        }
+        BOOST_CHECK_EQUAL(covered[0].length(), ds.getTimeSeriesRef("US_TBILL_3M").length());
+        BOOST_CHECK(covered[1].length() < covered[0].length());
+    }
+
+    BOOST_AUTO_TEST_CASE(AlgebraicNativeCatalogue_fallback)
+    {
+        Common::AlgebraicOperatorsGrammar grammar;
+        const Common::DataSet ds = Common::JSONStreamReaderDataSet().read(inputRelativePath + "sample_dataSet_clean.json");
+        const std::string cacheDirectory = actualOutputRelativePath + "native_cache";
+        const std::vector<std::string> expressions = {"US_TSY_20Y - US_TBILL_3M", "(US_TSY_20Y / 2 + 1) ^ 2 - max(US_TBILL_3M, 1) * 3",
+                                                      "diff(US_TSY_20Y)", "US_TSY_10Y * 2 - US_TBILL_3M"};
+
+        Common::AlgebraicNativeCatalogue native(cacheDirectory), interpreted(cacheDirectory, "no_such_compiler");
+        for (std::size_t i = 0; i < expressions.size(); ++i)
+        {
+            native.addFormula("F" + std::to_string(i), expressions[i], grammar);
+            interpreted.addFormula("F" + std::to_string(i), expressions[i], grammar);
+        }
+        BOOST_CHECK(native.generateSource().find("extern \"C\" void wildcat_formula_1(") != std::string::npos);
+        BOOST_CHECK(native.getLibraryPath() != interpreted.getLibraryPath());
+
+        // Without a compiler the catalogue runs on the interpreter, with the same results, NaN included. When a
+        // compiler is installed the native build must succeed.
+        BOOST_CHECK(!interpreted.build());
+        BOOST_CHECK(!interpreted.isNative());
+        const bool hasCompiler = std::system("c++ --version > /dev/null 2>&1") == 0;
+        if (hasCompiler)
+        {
+            BOOST_REQUIRE(native.build());
+            BOOST_REQUIRE(native.isNative());
+        }
+        const std::vector<Common::TimeSeries> expected = interpreted.evaluateSeries(ds), actual = native.evaluateSeries(ds);
+        BOOST_REQUIRE_EQUAL(actual.size(), 4);
+        BOOST_CHECK(actual[3].length() > actual[0].length());
+        for (std::size_t f = 0; f < actual.size(); ++f)
+        {
+            // Each formula is aligned on its own inputs only
+            const Common::TimeSeries alone = Common::FormulaVariableAlgebraic(expressions[f], grammar).evaluateSeries(ds, actual[f].getName());
+            BOOST_CHECK(*actual[f].getCalendar() == *alone.getCalendar());
+            BOOST_CHECK_EQUAL(actual[f].getName(), "F" + std::to_string(f));
+            BOOST_REQUIRE_EQUAL(actual[f].length(), expected[f].length());
+            for (std::size_t i = 0; i < actual[f].length(); ++i)
+            {
+                BOOST_CHECK_EQUAL(std::isnan(actual[f].getValue(i)), std::isnan(expected[f].getValue(i)));
+                if (!std::isnan(expected[f].getValue(i)))
+                    BOOST_TEST(actual[f].getValue(i) == expected[f].getValue(i), tt::tolerance(1e-14));
+            }
+        }
+
+        // A second catalogue with the same formulas loads the cached object, unless the object can be written by
+        // others or its stored key no longer matches: then it is rebuilt in place
+        const std::string library = native.getLibraryPath(), key = library.substr(0, library.size() - 3) + ".key";
+        if (hasCompiler)
+        {
+            Common::AlgebraicNativeCatalogue cached(cacheDirectory);
+            for (std::size_t i = 0; i < expressions.size(); ++i)
+                cached.addFormula("F" + std::to_string(i), expressions[i], grammar);
+            BOOST_CHECK_EQUAL(cached.getLibraryPath(), library);
+            BOOST_CHECK(cached.build());
+
+            struct stat info;
+            ::chmod(library.c_str(), 0666);
+            Common::AlgebraicNativeCatalogue shared(cacheDirectory);
+            for (std::size_t i = 0; i < expressions.size(); ++i)
+                shared.addFormula("F" + std::to_string(i), expressions[i], grammar);
+            BOOST_CHECK(shared.build());
+            BOOST_REQUIRE_EQUAL(::stat(library.c_str(), &info), 0);
+            BOOST_CHECK_EQUAL(info.st_mode & (S_IWGRP | S_IWOTH), 0);
+
+            std::ofstream(key, std::ios::out | std::ios::trunc) << "collision";
+            Common::AlgebraicNativeCatalogue collided(cacheDirectory);
+            for (std::size_t i = 0; i < expressions.size(); ++i)
+                collided.addFormula("F" + std::to_string(i), expressions[i], grammar);
+            BOOST_CHECK(collided.build());
+            std::ifstream stored(key);
+            const std::string text((std::istreambuf_iterator<char>(stored)), std::istreambuf_iterator<char>());
+            BOOST_CHECK_EQUAL(text.compare(0, native.generateSource().size(), native.generateSource()), 0);
+        }
+
+        std::remove(library.c_str());
+        std::remove(key.c_str());
+        std::remove(cacheDirectory.c_str());
+    }
+
+    BOOST_AUTO_TEST_CASE(WorkStealingPool_parallelFor)
+    {
+        Common::WorkStealingPool pool(4);
+        BOOST_CHECK_EQUAL(pool.getThreadCount(), 4);
+
+        // Uneven task costs, the first indices are the slow ones, and several jobs on the same pool
+        for (unsigned int job = 0; job < 3; ++job)
+        {
+            std::vector<int> hits(1000, 0);
+            pool.parallelFor(hits.size(), [&hits](std::size_t i)
+            {
+                if (i < 10)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                hits[i] += 1;
+            });
+            BOOST_CHECK(std::all_of(hits.begin(), hits.end(), [](int hit) { return hit == 1; }));
+        }
+
+        BOOST_CHECK_THROW(pool.parallelFor(100, [](std::size_t i)
+                          {
+                              if (i == 42)
+                                  throw std::runtime_error("task failed");
+                          }), std::runtime_error);
+
+        // A nested job on the same pool is refused, on another pool it runs
+        BOOST_CHECK_THROW(pool.parallelFor(4, [&pool](std::size_t) { pool.parallelFor(2, [](std::size_t) {}); }),
+                          std::runtime_error);
+        Common::WorkStealingPool inner(2);
+        std::atomic<int> nestedHits(0);
+        pool.parallelFor(4, [&inner, &nestedHits](std::size_t) { inner.parallelFor(3, [&nestedHits](std::size_t) { ++nestedHits; }); });
+        BOOST_CHECK_EQUAL(nestedHits.load(), 12);
+
+        pool.parallelFor(0, [](std::size_t) { throw std::runtime_error("never called"); });
+    }
+
     BOOST_AUTO_TEST_CASE(EvaluateStringExpression_invalid)
     {
         std::string expression = "*a + b * + c / d ^ n + 2.5";